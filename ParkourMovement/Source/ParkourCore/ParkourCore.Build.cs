@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// The parkour rules, target math, probe decisions and transition table, with no engine, world or actor behind them.
+// CoreUObject is only here for the reflected mode enum, nothing in the module is a UObject.
+public class ParkourCore : ModuleRules
+{
+	public ParkourCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject" });
+	}
+}
@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourTransitions.h"
+
+/************************************************************/
+/*------------------------ Guards --------------------------*/
+/************************************************************/
+
+namespace ParkourGuards
+{
+	constexpr bool IsGrounded(const FParkourTransitionContext& Context)
+	{
+		return !Context.bIsFalling;
+	}
+}
+
+/************************************************************/
+/*------------------------ Table ---------------------------*/
+/************************************************************/
+
+const FParkourTransition FParkourTransitionTable::Transitions[NumParkourModes][FParkourTransitionTable::NumTriggers] =
+{
+	// None
+	{
+		/* Jump */	{ EParkourMovement::None, &ParkourGuards::IsGrounded, [](IParkourTransitionTarget& C) { C.OpenGates(); }, TEXT("OpenGates") },
+		/* Land */	{},
+		/* Fall */	{},
+		/* Cancel */{},
+		/* Crouch */{ EParkourMovement::Crouch, nullptr, [](IParkourTransitionTarget& C) { C.CrouchStart(); }, TEXT("CrouchStart") }
+	},
+	// LeftWallRun
+	{
+		/* Jump */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.WallRunJump(); }, TEXT("WallRunJump") },
+		/* Land */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.WallRunEnd(0); }, TEXT("WallRunEnd(0)") },
+		/* Fall */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.WallRunEnd(0); }, TEXT("WallRunEnd(0)") },
+		/* Cancel */{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.WallRunEnd(0.5); }, TEXT("WallRunEnd(0.5)") },
+		/* Crouch */{}
+	},
+	// RightWallRun
+	{
+		/* Jump */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.WallRunJump(); }, TEXT("WallRunJump") },
+		/* Land */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.WallRunEnd(0); }, TEXT("WallRunEnd(0)") },
+		/* Fall */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.WallRunEnd(0); }, TEXT("WallRunEnd(0)") },
+		/* Cancel */{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.WallRunEnd(0.5); }, TEXT("WallRunEnd(0.5)") },
+		/* Crouch */{}
+	},
+	// VerticalWallRun
+	{
+		/* Jump */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.LedgeGrabJump(); }, TEXT("LedgeGrabJump") },
+		/* Land */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.VerticalWallRunEnd(0); }, TEXT("VerticalWallRunEnd(0)") },
+		/* Fall */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.VerticalWallRunEnd(0); }, TEXT("VerticalWallRunEnd(0)") },
+		/* Cancel */{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.VerticalWallRunEnd(0.5); }, TEXT("VerticalWallRunEnd(0.5)") },
+		/* Crouch */{}
+	},
+	// LedgeGrab
+	{
+		/* Jump */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.LedgeGrabJump(); }, TEXT("LedgeGrabJump") },
+		/* Land */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.VerticalWallRunEnd(0); }, TEXT("VerticalWallRunEnd(0)") },
+		/* Fall */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.VerticalWallRunEnd(0); }, TEXT("VerticalWallRunEnd(0)") },
+		/* Cancel */{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.VerticalWallRunEnd(0.5); }, TEXT("VerticalWallRunEnd(0.5)") },
+		/* Crouch */{}
+	},
+	// Mantle
+	{
+		/* Jump */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.LedgeGrabJump(); }, TEXT("LedgeGrabJump") },
+		/* Land */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.VerticalWallRunEnd(0); }, TEXT("VerticalWallRunEnd(0)") },
+		/* Fall */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.VerticalWallRunEnd(0); }, TEXT("VerticalWallRunEnd(0)") },
+		/* Cancel */{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.VerticalWallRunEnd(0.5); }, TEXT("VerticalWallRunEnd(0.5)") },
+		/* Crouch */{}
+	},
+	// Slide
+	{
+		/* Jump */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.SlideJump(); }, TEXT("SlideJump") },
+		/* Land */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.SlideEnd(false); }, TEXT("SlideEnd(false)") },
+		/* Fall */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.SlideEnd(false); }, TEXT("SlideEnd(false)") },
+		/* Cancel */{},
+		/* Crouch */{}
+	},
+	// Crouch
+	{
+		/* Jump */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.CrouchJump(); }, TEXT("CrouchJump") },
+		/* Land */	{},
+		/* Fall */	{},
+		/* Cancel */{},
+		/* Crouch */{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.CrouchEnd(); }, TEXT("CrouchEnd") }
+	},
+	// Sprint
+	{
+		/* Jump */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.SprintJump(); }, TEXT("SprintJump") },
+		/* Land */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.SprintEnd(); }, TEXT("SprintEnd") },
+		/* Fall */	{ EParkourMovement::None, nullptr, [](IParkourTransitionTarget& C) { C.SprintJump(); }, TEXT("SprintJump") },
+		/* Cancel */{},
+		/* Crouch */{}
+	}
+};
+
+const FParkourModeActions FParkourTransitionTable::ModeActions[NumParkourModes] =
+{
+	// None
+	{ nullptr, [](IParkourTransitionTarget& C) { C.ResetMovement(); } },
+	// LeftWallRun
+	{ [](IParkourTransitionTarget& C) { C.WallRunExit(); }, [](IParkourTransitionTarget& C) { C.ResetMovement(); } },
+	// RightWallRun
+	{ [](IParkourTransitionTarget& C) { C.WallRunExit(); }, [](IParkourTransitionTarget& C) { C.ResetMovement(); } },
+	// VerticalWallRun
+	{ nullptr, [](IParkourTransitionTarget& C) { C.ResetMovement(); } },
+	// LedgeGrab
+	{ nullptr, [](IParkourTransitionTarget& C) { C.ResetMovement(); C.LedgeGrabEnter(); } },
+	// Mantle
+	{ nullptr, [](IParkourTransitionTarget& C) { C.ResetMovement(); } },
+	// Slide
+	{ nullptr, [](IParkourTransitionTarget& C) { C.ResetMovement(); } },
+	// Crouch
+	{ nullptr, [](IParkourTransitionTarget& C) { C.ResetMovement(); } },
+	// Sprint
+	{ nullptr, [](IParkourTransitionTarget& C) { C.ResetMovement(); C.SprintEnter(); } }
+};
+
+/************************************************************/
+/*------------------------ Fire ----------------------------*/
+/************************************************************/
+
+bool FParkourTransitionTable::Fire(IParkourTransitionTarget& Target, EParkourTrigger Trigger, const FParkourTransitionContext& Context)
+{
+	const FParkourTransition& Transition = Find(Context.Mode, Trigger);
+	if (!Transition.Action || (Transition.Guard && !Transition.Guard(Context))) {
+		return false;
+	}
+
+	Transition.Action(Target);
+	return true;
+}
+
+/************************************************************/
+/*------------------------ Debug ---------------------------*/
+/************************************************************/
+
+const TCHAR* FParkourTransitionTable::GetTriggerName(EParkourTrigger Trigger)
+{
+	switch (Trigger) {
+	case EParkourTrigger::Jump: return TEXT("Jump");
+	case EParkourTrigger::Land: return TEXT("Land");
+	case EParkourTrigger::Fall: return TEXT("Fall");
+	case EParkourTrigger::Cancel: return TEXT("Cancel");
+	case EParkourTrigger::Crouch: return TEXT("Crouch");
+	default: return TEXT("Unknown");
+	}
+}
+
+void FParkourTransitionTable::DumpTable(FOutputDevice& Ar)
+{
+	const UEnum* ModeEnum = StaticEnum<EParkourMovement>();
+
+	Ar.Logf(TEXT("Parkour transition table:"));
+	for (int32 From = 0; From < NumParkourModes; ++From) {
+		for (int32 Trigger = 0; Trigger < NumTriggers; ++Trigger) {
+			const FParkourTransition& Transition = Transitions[From][Trigger];
+			if (Transition.Action) {
+				Ar.Logf(TEXT("  %-16s %-7s -> %-16s %-24s%s"), *ModeEnum->GetNameStringByValue(From), GetTriggerName((EParkourTrigger)Trigger),
+					*ModeEnum->GetNameStringByValue((int64)Transition.To), Transition.Name, Transition.Guard ? TEXT(" (guarded)") : TEXT(""));
+			}
+		}
+	}
+}
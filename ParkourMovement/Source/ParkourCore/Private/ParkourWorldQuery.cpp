@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourWorldQuery.h"
+#include "ParkourRules.h"
+
+bool ParkourCore::FindWallRunWall(IParkourWorldQuery& World, const FParkourProbeOrigin& Origin, float Direction, FParkourQueryHit& OutHit)
+{
+	const bool bRight = (Direction < 0);
+	const EParkourProbe Probe = bRight ? EParkourProbe::WallRunRight : EParkourProbe::WallRunLeft;
+	const FVector End = bRight ? ParkourRules::WallRunEndRight(Origin.Location, Origin.Right, Origin.Forward) : ParkourRules::WallRunEndLeft(Origin.Location, Origin.Right, Origin.Forward);
+
+	return World.Trace(Probe, Origin.Location, End, OutHit) && ParkourRules::IsValidWallRunNormal(OutHit.Normal);
+}
+
+bool ParkourCore::FindClimbWall(IParkourWorldQuery& World, const FParkourProbeOrigin& Origin, FParkourQueryHit& OutHit)
+{
+	const FVector Feet = ParkourRules::MantleVectorFeet(Origin.Location, Origin.CapsuleHalfHeight, Origin.MantleHeight, Origin.Forward);
+
+	FParkourQueryHit Hit;
+	if (World.Trace(EParkourProbe::LedgeWall, Feet, Feet + (Origin.Forward * 50), Hit) && (Hit.Normal.Z >= -0.1)) {
+		OutHit = Hit;
+		return true;
+	}
+	return false;
+}
+
+bool ParkourCore::FindLedge(IParkourWorldQuery& World, const FParkourProbeOrigin& Origin, FParkourLedge& OutLedge)
+{
+	const FVector Eyes = ParkourRules::MantleVectorEyes(Origin.Eyes, Origin.Forward);
+	const FVector Feet = ParkourRules::MantleVectorFeet(Origin.Location, Origin.CapsuleHalfHeight, Origin.MantleHeight, Origin.Forward);
+
+	FParkourQueryHit FloorHit;
+	if (!World.Trace(EParkourProbe::LedgeFloor, Eyes, Feet, FloorHit)) {
+		return false;
+	}
+
+	// The floor trace is kept even without a ledge, the quick mantle reads how far down it went
+	OutLedge.bFoundFloor = true;
+	OutLedge.FloorLocation = FloorHit.ImpactPoint;
+	OutLedge.TraceDistance = FloorHit.Distance;
+
+	FParkourQueryHit WallHit;
+	if (!FindClimbWall(World, Origin, WallHit) || !FloorHit.bWalkable) {
+		return false;
+	}
+
+	OutLedge.WallLocation = WallHit.ImpactPoint;
+	OutLedge.WallNormal = WallHit.ImpactNormal;
+	return true;
+}
+
+bool ParkourCore::IsLedgeCloseToGround(IParkourWorldQuery& World, const FParkourProbeOrigin& Origin)
+{
+	FParkourQueryHit Hit;
+	return World.Trace(EParkourProbe::LedgeGround, Origin.Location, Origin.Location - (Origin.Up * ParkourRules::LedgeGroundDistance(Origin.CapsuleHalfHeight)), Hit);
+}
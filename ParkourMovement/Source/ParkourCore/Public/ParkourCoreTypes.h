@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParkourCoreTypes.generated.h"
+
+UENUM(BlueprintType)
+enum class EParkourMovement : uint8 {
+	None = 0 UMETA(DisplayName = "None"),
+	LeftWallRun = 1 UMETA(DisplayName = "LeftWallRun"),
+	RightWallRun = 2 UMETA(DisplayName = "RightWallRun"),
+	VerticalWallRun = 3 UMETA(DisplayName = "VerticalWallRun"),
+	LedgeGrab = 4 UMETA(DisplayName = "LedgeGrab"),
+	Mantle = 5 UMETA(DisplayName = "Mantle"),
+	Slide = 6 UMETA(DisplayName = "Slide"),
+	Crouch = 7 UMETA(DisplayName = "Crouch"),
+	Sprint = 8 UMETA(DisplayName = "Sprint")
+};
+
+static constexpr int32 NumParkourModes = (int32)EParkourMovement::Sprint + 1;
+
+/* Scene Queries */
+// Every trace the parkour update makes has its own slot, so async results can be matched back to the probe that asked for them.
+enum class EParkourProbe : uint8 {
+	WallRunRight,
+	WallRunLeft,
+	LedgeFloor,
+	LedgeWall,
+	LedgeGround,
+	SlideFloor,
+	Count
+};
+
+/* Gates */
+// Which parts of the update sequence run. Kept as a bit mask so predicted moves can save and restore all of them at once.
+enum class EParkourGate : uint8 {
+	None = 0,
+	WallRun = 1 << 0,
+	VerticalWallRun = 1 << 1,
+	MantleCheck = 1 << 2,
+	Mantle = 1 << 3,
+	Slide = 1 << 4,
+	Sprint = 1 << 5
+};
+ENUM_CLASS_FLAGS(EParkourGate);
+
+static constexpr int32 NumParkourGates = 6;
+static constexpr uint8 AllParkourGates = (1 << NumParkourGates) - 1;
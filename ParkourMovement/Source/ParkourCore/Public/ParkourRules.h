@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParkourCoreTypes.h"
+
+/* Rules */
+// The movement predicates and probe vectors every parkour transition is decided by.
+namespace ParkourRules
+{
+	constexpr bool IsWallRunning(EParkourMovement Mode)
+	{
+		return (Mode == EParkourMovement::LeftWallRun) || (Mode == EParkourMovement::RightWallRun);
+	}
+
+	// Vertical wall run, ledge grab and mantle all end through VerticalWallRunEnd
+	constexpr bool IsOnWall(EParkourMovement Mode)
+	{
+		return (Mode == EParkourMovement::VerticalWallRun) || (Mode == EParkourMovement::LedgeGrab) || (Mode == EParkourMovement::Mantle);
+	}
+
+	constexpr bool CanWallRun(float ForwardInput, EParkourMovement Mode)
+	{
+		return (ForwardInput > 0) && ((Mode == EParkourMovement::None) || IsWallRunning(Mode));
+	}
+
+	constexpr bool CanVerticalWallRun(float ForwardInput, EParkourMovement Mode, bool bIsFalling)
+	{
+		return (ForwardInput > 0) && bIsFalling && ((Mode == EParkourMovement::None) || (Mode == EParkourMovement::VerticalWallRun) || IsWallRunning(Mode));
+	}
+
+	constexpr bool CanMantle(float ForwardInput, EParkourMovement Mode, bool bQuickMantle)
+	{
+		return (ForwardInput > 0) && ((Mode == EParkourMovement::LedgeGrab) || bQuickMantle);
+	}
+
+	constexpr bool IsQuickMantle(float MantleTraceDistance, float MantleHeight, bool bLedgeCloseToGround)
+	{
+		return (MantleTraceDistance > MantleHeight) || bLedgeCloseToGround;
+	}
+
+	constexpr bool CanSlide(float ForwardInput, EParkourMovement Mode, bool bSprintQueued)
+	{
+		return (ForwardInput > 0) && ((Mode == EParkourMovement::Sprint) || bSprintQueued);
+	}
+
+	constexpr bool CanSprint(bool bIsWalking, EParkourMovement Mode)
+	{
+		return bIsWalking && (Mode == EParkourMovement::None);
+	}
+
+	FORCEINLINE bool IsValidWallRunNormal(const FVector& Normal)
+	{
+		return (Normal.Z < 0.52) && (Normal.Z > -0.52);
+	}
+
+	FORCEINLINE float ForwardInput(const FVector& ForwardVector, const FVector& InputVector)
+	{
+		return FVector::DotProduct(ForwardVector, InputVector);
+	}
+
+	FORCEINLINE FVector WallRunEndRight(const FVector& Location, const FVector& RightVector, const FVector& ForwardVector)
+	{
+		return Location + (RightVector * 75.f) + (ForwardVector * -35.f);
+	}
+
+	FORCEINLINE FVector WallRunEndLeft(const FVector& Location, const FVector& RightVector, const FVector& ForwardVector)
+	{
+		return Location + (RightVector * -75.f) + (ForwardVector * -35.f);
+	}
+
+	FORCEINLINE FVector MantleVectorEyes(const FVector& EyesLocation, const FVector& ForwardVector)
+	{
+		return (EyesLocation + FVector(0, 0, 50)) + (ForwardVector * 50);
+	}
+
+	FORCEINLINE FVector MantleVectorFeet(const FVector& Location, float CapsuleHalfHeight, float MantleHeight, const FVector& ForwardVector)
+	{
+		return (Location - FVector(0, 0, (CapsuleHalfHeight - MantleHeight))) + (ForwardVector * 50);
+	}
+
+	/* Targets */
+	// Where the character is held while running along a wall, a capsule radius off the wall
+	FORCEINLINE FVector WallRunTargetLocation(const FVector& WallLocation, const FVector& WallNormal, float CapsuleRadius)
+	{
+		return WallLocation + (WallNormal * CapsuleRadius);
+	}
+
+	// Yaw that runs along the wall, with the wall on the character's left or right
+	FORCEINLINE float WallRunTargetYaw(const FVector& WallNormal, bool bLeftWallRun)
+	{
+		return WallNormal.Rotation().Yaw - (bLeftWallRun ? 90.0f : -90.0f);
+	}
+
+	// Yaw that faces into the wall, for vertical wall runs, ledge grabs and mantles
+	FORCEINLINE float FacingWallYaw(const FVector& WallNormal)
+	{
+		return WallNormal.Rotation().Yaw - 180.0f;
+	}
+
+	// Hanging from a ledge, a capsule radius off the wall with the top of the capsule at the ledge
+	FORCEINLINE FVector LedgeTargetLocation(const FVector& WallLocation, const FVector& WallNormal, const FVector& LedgeFloorLocation, float CapsuleRadius, float CapsuleHalfHeight)
+	{
+		const FVector OffWall = WallLocation + (WallNormal * CapsuleRadius);
+		return FVector(OffWall.X, OffWall.Y, LedgeFloorLocation.Z - CapsuleHalfHeight);
+	}
+
+	// Height above the ledge the mantle ends at, standing on it
+	constexpr float MantleZOffset(float CapsuleHalfHeight)
+	{
+		return CapsuleHalfHeight;
+	}
+
+	// How far under the character the ground can be for a ledge to count as close to it
+	constexpr float LedgeGroundDistance(float CapsuleHalfHeight)
+	{
+		return CapsuleHalfHeight + 40.f;
+	}
+
+	// Launch along the wall, Direction is -1 for a wall on the right and 1 for a wall on the left
+	FORCEINLINE FVector WallRunLaunchVelocity(const FVector& WallNormal, float Speed, float Direction)
+	{
+		return FVector::CrossProduct(WallNormal, FVector::UpVector) * (Speed * Direction);
+	}
+
+	// Launch up a wall, pressing into it
+	FORCEINLINE FVector VerticalWallRunLaunchVelocity(const FVector& WallNormal, float Speed)
+	{
+		return FVector(WallNormal.X * -600.0f, WallNormal.Y * -600.0f, Speed);
+	}
+
+	// Downhill along the floor, across the character's right
+	FORCEINLINE FVector SlideVector(const FVector& FloorNormal, const FVector& RightVector)
+	{
+		return -FVector::CrossProduct(FloorNormal, RightVector);
+	}
+
+	/* Gates */
+	// Opened when the character leaves the ground
+	constexpr EParkourGate AirborneGates = EParkourGate::WallRun | EParkourGate::VerticalWallRun | EParkourGate::Slide | EParkourGate::Sprint;
+
+	constexpr uint8 OpenGates(uint8 GateMask, EParkourGate Gates)
+	{
+		return GateMask | (uint8)Gates;
+	}
+
+	// A mantle only runs off a vertical wall run, so closing that gate closes the mantle's too
+	constexpr uint8 CloseGates(uint8 GateMask, EParkourGate Gates)
+	{
+		return GateMask & ~((uint8)Gates | (EnumHasAnyFlags(Gates, EParkourGate::VerticalWallRun) ? (uint8)EParkourGate::Mantle : 0));
+	}
+
+	constexpr bool IsGateOpen(uint8 GateMask, EParkourGate Gate)
+	{
+		return (GateMask & (uint8)Gate) != 0;
+	}
+}
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParkourCoreTypes.h"
+
+/* Transitions */
+// Everything outside the update sequence that can move a runner between parkour modes.
+enum class EParkourTrigger : uint8 {
+	Jump,	// Jump pressed
+	Land,	// Landed, ends whatever was running
+	Fall,	// Walked off a ledge or jumped, walking to falling
+	Cancel,	// Crouch pressed while on a wall
+	Crouch,	// Crouch toggled
+	Count
+};
+
+// The plain data a guard is evaluated against
+struct FParkourTransitionContext
+{
+	EParkourMovement Mode = EParkourMovement::None;
+	bool bIsFalling = false;
+};
+
+/**
+ * Whatever the table's actions run on: UParkourMovementComponent through FParkourComponentTransitionTarget, a crowd
+ * runner, or a test's mock. Each action is one of the component's handlers and means the same on every target.
+ */
+class IParkourTransitionTarget
+{
+public:
+	virtual ~IParkourTransitionTarget() = default;
+
+	/* Trigger Actions */
+	virtual void OpenGates() = 0;
+	virtual void CrouchStart() = 0;
+	virtual void CrouchEnd() = 0;
+	virtual void WallRunJump() = 0;
+	virtual void WallRunEnd(float ResetTime) = 0;
+	virtual void VerticalWallRunEnd(float ResetTime) = 0;
+	virtual void LedgeGrabJump() = 0;
+	virtual void SlideJump() = 0;
+	virtual void SlideEnd(bool bIsCrouched) = 0;
+	virtual void CrouchJump() = 0;
+	virtual void SprintJump() = 0;
+	virtual void SprintEnd() = 0;
+
+	/* Mode Actions */
+	virtual void ResetMovement() = 0;
+	virtual void WallRunExit() = 0;
+	virtual void LedgeGrabEnter() = 0;
+	virtual void SprintEnter() = 0;
+};
+
+typedef bool (*FParkourTransitionGuard)(const FParkourTransitionContext& Context);
+typedef void (*FParkourTransitionAction)(IParkourTransitionTarget& Target);
+
+// One cell of the mode x trigger table. A cell without an action means the trigger does nothing in that mode.
+struct FParkourTransition
+{
+	// Where the action normally leaves the runner, for the debug dump
+	EParkourMovement To = EParkourMovement::None;
+	FParkourTransitionGuard Guard = nullptr;
+	FParkourTransitionAction Action = nullptr;
+	const TCHAR* Name = nullptr;
+};
+
+// Run on the mode being left and the mode being entered, by whatever changes the target's mode
+struct FParkourModeActions
+{
+	FParkourTransitionAction OnExit = nullptr;
+	FParkourTransitionAction OnEnter = nullptr;
+};
+
+/**
+ * The parkour transition table, indexed by current mode and trigger, and the entry and exit actions of every mode.
+ * A trigger is a single lookup: no delegate, and no handler that has to check whether it applies to the current mode.
+ */
+struct PARKOURCORE_API FParkourTransitionTable
+{
+	static constexpr int32 NumTriggers = (int32)EParkourTrigger::Count;
+
+	static const FParkourTransition Transitions[NumParkourModes][NumTriggers];
+	static const FParkourModeActions ModeActions[NumParkourModes];
+
+	static FORCEINLINE const FParkourTransition& Find(EParkourMovement Mode, EParkourTrigger Trigger)
+	{
+		return Transitions[(uint8)Mode][(uint8)Trigger];
+	}
+
+	// Runs the trigger's action for the context's mode if it has one and its guard passes, true if it ran
+	static bool Fire(IParkourTransitionTarget& Target, EParkourTrigger Trigger, const FParkourTransitionContext& Context);
+
+	static FORCEINLINE void RunExit(IParkourTransitionTarget& Target, EParkourMovement Mode)
+	{
+		if (const FParkourTransitionAction OnExit = ModeActions[(uint8)Mode].OnExit) {
+			OnExit(Target);
+		}
+	}
+
+	static FORCEINLINE void RunEnter(IParkourTransitionTarget& Target, EParkourMovement Mode)
+	{
+		if (const FParkourTransitionAction OnEnter = ModeActions[(uint8)Mode].OnEnter) {
+			OnEnter(Target);
+		}
+	}
+
+	static const TCHAR* GetTriggerName(EParkourTrigger Trigger);
+
+	// Logs every table row
+	static void DumpTable(FOutputDevice& Ar);
+};
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParkourCoreTypes.h"
+
+/* World Queries */
+// What a probe found, in the terms the rules use.
+struct FParkourQueryHit
+{
+	// Where the shape stopped, and where it touched
+	FVector Location = FVector::ZeroVector;
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	FVector Normal = FVector::ZeroVector;
+	FVector ImpactNormal = FVector::ZeroVector;
+	float Distance = 0.0f;
+
+	bool bBlockingHit = false;
+
+	// Whether the character could stand on what was hit, by the walkable rules of whoever ran the query
+	bool bWalkable = false;
+};
+
+/**
+ * The only way the parkour core sees the world. Each probe has a fixed shape and channel, the implementation
+ * decides how the trace is run, sync, async or from the surface database, and returns false when it hit nothing.
+ */
+class IParkourWorldQuery
+{
+public:
+	virtual ~IParkourWorldQuery() = default;
+
+	virtual bool Trace(EParkourProbe Probe, const FVector& Start, const FVector& End, FParkourQueryHit& OutHit) = 0;
+};
+
+/* Probe Decisions */
+// A ledge the character can grab, found by FindLedge
+struct FParkourLedge
+{
+	FVector FloorLocation = FVector::ZeroVector;
+	FVector WallLocation = FVector::ZeroVector;
+	FVector WallNormal = FVector::ZeroVector;
+
+	// Length of the floor trace, how far under the eyes the ledge is
+	float TraceDistance = 0.0f;
+
+	// The floor trace hit, FloorLocation and TraceDistance are set even when there's no wall under it
+	bool bFoundFloor = false;
+};
+
+// Where the character is and faces, everything the probes are placed from
+struct FParkourProbeOrigin
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Eyes = FVector::ZeroVector;
+	FVector Forward = FVector::ForwardVector;
+	FVector Right = FVector::RightVector;
+	FVector Up = FVector::UpVector;
+	float CapsuleHalfHeight = 0.0f;
+	float MantleHeight = 0.0f;
+};
+
+namespace ParkourCore
+{
+	// The wall run side trace, Direction is -1 for the right and 1 for the left. True only if what was hit
+	// can be run along, OutHit.bBlockingHit says whether anything was.
+	PARKOURCORE_API bool FindWallRunWall(IParkourWorldQuery& World, const FParkourProbeOrigin& Origin, float Direction, FParkourQueryHit& OutHit);
+
+	// ForwardTracer, a wall in front of the feet to climb
+	PARKOURCORE_API bool FindClimbWall(IParkourWorldQuery& World, const FParkourProbeOrigin& Origin, FParkourQueryHit& OutHit);
+
+	// A walkable ledge in front of the eyes with a wall to climb under it
+	PARKOURCORE_API bool FindLedge(IParkourWorldQuery& World, const FParkourProbeOrigin& Origin, FParkourLedge& OutLedge);
+
+	// Whether the ground is close enough under a grabbed ledge to mantle straight onto it
+	PARKOURCORE_API bool IsLedgeCloseToGround(IParkourWorldQuery& World, const FParkourProbeOrigin& Origin);
+}
@@ -0,0 +1,14 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// Fuzz checks and microbenchmarks of the parkour core, run by the low level tests runner without an engine or world
+public class ParkourCoreTests : TestModuleRules
+{
+	public ParkourCoreTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "ParkourCore" });
+	}
+}
@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+// Builds ParkourCoreTests into a standalone test executable. Run it with no arguments for the fuzz checks,
+// or with "[perf]" for the microbenchmarks.
+public class ParkourCoreTestsTarget : TestTargetRules
+{
+	public ParkourCoreTestsTarget(TargetInfo Target) : base(Target)
+	{
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_1;
+
+		// The core only needs Core, and CoreUObject for its reflected mode enum
+		bCompileAgainstEngine = false;
+		bCompileAgainstCoreUObject = true;
+		bCompileAgainstApplication = false;
+	}
+}
@@ -0,0 +1,683 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourRules.h"
+#include "ParkourTransitions.h"
+#include "ParkourWorldQuery.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "TestHarness.h"
+
+// Enough to catch a broken invariant without slowing every test run, the same seed each run so failures repeat
+static constexpr int32 ParkourTestIterations = 100000;
+static constexpr int32 ParkourTestSeed = 1;
+
+/************************************************************/
+/*---------------------- Box World -------------------------*/
+/************************************************************/
+
+namespace
+{
+	// Axis aligned boxes standing in for level collision. Every probe is traced as its center line, which is
+	// all the rules need to be exercised without a physics scene.
+	class FParkourBoxWorldQuery : public IParkourWorldQuery
+	{
+	public:
+		TArray<FBox, TInlineAllocator<8>> Boxes;
+		uint64 NumTraces = 0;
+
+		virtual bool Trace(EParkourProbe Probe, const FVector& Start, const FVector& End, FParkourQueryHit& OutHit) override
+		{
+			++NumTraces;
+			OutHit = FParkourQueryHit();
+
+			const FVector Delta = End - Start;
+			float BestTime = 2.0f;
+			FVector BestNormal = FVector::ZeroVector;
+
+			for (const FBox& Box : Boxes) {
+				float Entry = 0.0f;
+				float Exit = 1.0f;
+				FVector Normal = FVector::ZeroVector;
+				bool bMisses = false;
+
+				for (int32 Axis = 0; (Axis < 3) && !bMisses; ++Axis) {
+					if (FMath::IsNearlyZero(Delta[Axis])) {
+						bMisses = (Start[Axis] < Box.Min[Axis]) || (Start[Axis] > Box.Max[Axis]);
+						continue;
+					}
+
+					float Near = (Box.Min[Axis] - Start[Axis]) / Delta[Axis];
+					float Far = (Box.Max[Axis] - Start[Axis]) / Delta[Axis];
+					float Sign = -1.0f;
+					if (Near > Far) {
+						Swap(Near, Far);
+						Sign = 1.0f;
+					}
+
+					if (Near > Entry) {
+						Entry = Near;
+						Normal = FVector::ZeroVector;
+						Normal[Axis] = Sign;
+					}
+					Exit = FMath::Min(Exit, Far);
+					bMisses = (Entry > Exit);
+				}
+
+				// Starting inside a box isn't a hit, the same as a line trace
+				if (!bMisses && !Normal.IsZero() && (Entry < BestTime)) {
+					BestTime = Entry;
+					BestNormal = Normal;
+				}
+			}
+
+			if (BestTime > 1.0f) {
+				return false;
+			}
+
+			OutHit.bBlockingHit = true;
+			OutHit.Location = OutHit.ImpactPoint = Start + (Delta * BestTime);
+			OutHit.Normal = OutHit.ImpactNormal = BestNormal;
+			OutHit.Distance = Delta.Size() * BestTime;
+			OutHit.bWalkable = (BestNormal.Z >= 0.71f);
+			return true;
+		}
+	};
+
+	// A floor, and a wall of random height and distance on one side of a character facing a random way
+	void MakeRandomCourse(FRandomStream& Random, FParkourBoxWorldQuery& World, FParkourProbeOrigin& Origin)
+	{
+		World.Boxes.Reset();
+		World.Boxes.Add(FBox(FVector(-2000.0f, -2000.0f, -100.0f), FVector(2000.0f, 2000.0f, 0.0f)));
+
+		const float Height = Random.FRandRange(20.0f, 400.0f);
+		const float Distance = Random.FRandRange(10.0f, 150.0f);
+		switch (Random.RandHelper(4)) {
+		case 0: World.Boxes.Add(FBox(FVector(Distance, -500.0f, 0.0f), FVector(Distance + 200.0f, 500.0f, Height))); break;
+		case 1: World.Boxes.Add(FBox(FVector(-Distance - 200.0f, -500.0f, 0.0f), FVector(-Distance, 500.0f, Height))); break;
+		case 2: World.Boxes.Add(FBox(FVector(-500.0f, Distance, 0.0f), FVector(500.0f, Distance + 200.0f, Height))); break;
+		default: World.Boxes.Add(FBox(FVector(-500.0f, -Distance - 200.0f, 0.0f), FVector(500.0f, -Distance, Height))); break;
+		}
+
+		const FRotator Facing(0.0f, Random.FRandRange(-180.0f, 180.0f), 0.0f);
+		const FRotationMatrix Rotation(Facing);
+		Origin.CapsuleHalfHeight = 96.0f;
+		Origin.MantleHeight = 44.0f;
+		Origin.Location = FVector(0.0f, 0.0f, Origin.CapsuleHalfHeight + Random.FRandRange(0.0f, 250.0f));
+		Origin.Eyes = Origin.Location + FVector(0.0f, 0.0f, 64.0f);
+		Origin.Forward = Rotation.GetUnitAxis(EAxis::X);
+		Origin.Right = Rotation.GetUnitAxis(EAxis::Y);
+		Origin.Up = FVector::UpVector;
+	}
+}
+
+/************************************************************/
+/*------------------------ Runner --------------------------*/
+/************************************************************/
+
+namespace
+{
+	// The component's timers that the table's actions arm
+	enum class EParkourTestTimer : uint8 {
+		WallRunOpenGate,
+		WallRunEnableGravity,
+		VerticalRunEndGate,
+		CheckQueues,
+		OpenSprintGate,
+		Count
+	};
+
+	/**
+	 * The component's handlers cut down to their mode, gate and timer changes, run by the transition table against the
+	 * box world. The update and the presses go through the same table cells and core probes the component does.
+	 */
+	class FParkourTestRunner final : public IParkourTransitionTarget
+	{
+	public:
+		FParkourBoxWorldQuery World;
+		FParkourProbeOrigin Origin;
+
+		EParkourMovement Mode = EParkourMovement::None;
+		uint8 GateMask = 0;
+		float Timers[(uint8)EParkourTestTimer::Count] = {};
+		bool bFalling = false;
+		bool bSprintQueued = false;
+		bool bWallRunGravity = false;
+		float GravityScale = 1.0f;
+		float ForwardInput = 0.0f;
+		int32 NumTransitions = 0;
+
+		// Table cells that ran and left the runner somewhere other than the cell's To
+		int32 NumMissedTargets = 0;
+
+		/* Modes */
+		bool SetMode(EParkourMovement NewMode)
+		{
+			if (NewMode == Mode) {
+				return false;
+			}
+
+			FParkourTransitionTable::RunExit(*this, Mode);
+			Mode = NewMode;
+			FParkourTransitionTable::RunEnter(*this, NewMode);
+
+			++NumTransitions;
+			return true;
+		}
+
+		bool FireTrigger(EParkourTrigger Trigger)
+		{
+			FParkourTransitionContext Context;
+			Context.Mode = Mode;
+			Context.bIsFalling = bFalling;
+			if (!FParkourTransitionTable::Fire(*this, Trigger, Context)) {
+				return false;
+			}
+
+			NumMissedTargets += (Mode != FParkourTransitionTable::Find(Context.Mode, Trigger).To) ? 1 : 0;
+			return true;
+		}
+
+		virtual void ResetMovement() override
+		{
+			if ((Mode == EParkourMovement::None) || (Mode == EParkourMovement::Crouch)) {
+				GravityScale = 1.0f;
+			}
+		}
+
+		virtual void WallRunExit() override
+		{
+			ArmTimer(EParkourTestTimer::WallRunEnableGravity, 0.0f);
+			bWallRunGravity = false;
+		}
+
+		virtual void LedgeGrabEnter() override
+		{
+			GravityScale = 0.0f;
+		}
+
+		virtual void SprintEnter() override {}
+
+		/* Timers */
+		void ArmTimer(EParkourTestTimer Timer, float Delay)
+		{
+			Timers[(uint8)Timer] = FMath::Max(Delay, 0.0f);
+		}
+
+		void RunDueTimers(float DeltaTime)
+		{
+			for (uint8 Timer = 0; Timer < (uint8)EParkourTestTimer::Count; ++Timer) {
+				float& Remaining = Timers[Timer];
+				if (Remaining <= 0.0f) {
+					continue;
+				}
+
+				Remaining -= DeltaTime;
+				if (Remaining > 0.0f) {
+					continue;
+				}
+
+				Remaining = 0.0f;
+				switch ((EParkourTestTimer)Timer) {
+				case EParkourTestTimer::WallRunOpenGate: GateMask = ParkourRules::OpenGates(GateMask, EParkourGate::WallRun);
+					break;
+				case EParkourTestTimer::WallRunEnableGravity: bWallRunGravity = ParkourRules::IsWallRunning(Mode);
+					break;
+				case EParkourTestTimer::VerticalRunEndGate: GateMask = ParkourRules::OpenGates(GateMask, EParkourGate::VerticalWallRun);
+					break;
+				case EParkourTestTimer::CheckQueues: CheckQueues();
+					break;
+				case EParkourTestTimer::OpenSprintGate: GateMask = ParkourRules::OpenGates(GateMask, EParkourGate::Sprint);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		/* Presses */
+		void Jump()
+		{
+			const bool bWasGrounded = !bFalling && (Mode != EParkourMovement::Slide);
+			FireTrigger(EParkourTrigger::Jump);
+			if (bWasGrounded) {
+				Fall();
+			}
+		}
+
+		void CrouchSlide()
+		{
+			if (FireTrigger(EParkourTrigger::Cancel)) {
+				return;
+			}
+
+			if (ParkourRules::CanSlide(ForwardInput, Mode, bSprintQueued)) {
+				if (!bFalling && ParkourRules::IsGateOpen(GateMask, EParkourGate::Slide)) {
+					SprintEnd();
+					SetMode(EParkourMovement::Slide);
+					bSprintQueued = false;
+				}
+			}
+			else {
+				FireTrigger(EParkourTrigger::Crouch);
+			}
+		}
+
+		void Sprint()
+		{
+			SlideEnd(false);
+			CrouchEnd();
+			if (ParkourRules::CanSprint(!bFalling, Mode) && SetMode(EParkourMovement::Sprint)) {
+				bSprintQueued = false;
+			}
+			else {
+				bSprintQueued = true;
+			}
+		}
+
+		void CheckQueues()
+		{
+			if (bSprintQueued && ParkourRules::CanSprint(!bFalling, Mode)) {
+				SetMode(EParkourMovement::Sprint);
+				bSprintQueued = false;
+			}
+		}
+
+		/* Movement Changes */
+		void Fall()
+		{
+			if (!bFalling) {
+				bFalling = true;
+				FireTrigger(EParkourTrigger::Fall);
+				OpenGates();
+			}
+		}
+
+		void Land()
+		{
+			if (bFalling) {
+				bFalling = false;
+				FireTrigger(EParkourTrigger::Land);
+				GateMask = ParkourRules::CloseGates(GateMask, ParkourRules::AirborneGates);
+				CheckQueues();
+			}
+		}
+
+		/* Update */
+		// The update sequence's wall run and climb steps, off the core probes
+		void Update(float DeltaTime)
+		{
+			if (ParkourRules::IsGateOpen(GateMask, EParkourGate::WallRun)) {
+				FParkourQueryHit Hit;
+				if (!ParkourRules::CanWallRun(ForwardInput, Mode)) {
+					WallRunEnd(1.0f);
+				}
+				else if (bFalling && ParkourCore::FindWallRunWall(World, Origin, -1.0f, Hit)) {
+					WallRunStarted(EParkourMovement::RightWallRun);
+				}
+				else if (bFalling && (Mode != EParkourMovement::RightWallRun) && ParkourCore::FindWallRunWall(World, Origin, 1.0f, Hit)) {
+					WallRunStarted(EParkourMovement::LeftWallRun);
+				}
+				else {
+					WallRunEnd(0.5f);
+				}
+			}
+
+			if (ParkourRules::IsGateOpen(GateMask, EParkourGate::VerticalWallRun)) {
+				FParkourLedge Ledge;
+				FParkourQueryHit Hit;
+				if (!ParkourRules::CanVerticalWallRun(ForwardInput, Mode, bFalling)) {
+					VerticalWallRunEnd(0.35f);
+				}
+				else if (ParkourCore::FindLedge(World, Origin, Ledge)) {
+					GateMask = ParkourRules::CloseGates(GateMask, EParkourGate::VerticalWallRun);
+					SetMode(EParkourMovement::LedgeGrab);
+				}
+				else if (ParkourCore::FindClimbWall(World, Origin, Hit)) {
+					SetMode(EParkourMovement::VerticalWallRun);
+				}
+				else {
+					VerticalWallRunEnd(0.35f);
+				}
+			}
+
+			RunDueTimers(DeltaTime);
+		}
+
+		void WallRunStarted(EParkourMovement NewMode)
+		{
+			if (SetMode(NewMode)) {
+				ArmTimer(EParkourTestTimer::WallRunEnableGravity, 1.0f);
+			}
+		}
+
+		/* Trigger Actions */
+		virtual void OpenGates() override
+		{
+			GateMask = ParkourRules::OpenGates(GateMask, ParkourRules::AirborneGates);
+		}
+
+		virtual void CrouchStart() override
+		{
+			SetMode(EParkourMovement::Crouch);
+			bSprintQueued = false;
+		}
+
+		virtual void CrouchEnd() override
+		{
+			if (Mode == EParkourMovement::Crouch) {
+				SetMode(EParkourMovement::None);
+				bSprintQueued = false;
+			}
+		}
+
+		virtual void WallRunJump() override
+		{
+			WallRunEnd(0.35f);
+		}
+
+		virtual void WallRunEnd(float ResetTime) override
+		{
+			if (ParkourRules::IsWallRunning(Mode) && SetMode(EParkourMovement::None)) {
+				GateMask = ParkourRules::CloseGates(GateMask, EParkourGate::WallRun);
+				ArmTimer(EParkourTestTimer::WallRunOpenGate, ResetTime);
+			}
+		}
+
+		virtual void VerticalWallRunEnd(float ResetTime) override
+		{
+			if (ParkourRules::IsOnWall(Mode) && SetMode(EParkourMovement::None)) {
+				GateMask = ParkourRules::CloseGates(GateMask, EParkourGate::VerticalWallRun | EParkourGate::MantleCheck);
+				ArmTimer(EParkourTestTimer::VerticalRunEndGate, ResetTime);
+				ArmTimer(EParkourTestTimer::CheckQueues, 0.02f);
+			}
+		}
+
+		virtual void LedgeGrabJump() override
+		{
+			VerticalWallRunEnd(0.35f);
+		}
+
+		virtual void SlideJump() override
+		{
+			SlideEnd(false);
+		}
+
+		virtual void SlideEnd(bool bIsCrouched) override
+		{
+			if ((Mode == EParkourMovement::Slide) && SetMode(bIsCrouched ? EParkourMovement::Crouch : EParkourMovement::None)) {
+				GateMask = ParkourRules::CloseGates(GateMask, EParkourGate::Slide);
+			}
+		}
+
+		virtual void CrouchJump() override
+		{
+			CrouchEnd();
+		}
+
+		virtual void SprintJump() override
+		{
+			SprintEnd();
+			bSprintQueued = true;
+		}
+
+		virtual void SprintEnd() override
+		{
+			if ((Mode == EParkourMovement::Sprint) && SetMode(EParkourMovement::None)) {
+				GateMask = ParkourRules::CloseGates(GateMask, EParkourGate::Sprint);
+				ArmTimer(EParkourTestTimer::OpenSprintGate, 0.1f);
+			}
+		}
+	};
+
+	// What a runner can be in on the ground and in the air. Landing ends every wall mode, falling ends the grounded ones.
+	constexpr uint32 ModeBit(EParkourMovement Mode)
+	{
+		return 1u << (uint8)Mode;
+	}
+
+	constexpr uint32 GroundedModes = ModeBit(EParkourMovement::None) | ModeBit(EParkourMovement::Slide) | ModeBit(EParkourMovement::Crouch)
+		| ModeBit(EParkourMovement::Sprint);
+	constexpr uint32 AirborneModes = ModeBit(EParkourMovement::None) | ModeBit(EParkourMovement::LeftWallRun) | ModeBit(EParkourMovement::RightWallRun)
+		| ModeBit(EParkourMovement::VerticalWallRun) | ModeBit(EParkourMovement::LedgeGrab) | ModeBit(EParkourMovement::Crouch);
+
+	// The runner's inputs, one a step
+	enum class EParkourTestInput : uint8 {
+		Update,
+		Jump,
+		CrouchSlide,
+		Sprint,
+		Fall,
+		Land,
+		Count
+	};
+}
+
+/************************************************************/
+/*------------------------ Fuzz ----------------------------*/
+/************************************************************/
+
+// Random inputs, modes and courses through every rule, failing on results that break what the component relies on
+TEST_CASE("ParkourCore::Rules::Fuzz", "[ParkourCore]")
+{
+	FRandomStream Random(ParkourTestSeed);
+	FParkourBoxWorldQuery World;
+	int32 NumFailures = 0;
+
+	// Only the first few are reported, one broken rule usually breaks thousands of iterations
+	auto Fail = [&NumFailures](int32 Iteration, const char* Rule)
+	{
+		if (NumFailures++ < 16) {
+			FAIL_CHECK("Iteration " << Iteration << " broke " << Rule);
+		}
+	};
+
+	for (int32 Iteration = 0; Iteration < ParkourTestIterations; ++Iteration) {
+		const EParkourMovement Mode = (EParkourMovement)Random.RandHelper(NumParkourModes);
+		const bool bIsFalling = Random.RandHelper(2) != 0;
+		const float ForwardInput = ParkourRules::ForwardInput(Random.GetUnitVector(), Random.GetUnitVector());
+
+		// Nothing starts without forward input, and nothing but a wall run continues into one
+		if ((ParkourRules::CanWallRun(ForwardInput, Mode) || ParkourRules::CanVerticalWallRun(ForwardInput, Mode, bIsFalling)) && (ForwardInput <= 0)) {
+			Fail(Iteration, "no parkour without forward input");
+		}
+		if (ParkourRules::CanWallRun(ForwardInput, Mode) && ParkourRules::IsOnWall(Mode)) {
+			Fail(Iteration, "no wall run off a vertical wall run");
+		}
+
+		// Gates
+		const uint8 GateMask = (uint8)Random.RandHelper(AllParkourGates + 1);
+		if (ParkourRules::IsGateOpen(ParkourRules::CloseGates(GateMask, EParkourGate::VerticalWallRun), EParkourGate::Mantle)) {
+			Fail(Iteration, "closing the vertical wall run closes the mantle");
+		}
+		if (ParkourRules::OpenGates(GateMask, ParkourRules::AirborneGates) != (GateMask | (uint8)ParkourRules::AirborneGates)) {
+			Fail(Iteration, "opening gates leaves the rest alone");
+		}
+
+		// Probes against a random course
+		FParkourProbeOrigin Origin;
+		MakeRandomCourse(Random, World, Origin);
+
+		FParkourQueryHit WallHit;
+		for (const float Direction : { -1.0f, 1.0f }) {
+			if (ParkourCore::FindWallRunWall(World, Origin, Direction, WallHit)) {
+				if (!ParkourRules::IsValidWallRunNormal(WallHit.Normal)) {
+					Fail(Iteration, "wall runs need a wall");
+				}
+
+				const FVector Target = ParkourRules::WallRunTargetLocation(WallHit.ImpactPoint, WallHit.Normal, 42.0f);
+				if (!FMath::IsNearlyEqual(FVector::DotProduct(Target - WallHit.ImpactPoint, WallHit.Normal), 42.0f, 0.01f)) {
+					Fail(Iteration, "wall runs hold a capsule radius off the wall");
+				}
+			}
+		}
+
+		FParkourLedge Ledge;
+		if (ParkourCore::FindLedge(World, Origin, Ledge)) {
+			if ((Ledge.FloorLocation.Z > Origin.Eyes.Z + 50.0f) || (Ledge.FloorLocation.Z < Origin.Location.Z - Origin.CapsuleHalfHeight + Origin.MantleHeight)) {
+				Fail(Iteration, "ledges are between the feet and over the eyes");
+			}
+			if (Ledge.WallNormal.Z < -0.1) {
+				Fail(Iteration, "ledges aren't under overhangs");
+			}
+
+			const FVector Hang = ParkourRules::LedgeTargetLocation(Ledge.WallLocation, Ledge.WallNormal, Ledge.FloorLocation, 42.0f, Origin.CapsuleHalfHeight);
+			if (!FMath::IsNearlyEqual(Hang.Z + Origin.CapsuleHalfHeight, Ledge.FloorLocation.Z, 0.01f) || Hang.ContainsNaN()) {
+				Fail(Iteration, "hanging puts the top of the capsule at the ledge");
+			}
+		}
+	}
+
+	CHECK(NumFailures == 0);
+}
+
+// Random input sequences through the transition table on random courses, failing on a runner left in a state the
+// component can't be in
+TEST_CASE("ParkourCore::Transitions::Fuzz", "[ParkourCore]")
+{
+	constexpr int32 NumSequences = ParkourTestIterations / 100;
+	constexpr int32 SequenceLength = 200;
+	constexpr float DeltaTime = 1.0f / 60.0f;
+
+	FRandomStream Random(ParkourTestSeed);
+	int32 NumFailures = 0;
+	int32 NumTransitions = 0;
+
+	auto Fail = [&NumFailures](int32 Sequence, int32 Step, EParkourTestInput Input, const char* Rule)
+	{
+		if (NumFailures++ < 16) {
+			FAIL_CHECK("Sequence " << Sequence << " step " << Step << " input " << (int32)Input << " broke " << Rule);
+		}
+	};
+
+	for (int32 Sequence = 0; Sequence < NumSequences; ++Sequence) {
+		FParkourTestRunner Runner;
+		MakeRandomCourse(Random, Runner.World, Runner.Origin);
+
+		for (int32 Step = 0; Step < SequenceLength; ++Step) {
+			// Updates most steps, as a frame does, with the stick held forward more often than not
+			const EParkourTestInput Input = (Random.FRand() < 0.5f) ? EParkourTestInput::Update : (EParkourTestInput)Random.RandHelper((int32)EParkourTestInput::Count);
+			Runner.ForwardInput = (Random.FRand() < 0.75f) ? Random.FRandRange(0.1f, 1.0f) : Random.FRandRange(-1.0f, 0.0f);
+
+			switch (Input) {
+			case EParkourTestInput::Update: Runner.Update(DeltaTime);
+				break;
+			case EParkourTestInput::Jump: Runner.Jump();
+				break;
+			case EParkourTestInput::CrouchSlide: Runner.CrouchSlide();
+				break;
+			case EParkourTestInput::Sprint: Runner.Sprint();
+				break;
+			case EParkourTestInput::Fall: Runner.Fall();
+				break;
+			case EParkourTestInput::Land: Runner.Land();
+				break;
+			default:
+				break;
+			}
+
+			if ((uint8)Runner.Mode >= NumParkourModes) {
+				Fail(Sequence, Step, Input, "modes are in the enum");
+			}
+			else if (!((Runner.bFalling ? AirborneModes : GroundedModes) & ModeBit(Runner.Mode))) {
+				Fail(Sequence, Step, Input, Runner.bFalling ? "falling runners are airborne or crouched" : "grounded runners are off the wall");
+			}
+			if (Runner.GateMask & ~AllParkourGates) {
+				Fail(Sequence, Step, Input, "gates stay in their bits");
+			}
+			for (const float Remaining : Runner.Timers) {
+				if (!(Remaining >= 0.0f)) {
+					Fail(Sequence, Step, Input, "timers never go negative");
+					break;
+				}
+			}
+			if ((Runner.Mode == EParkourMovement::LedgeGrab) != (Runner.GravityScale == 0.0f)) {
+				Fail(Sequence, Step, Input, "only ledge grabs hang without gravity");
+			}
+			if (Runner.NumMissedTargets > 0) {
+				Fail(Sequence, Step, Input, "transitions end in their cell's mode");
+				Runner.NumMissedTargets = 0;
+			}
+		}
+
+		NumTransitions += Runner.NumTransitions;
+	}
+
+	// The sequences have to get somewhere for the checks to mean anything
+	CHECK(NumTransitions > NumSequences);
+	CHECK(NumFailures == 0);
+}
+
+/************************************************************/
+/*----------------------- Benchmark ------------------------*/
+/************************************************************/
+
+// Runs Body Iterations times, returns nanoseconds per run
+template<typename FunctionType>
+static double TimeParkourRule(int32 Iterations, FunctionType&& Body)
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration) {
+		Body(Iteration);
+	}
+	return FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1.0e6 / FMath::Max(Iterations, 1);
+}
+
+// Hidden from the default run, timings only mean something from a development or shipping build run on its own
+TEST_CASE("ParkourCore::Rules::Benchmark", "[ParkourCore][.][perf]")
+{
+	const int32 Iterations = ParkourTestIterations;
+	FRandomStream Random(ParkourTestSeed);
+
+	// Inputs are made up front so the timings are of the rules alone
+	const int32 NumInputs = 1024;
+	TArray<FVector> Vectors;
+	TArray<FParkourProbeOrigin> Origins;
+	TArray<FParkourBoxWorldQuery> Courses;
+	Origins.SetNum(NumInputs);
+	Courses.SetNum(NumInputs);
+	for (int32 Index = 0; Index < NumInputs; ++Index) {
+		Vectors.Add(Random.GetUnitVector());
+		MakeRandomCourse(Random, Courses[Index], Origins[Index]);
+	}
+
+	// What one component's predicate phase does each update
+	int32 Sink = 0;
+	const double PredicateNs = TimeParkourRule(Iterations, [&](int32 Iteration)
+	{
+		const EParkourMovement Mode = (EParkourMovement)(Iteration % NumParkourModes);
+		const float ForwardInput = ParkourRules::ForwardInput(Vectors[Iteration % NumInputs], Vectors[(Iteration + 1) % NumInputs]);
+		Sink += ParkourRules::CanWallRun(ForwardInput, Mode) + ParkourRules::CanVerticalWallRun(ForwardInput, Mode, (Iteration & 1) != 0)
+			+ ParkourRules::CanSlide(ForwardInput, Mode, (Iteration & 2) != 0) + ParkourRules::CanSprint((Iteration & 4) != 0, Mode);
+	});
+
+	// Table transitions with their actions, exit and entry: into a mode by SetMode, then out of it by a trigger
+	const EParkourTrigger Triggers[] = { EParkourTrigger::Jump, EParkourTrigger::Land, EParkourTrigger::Fall, EParkourTrigger::Cancel, EParkourTrigger::Crouch };
+	FParkourTestRunner Runner;
+	const double TransitionNs = TimeParkourRule(Iterations, [&](int32 Iteration)
+	{
+		Runner.bFalling = (Iteration & 1) != 0;
+		Runner.SetMode((EParkourMovement)(1 + (Iteration % (NumParkourModes - 1))));
+		Sink += Runner.FireTrigger(Triggers[Iteration % UE_ARRAY_COUNT(Triggers)]);
+		Runner.SetMode(EParkourMovement::None);
+	});
+	const double TransitionsPerIteration = (double)Runner.NumTransitions / Iterations;
+
+	// Both wall run sides and the ledge search, the probes a falling character runs every update
+	uint64 NumTraces = 0;
+	const double ProbeNs = TimeParkourRule(Iterations, [&](int32 Iteration)
+	{
+		FParkourBoxWorldQuery& World = Courses[Iteration % NumInputs];
+		const FParkourProbeOrigin& Origin = Origins[Iteration % NumInputs];
+		const uint64 StartTraces = World.NumTraces;
+
+		FParkourQueryHit Hit;
+		FParkourLedge Ledge;
+		Sink += ParkourCore::FindWallRunWall(World, Origin, -1.0f, Hit) + ParkourCore::FindWallRunWall(World, Origin, 1.0f, Hit) + ParkourCore::FindLedge(World, Origin, Ledge);
+		NumTraces += World.NumTraces - StartTraces;
+	});
+
+	WARN("Parkour core: " << Iterations << " iterations, " << PredicateNs << " ns per predicate update, " << TransitionNs << " ns per transition round trip ("
+		<< TransitionsPerIteration << " mode changes, " << TransitionNs / FMath::Max(TransitionsPerIteration, 1.0) << " ns each), "
+		<< ProbeNs << " ns per probe update (" << (double)NumTraces / Iterations << " traces), sink " << Sink << ".");
+}
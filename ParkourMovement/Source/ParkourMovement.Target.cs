@@ -10,6 +10,9 @@ public class ParkourMovementTarget : TargetRules
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_1;
+
+		// UParkourMovementComponent replicates its state through the push model
+		bWithPushModel = true;
 		ExtraModuleNames.Add("ParkourMovement");
 	}
 }
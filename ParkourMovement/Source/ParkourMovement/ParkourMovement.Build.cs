@@ -9,5 +9,22 @@ public class ParkourMovement : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "EnhancedInput" });
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Json", "NetCore" });
+
+		// Rules, target math, probe decisions and the transition table, see ParkourRules.h, ParkourWorldQuery.h and ParkourTransitions.h
+		PublicDependencyModuleNames.AddRange(new string[] { "ParkourCore" });
+
+		// Crowd runners, see ParkourMassProcessors.h
+		PublicDependencyModuleNames.AddRange(new string[] { "MassEntity", "StructUtils", "MassCommon", "MassMovement", "MassLOD", "MassSpawner", "MassActors" });
+
+		// Generated parkour nav links, see ParkourNavLinks.h
+		PublicDependencyModuleNames.AddRange(new string[] { "NavigationSystem", "AIModule" });
+
+		// Parkour replication graph, see ParkourReplicationGraph.h
+		PublicDependencyModuleNames.AddRange(new string[] { "ReplicationGraph" });
+
+		// Physics thread parkour forces, see ParkourAsyncForces.h
+		PublicDependencyModuleNames.AddRange(new string[] { "Chaos", "PhysicsCore" });
 	}
 }
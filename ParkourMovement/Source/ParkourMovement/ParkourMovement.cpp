@@ -3,5 +3,9 @@
 #include "ParkourMovement.h"
 #include "Modules/ModuleManager.h"
 
+CSV_DEFINE_CATEGORY_MODULE(PARKOURMOVEMENT_API, ParkourMovement, true);
+
+FParkourCounters GParkourCounters;
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ParkourMovement, "ParkourMovement" );
  
\ No newline at end of file
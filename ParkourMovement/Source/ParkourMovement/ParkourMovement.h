@@ -3,3 +3,24 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+// 'stat ParkourMovement' and the ParkourMovement CSV category. Neither is compiled into shipping builds.
+DECLARE_STATS_GROUP(TEXT("ParkourMovement"), STATGROUP_ParkourMovement, STATCAT_Advanced);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(PARKOURMOVEMENT_API, ParkourMovement);
+
+// Running totals kept whether or not stats are compiled in, read by the benchmark. Game thread only.
+struct FParkourCounters
+{
+	uint64 SceneQueries = 0;
+	uint64 ModeTransitions = 0;
+	uint64 UpdateCycles = 0;
+
+	// Steps that changed no mode, and the heap allocations made while they ran. Allocations by other threads during
+	// a step are counted too, so it's an upper bound. Only counted outside shipping.
+	uint64 SteadyUpdates = 0;
+	uint64 SteadyUpdateAllocations = 0;
+};
+
+extern PARKOURMOVEMENT_API FParkourCounters GParkourCounters;
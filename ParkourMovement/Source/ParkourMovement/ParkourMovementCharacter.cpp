@@ -9,12 +9,14 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
+#include "ParkourCharacterMovementComponent.h"
 
 
 //////////////////////////////////////////////////////////////////////////
 // AParkourMovementCharacter
 
-AParkourMovementCharacter::AParkourMovementCharacter()
+AParkourMovementCharacter::AParkourMovementCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UParkourCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
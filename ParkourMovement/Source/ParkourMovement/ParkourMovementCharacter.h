@@ -9,7 +9,7 @@
 
 
 UCLASS(config=Game)
-class AParkourMovementCharacter : public ACharacter
+class PARKOURMOVEMENT_API AParkourMovementCharacter : public ACharacter
 {
 	GENERATED_BODY()
 
@@ -38,7 +38,7 @@ class AParkourMovementCharacter : public ACharacter
 	class UInputAction* LookAction;
 
 public:
-	AParkourMovementCharacter();
+	AParkourMovementCharacter(const FObjectInitializer& ObjectInitializer);
 	
 
 protected:
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourAnimInstance.h"
+
+/************************************************************/
+/*------------------------ Proxy ---------------------------*/
+/************************************************************/
+
+void FParkourAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	const UParkourAnimInstance* ParkourInstance = CastChecked<UParkourAnimInstance>(InAnimInstance);
+	SnapshotBuffer = IsValid(ParkourInstance->ParkourComponent) ? &ParkourInstance->ParkourComponent->GetAnimSnapshot() : nullptr;
+}
+
+void FParkourAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	Super::Update(DeltaSeconds);
+
+	// Worker thread, the buffer hands back whichever snapshot was published last
+	Snapshot = SnapshotBuffer ? SnapshotBuffer->Read() : FParkourAnimSnapshot();
+}
+
+/************************************************************/
+/*--------------------- Anim Instance ----------------------*/
+/************************************************************/
+
+void UParkourAnimInstance::NativeInitializeAnimation()
+{
+	Super::NativeInitializeAnimation();
+
+	const AActor* Owner = GetOwningActor();
+	ParkourComponent = Owner ? Owner->FindComponentByClass<UParkourMovementComponent>() : nullptr;
+}
+
+void UParkourAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	// Runs after the proxy's Update
+	Parkour = GetProxyOnAnyThread<FParkourAnimInstanceProxy>().GetSnapshot();
+}
+
+FAnimInstanceProxy* UParkourAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FParkourAnimInstanceProxy(this);
+}
+
+void UParkourAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+	delete InProxy;
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourAsyncForces.h"
+
+/************************************************************/
+/*-------------------- Physics Thread ----------------------*/
+/************************************************************/
+
+void FParkourAsyncForceCallback::OnPreSimulate_Internal()
+{
+	const FParkourAsyncForceInput* Input = GetConsumerInput_Internal();
+	FParkourAsyncForceOutput& Output = GetProducerOutputData_Internal();
+	const float DeltaTime = (float)GetDeltaTime_Internal();
+
+	// Steps share an input until the game thread sends the next one, its impulses only go out with the first of them
+	if (Input && (Input->Sequence != LastSequence)) {
+		LastSequence = Input->Sequence;
+		AgentStates.Reset();
+
+		for (const FParkourAsyncForceAgentInput& Agent : Input->Agents) {
+			FAgentState& State = AgentStates.Add(Agent.AgentId);
+			State.Velocity = Agent.Velocity + Agent.Forces.Impulse;
+			State.Forces = Agent.Forces;
+			State.bImpulsePending = !Agent.Forces.Impulse.IsZero();
+		}
+	}
+
+	const float StickAlpha = 1.0f - FMath::Exp(-StickRate * DeltaTime);
+
+	for (TPair<int32, FAgentState>& Pair : AgentStates) {
+		FAgentState& State = Pair.Value;
+		FVector Delta = State.bImpulsePending ? State.Forces.Impulse : FVector::ZeroVector;
+		State.bImpulsePending = false;
+
+		if (State.Forces.bStick) {
+			FVector Gap = State.Forces.StickVelocity - State.Velocity;
+			if (!State.Forces.bStickZ) {
+				Gap.Z = 0.0;
+			}
+
+			const FVector StickDelta = Gap * StickAlpha;
+			State.Velocity += StickDelta;
+			Delta += StickDelta;
+		}
+
+		if (!Delta.IsNearlyZero()) {
+			FParkourAsyncForceAgentOutput& AgentOutput = Output.Agents.AddDefaulted_GetRef();
+			AgentOutput.AgentId = Pair.Key;
+			AgentOutput.VelocityDelta = Delta;
+		}
+	}
+}
@@ -0,0 +1,527 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourBenchmarkSubsystem.h"
+#include "ParkourMovementComponent.h"
+#include "ParkourCharacterMovementComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "ParkourMovement/ParkourMovement.h"
+#include "ParkourMovement/ParkourMovementCharacter.h"
+
+static FAutoConsoleCommandWithWorldAndArgs ParkourBenchmarkCommand(
+	TEXT("Parkour.Benchmark"),
+	TEXT("Parkour.Benchmark [AgentCounts=1,64,512,2048] [Frames=600] [Path=Component|Movement]. Runs the parkour course benchmark for each ")
+	TEXT("comma separated agent count on the component's update or stepped from the characters' moves, and writes the results to ")
+	TEXT("Saved/Profiling/ParkourBenchmark. Quits when done if -ParkourBenchmarkQuit is on the command line."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UParkourBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UParkourBenchmarkSubsystem>() : nullptr;
+		if (!Benchmark) {
+			UE_LOG(LogTemp, Warning, TEXT("Parkour Benchmark: Needs a game world."));
+			return;
+		}
+
+		TArray<FString> CountStrings;
+		(Args.Num() > 0 ? Args[0] : FString(TEXT("1,64,512,2048"))).ParseIntoArray(CountStrings, TEXT(","));
+
+		TArray<int32> AgentCounts;
+		for (const FString& CountString : CountStrings) {
+			const int32 Count = FCString::Atoi(*CountString);
+			if (Count > 0) {
+				AgentCounts.Add(Count);
+			}
+		}
+
+		EParkourBenchmarkPath Path = EParkourBenchmarkPath::Component;
+		if (Args.Num() > 2) {
+			if (Args[2].Equals(TEXT("Movement"), ESearchCase::IgnoreCase)) {
+				Path = EParkourBenchmarkPath::Movement;
+			}
+			else if (!Args[2].Equals(TEXT("Component"), ESearchCase::IgnoreCase)) {
+				UE_LOG(LogTemp, Warning, TEXT("Parkour Benchmark: Unknown path %s, expected Component or Movement."), *Args[2]);
+				return;
+			}
+		}
+
+		Benchmark->StartBenchmark(AgentCounts, (Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 600, Path);
+	}));
+
+// Course layout, in the lane's space. Lanes run along X and sit side by side along Y.
+namespace ParkourBenchmarkCourse
+{
+	const FVector Origin(0, 0, 5000);
+	constexpr float LaneWidth = 400.0f;
+	constexpr float LaneLength = 4000.0f;
+	constexpr float RowSpacing = 5000.0f;
+
+	// Script triggers along the lane
+	constexpr float SprintX = 100.0f;
+	constexpr float SlideX = 700.0f;
+	constexpr float WallRunJumpX = 1300.0f;
+	constexpr float ClimbJumpX = 3050.0f;
+	constexpr float FinishX = 3600.0f;
+
+	// A runner stuck on a stage this long starts the lane again
+	constexpr float StageTimeout = 10.0f;
+}
+
+/************************************************************/
+/*---------------------- Subsystem -------------------------*/
+/************************************************************/
+
+bool UParkourBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return (WorldType == EWorldType::Game) || (WorldType == EWorldType::PIE);
+}
+
+void UParkourBenchmarkSubsystem::Deinitialize()
+{
+	// The world is being torn down with everything the benchmark spawned in it
+	Agents.Reset();
+	CourseActors.Reset();
+	AgentCounts.Reset();
+	CurrentRun = INDEX_NONE;
+
+	Super::Deinitialize();
+}
+
+TStatId UParkourBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UParkourBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+/************************************************************/
+/*------------------------ Runs ----------------------------*/
+/************************************************************/
+
+void UParkourBenchmarkSubsystem::StartBenchmark(const TArray<int32>& InAgentCounts, int32 InNumFrames, EParkourBenchmarkPath InPath)
+{
+	StopBenchmark();
+
+	if (InAgentCounts.Num() == 0 || InNumFrames <= 0) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Benchmark: Nothing to run."));
+		return;
+	}
+
+	AgentCounts = InAgentCounts;
+	NumFrames = InNumFrames;
+	Results.Reset();
+	BaselineFailures.Reset();
+	MissingBaselines.Reset();
+	Path = InPath;
+	CurrentRun = 0;
+	BeginRun();
+}
+
+void UParkourBenchmarkSubsystem::StopBenchmark()
+{
+	DestroyCourse();
+	AgentCounts.Reset();
+	CurrentRun = INDEX_NONE;
+}
+
+void UParkourBenchmarkSubsystem::BeginRun()
+{
+	const int32 NumAgents = AgentCounts[CurrentRun];
+	UE_LOG(LogTemp, Display, TEXT("Parkour Benchmark: %d agents, %d frames, %s path."), NumAgents, NumFrames,
+		(Path == EParkourBenchmarkPath::Movement) ? TEXT("movement") : TEXT("component"));
+
+	for (int32 Row = 0; (Row * LanesPerRow) < NumAgents; ++Row) {
+		const FVector RowStart = ParkourBenchmarkCourse::Origin + FVector(Row * ParkourBenchmarkCourse::RowSpacing, 0, 0);
+		SpawnRow(RowStart, FMath::Min(LanesPerRow, NumAgents - (Row * LanesPerRow)));
+	}
+
+	FrameIndex = 0;
+	GameThreadMs.Reset(NumFrames);
+	ParkourMs.Reset(NumFrames);
+}
+
+void UParkourBenchmarkSubsystem::EndRun()
+{
+	const FParkourBenchmarkResult Result = MakeResult();
+
+	UE_LOG(LogTemp, Display, TEXT("Parkour Benchmark: %d agents, game thread %.2f ms (p99 %.2f), parkour %.3f ms (p99 %.3f), %.1f queries per frame, %.1f transitions per second."),
+		Result.NumAgents, Result.MeanGameThreadMs, Result.P99GameThreadMs, Result.MeanParkourMs, Result.P99ParkourMs, Result.QueriesPerFrame, Result.TransitionsPerSecond);
+
+	if (Result.SteadyAllocationsPerUpdate > 0.0) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Benchmark: %.3f heap allocations per update that changed no mode, expected none. Other threads allocating during an update are counted too."),
+			Result.SteadyAllocationsPerUpdate);
+	}
+
+	Results.Add(Result);
+	WriteResult(Result);
+	CompareWithBaseline(Result);
+	DestroyCourse();
+
+	if (AgentCounts.IsValidIndex(++CurrentRun)) {
+		BeginRun();
+		return;
+	}
+
+	StopBenchmark();
+	if (FParse::Param(FCommandLine::Get(), TEXT("ParkourBenchmarkQuit"))) {
+		FPlatformMisc::RequestExitWithStatus(false, (BaselineFailures.Num() > 0) ? 1 : 0);
+	}
+}
+
+void UParkourBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	if (!IsRunning()) {
+		return;
+	}
+
+	for (FParkourBenchmarkAgent& Agent : Agents) {
+		DriveAgent(Agent, DeltaTime);
+	}
+
+	// Tickables run after the world's actors, so the update cycles below are this frame's.
+	// GGameThreadTime is the last full frame's.
+	++FrameIndex;
+	if (FrameIndex == NumWarmUpFrames) {
+		StartSceneQueries = GParkourCounters.SceneQueries;
+		StartModeTransitions = GParkourCounters.ModeTransitions;
+		StartSteadyUpdates = GParkourCounters.SteadyUpdates;
+		StartSteadyUpdateAllocations = GParkourCounters.SteadyUpdateAllocations;
+		LastUpdateCycles = GParkourCounters.UpdateCycles;
+		MeasuredSeconds = 0.0;
+	}
+	else if (FrameIndex > NumWarmUpFrames) {
+		GameThreadMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+		ParkourMs.Add(FPlatformTime::ToMilliseconds64(GParkourCounters.UpdateCycles - LastUpdateCycles));
+		LastUpdateCycles = GParkourCounters.UpdateCycles;
+		MeasuredSeconds += DeltaTime;
+
+		if (GameThreadMs.Num() >= NumFrames) {
+			EndRun();
+		}
+	}
+}
+
+/************************************************************/
+/*------------------------ Course --------------------------*/
+/************************************************************/
+
+void UParkourBenchmarkSubsystem::SpawnRow(const FVector& RowStart, int32 NumLanes)
+{
+	using namespace ParkourBenchmarkCourse;
+
+	// One floor under the whole row
+	const float RowWidth = NumLanes * LaneWidth;
+	SpawnBlock(GetWorld(), RowStart + FVector(LaneLength * 0.5f, (RowWidth - LaneWidth) * 0.5f, -50), FVector(LaneLength + 400, RowWidth, 100), CourseActors);
+
+	for (int32 Lane = 0; Lane < NumLanes; ++Lane) {
+		const FVector LaneStart = RowStart + FVector(0, Lane * LaneWidth, 0);
+
+		SpawnLaneBlocks(GetWorld(), LaneStart, false, CourseActors);
+		SpawnAgent(LaneStart);
+	}
+}
+
+void UParkourBenchmarkSubsystem::SpawnLaneBlocks(UWorld* World, const FVector& LaneStart, bool bWithFloor, TArray<TObjectPtr<AActor>>& OutActors)
+{
+	using namespace ParkourBenchmarkCourse;
+
+	if (bWithFloor) {
+		SpawnBlock(World, LaneStart + FVector(LaneLength * 0.5f, 0, -50), FVector(LaneLength + 400, LaneWidth, 100), OutActors);
+	}
+
+	// Side wall on the runner's right for the wall run, and the block at the end to climb
+	SpawnBlock(World, LaneStart + FVector(2000, 80, 200), FVector(1200, 20, 400), OutActors);
+	SpawnBlock(World, LaneStart + FVector(3300, 0, 150), FVector(200, 300, 300), OutActors);
+}
+
+void UParkourBenchmarkSubsystem::SpawnBlock(UWorld* World, const FVector& Center, const FVector& Size, TArray<TObjectPtr<AActor>>& OutActors)
+{
+	static UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+	// The engine cube is 100 units on a side. Spawned deferred, so the mesh goes on before the static component registers.
+	const FTransform Transform(FRotator::ZeroRotator, Center, Size / 100.0f);
+	AStaticMeshActor* Block = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+	if (Block) {
+		Block->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+		Block->FinishSpawning(Transform);
+		OutActors.Add(Block);
+	}
+}
+
+void UParkourBenchmarkSubsystem::SpawnAgent(const FVector& LaneStart)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AParkourMovementCharacter* Character = GetWorld()->SpawnActor<AParkourMovementCharacter>(AParkourMovementCharacter::StaticClass(), LaneStart + FVector(0, 0, 100), FRotator::ZeroRotator, SpawnParams);
+	if (!Character) {
+		return;
+	}
+
+	// The mantle reads the controller's eyes
+	Character->SpawnDefaultController();
+
+	// AI in a standalone game is on the component's update unless told otherwise
+	UParkourCharacterMovementComponent* Movement = Cast<UParkourCharacterMovementComponent>(Character->GetCharacterMovement());
+	if (Path == EParkourBenchmarkPath::Movement) {
+		if (!Movement) {
+			UE_LOG(LogTemp, Warning, TEXT("Parkour Benchmark: The character has no parkour movement component, the movement path can't be measured."));
+		}
+		else {
+			Movement->bPredictParkour = true;
+			Movement->bUpdateAllCharacters = true;
+		}
+	}
+	else if (Movement) {
+		Movement->bUpdateAllCharacters = false;
+	}
+
+	UParkourMovementComponent* Parkour = NewObject<UParkourMovementComponent>(Character, TEXT("ParkourMovement"));
+	Parkour->RegisterComponent();
+	Parkour->Initialize(Character);
+
+	FParkourBenchmarkAgent& Agent = Agents.AddDefaulted_GetRef();
+	Agent.Character = Character;
+	Agent.Parkour = Parkour;
+	Agent.LaneStart = LaneStart;
+}
+
+void UParkourBenchmarkSubsystem::DestroyCourse()
+{
+	for (FParkourBenchmarkAgent& Agent : Agents) {
+		if (IsValid(Agent.Character)) {
+			if (AController* Controller = Agent.Character->GetController()) {
+				Controller->Destroy();
+			}
+			Agent.Character->Destroy();
+		}
+	}
+	Agents.Reset();
+
+	for (AActor* Actor : CourseActors) {
+		if (IsValid(Actor)) {
+			Actor->Destroy();
+		}
+	}
+	CourseActors.Reset();
+}
+
+/************************************************************/
+/*------------------------ Script --------------------------*/
+/************************************************************/
+
+void UParkourBenchmarkSubsystem::DriveAgent(FParkourBenchmarkAgent& Agent, float DeltaTime)
+{
+	using namespace ParkourBenchmarkCourse;
+
+	ACharacter* Character = Agent.Character;
+	UParkourMovementComponent* Parkour = Agent.Parkour;
+	if (!IsValid(Character) || !IsValid(Parkour) || Agent.bFinished) {
+		return;
+	}
+
+	Agent.StageTime += DeltaTime;
+	Character->AddMovementInput(FVector::ForwardVector, 1.0f);
+
+	// The character Blueprint normally raises Land, moves that run the update land it themselves
+	const bool bIsFalling = Character->GetCharacterMovement()->IsFalling();
+	if (Agent.bWasFalling && !bIsFalling && !Parkour->IsUpdatedByMovement()) {
+		Parkour->Land();
+	}
+	Agent.bWasFalling = bIsFalling;
+
+	const FVector Local = Character->GetActorLocation() - Agent.LaneStart;
+	const EParkourBenchmarkStage Stage = Agent.Stage;
+
+	switch (Stage) {
+	case EParkourBenchmarkStage::RunUp:
+		if (Local.X > SprintX) {
+			Parkour->Sprint();
+			Agent.Stage = EParkourBenchmarkStage::Slide;
+		}
+		break;
+	case EParkourBenchmarkStage::Slide:
+		if (Local.X > SlideX) {
+			Parkour->CrouchSlide();
+			Agent.Stage = EParkourBenchmarkStage::WallRun;
+		}
+		break;
+	case EParkourBenchmarkStage::WallRun:
+		// The slide ends crouched, stand up and sprint at the wall
+		if (Parkour->GetCurrentParkourMode() == EParkourMovement::Crouch) {
+			Parkour->CrouchSlide();
+			Parkour->Sprint();
+		}
+		else if ((Local.X > WallRunJumpX) && !bIsFalling) {
+			Character->Jump();
+			Parkour->Jump();
+			Agent.Stage = EParkourBenchmarkStage::Climb;
+		}
+		break;
+	case EParkourBenchmarkStage::Climb:
+		if ((Local.X > ClimbJumpX) && !bIsFalling) {
+			Character->Jump();
+			Parkour->Jump();
+			Agent.Stage = EParkourBenchmarkStage::Finish;
+		}
+		break;
+	case EParkourBenchmarkStage::Finish:
+		if (Local.X > FinishX) {
+			Agent.bFinished = !Agent.bRepeat;
+			if (Agent.bRepeat) {
+				RestartLane(Agent);
+			}
+		}
+		break;
+	}
+
+	if (Agent.Stage != Stage) {
+		Agent.StageTime = 0.0f;
+	}
+	else if ((Agent.StageTime > StageTimeout) || (Local.Z < -1000.0f)) {
+		Agent.bFinished = !Agent.bRepeat;
+		if (Agent.bRepeat) {
+			RestartLane(Agent);
+		}
+	}
+}
+
+void UParkourBenchmarkSubsystem::RestartLane(FParkourBenchmarkAgent& Agent)
+{
+	// Landing ends whatever mode the runner was in and closes its gates
+	Agent.Parkour->Land();
+
+	Agent.Character->SetActorLocationAndRotation(Agent.LaneStart + FVector(0, 0, 100), FRotator::ZeroRotator, false, nullptr, ETeleportType::TeleportPhysics);
+	Agent.Character->GetCharacterMovement()->StopMovementImmediately();
+
+	Agent.Stage = EParkourBenchmarkStage::RunUp;
+	Agent.StageTime = 0.0f;
+}
+
+/************************************************************/
+/*------------------------ Report --------------------------*/
+/************************************************************/
+
+static double Percentile(TArray<double> Samples, double Fraction)
+{
+	if (Samples.Num() == 0) {
+		return 0.0;
+	}
+
+	Samples.Sort();
+	const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Samples.Num()) - 1, 0, Samples.Num() - 1);
+	return Samples[Index];
+}
+
+static double Mean(const TArray<double>& Samples)
+{
+	double Sum = 0.0;
+	for (const double Sample : Samples) {
+		Sum += Sample;
+	}
+	return (Samples.Num() > 0) ? (Sum / Samples.Num()) : 0.0;
+}
+
+static TSharedRef<FJsonObject> ToJson(const FParkourBenchmarkResult& Result)
+{
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("agents"), Result.NumAgents);
+	Json->SetNumberField(TEXT("frames"), Result.NumFrames);
+	Json->SetNumberField(TEXT("game_thread_ms_mean"), Result.MeanGameThreadMs);
+	Json->SetNumberField(TEXT("game_thread_ms_p99"), Result.P99GameThreadMs);
+	Json->SetNumberField(TEXT("parkour_ms_mean"), Result.MeanParkourMs);
+	Json->SetNumberField(TEXT("parkour_ms_p99"), Result.P99ParkourMs);
+	Json->SetNumberField(TEXT("queries_per_frame"), Result.QueriesPerFrame);
+	Json->SetNumberField(TEXT("transitions_per_second"), Result.TransitionsPerSecond);
+	Json->SetNumberField(TEXT("steady_allocations_per_update"), Result.SteadyAllocationsPerUpdate);
+	return Json;
+}
+
+static FString GetResultFileName(const FParkourBenchmarkResult& Result)
+{
+	const TCHAR* PathName = (Result.Path == EParkourBenchmarkPath::Movement) ? TEXT("Movement_") : TEXT("");
+	return FString::Printf(TEXT("ParkourBenchmark_%s%d.json"), PathName, Result.NumAgents);
+}
+
+FParkourBenchmarkResult UParkourBenchmarkSubsystem::MakeResult() const
+{
+	FParkourBenchmarkResult Result;
+	Result.Path = Path;
+	Result.NumAgents = AgentCounts[CurrentRun];
+	Result.NumFrames = GameThreadMs.Num();
+	Result.MeanGameThreadMs = Mean(GameThreadMs);
+	Result.P99GameThreadMs = Percentile(GameThreadMs, 0.99);
+	Result.MeanParkourMs = Mean(ParkourMs);
+	Result.P99ParkourMs = Percentile(ParkourMs, 0.99);
+	Result.QueriesPerFrame = (Result.NumFrames > 0) ? (double)(GParkourCounters.SceneQueries - StartSceneQueries) / Result.NumFrames : 0.0;
+	Result.TransitionsPerSecond = (MeasuredSeconds > 0.0) ? (double)(GParkourCounters.ModeTransitions - StartModeTransitions) / MeasuredSeconds : 0.0;
+
+	const uint64 SteadyUpdates = GParkourCounters.SteadyUpdates - StartSteadyUpdates;
+	Result.SteadyAllocationsPerUpdate = (SteadyUpdates > 0) ? (double)(GParkourCounters.SteadyUpdateAllocations - StartSteadyUpdateAllocations) / SteadyUpdates : 0.0;
+	return Result;
+}
+
+void UParkourBenchmarkSubsystem::WriteResult(const FParkourBenchmarkResult& Result) const
+{
+	FString Output;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	FJsonSerializer::Serialize(ToJson(Result), Writer);
+
+	const FString Path = FPaths::ProfilingDir() / TEXT("ParkourBenchmark") / GetResultFileName(Result);
+	if (FFileHelper::SaveStringToFile(Output, *Path)) {
+		UE_LOG(LogTemp, Display, TEXT("Parkour Benchmark: Wrote %s."), *Path);
+	}
+	else {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Benchmark: Couldn't write %s."), *Path);
+	}
+}
+
+// The fields that cost something, a run fails when one of them grows past its baseline
+static bool IsCostField(const FString& Field)
+{
+	return Field.StartsWith(TEXT("game_thread_ms")) || Field.StartsWith(TEXT("parkour_ms")) || (Field == TEXT("queries_per_frame"))
+		|| (Field == TEXT("steady_allocations_per_update"));
+}
+
+void UParkourBenchmarkSubsystem::CompareWithBaseline(const FParkourBenchmarkResult& Result)
+{
+	// A baseline is a result file copied into the project's Benchmarks folder
+	const FString Path = FPaths::ProjectDir() / TEXT("Benchmarks") / GetResultFileName(Result);
+
+	FString Input;
+	TSharedPtr<FJsonObject> Baseline;
+	if (!FFileHelper::LoadFileToString(Input, *Path)) {
+		MissingBaselines.Add(Result.NumAgents);
+		return;
+	}
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Input), Baseline) || !Baseline.IsValid()) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Benchmark: Couldn't read baseline %s."), *Path);
+		MissingBaselines.Add(Result.NumAgents);
+		return;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Parkour Benchmark: Against baseline %s:"), *Path);
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : ToJson(Result)->Values) {
+		double BaselineValue = 0.0;
+		if (!Baseline->TryGetNumberField(Field.Key, BaselineValue)) {
+			continue;
+		}
+
+		const double Value = Field.Value->AsNumber();
+		const double Change = (BaselineValue != 0.0) ? ((Value - BaselineValue) * 100.0 / BaselineValue) : 0.0;
+
+		// A baseline of zero allows nothing, the steady allocations
+		const bool bFailed = IsCostField(Field.Key) && (Value > (BaselineValue * (1.0 + BaselineTolerance)));
+		UE_LOG(LogTemp, Display, TEXT("  %-30s %12.3f -> %12.3f (%+.1f%%)%s"), *Field.Key, BaselineValue, Value, Change, bFailed ? TEXT(" over tolerance") : TEXT(""));
+
+		if (bFailed) {
+			const FString& Failure = BaselineFailures.Add_GetRef(FString::Printf(TEXT("%d agents: %s %.3f, baseline %.3f, tolerance %.0f%%."),
+				Result.NumAgents, *Field.Key, Value, BaselineValue, BaselineTolerance * 100.0));
+			UE_LOG(LogTemp, Error, TEXT("Parkour Benchmark: %s"), *Failure);
+		}
+	}
+}
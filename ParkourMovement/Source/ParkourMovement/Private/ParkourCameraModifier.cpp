@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourCameraModifier.h"
+#include "ParkourMovementComponent.h"
+#include "Camera/CameraShakeBase.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "ParkourMovement/ParkourMovement.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Shakes Played"), STAT_ParkourCameraShakes, STATGROUP_ParkourMovement);
+
+/************************************************************/
+/*--------------------- Registration -----------------------*/
+/************************************************************/
+
+UParkourCameraModifier* UParkourCameraModifier::AddTo(APlayerController* PlayerController)
+{
+	if (!PlayerController || !PlayerController->IsLocalController() || !PlayerController->PlayerCameraManager) {
+		return nullptr;
+	}
+
+	if (UParkourCameraModifier* Existing = FindOn(PlayerController)) {
+		return Existing;
+	}
+
+	return Cast<UParkourCameraModifier>(PlayerController->PlayerCameraManager->AddNewCameraModifier(UParkourCameraModifier::StaticClass()));
+}
+
+UParkourCameraModifier* UParkourCameraModifier::FindOn(const APlayerController* PlayerController)
+{
+	if (!PlayerController || !PlayerController->PlayerCameraManager) {
+		return nullptr;
+	}
+
+	return Cast<UParkourCameraModifier>(PlayerController->PlayerCameraManager->FindCameraModifierByClass(UParkourCameraModifier::StaticClass()));
+}
+
+/************************************************************/
+/*----------------------- Shakes ---------------------------*/
+/************************************************************/
+
+void UParkourCameraModifier::PlayShake(TSubclassOf<UCameraShakeBase> ShakeClass, float Scale)
+{
+	if (!ShakeClass || !CameraOwner || IsDisabled()) {
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_ParkourCameraShakes);
+	CameraOwner->StartCameraShake(ShakeClass, Scale);
+}
+
+/************************************************************/
+/*----------------------- Camera ---------------------------*/
+/************************************************************/
+
+const UParkourMovementComponent* UParkourCameraModifier::FindParkour()
+{
+	AActor* ViewTarget = GetViewTarget();
+	if (ViewTarget != CachedViewTarget.Get()) {
+		CachedViewTarget = ViewTarget;
+		CachedParkour = ViewTarget ? ViewTarget->FindComponentByClass<UParkourMovementComponent>() : nullptr;
+	}
+
+	// Spectating someone else's character leaves their camera effects to them
+	const APawn* Pawn = Cast<APawn>(ViewTarget);
+	if (!Pawn || !Pawn->IsLocallyControlled()) {
+		return nullptr;
+	}
+
+	return CachedParkour.Get();
+}
+
+bool UParkourCameraModifier::ModifyCamera(float DeltaTime, FMinimalViewInfo& InOutPOV)
+{
+	Super::ModifyCamera(DeltaTime, InOutPOV);
+
+	const UParkourMovementComponent* Parkour = FindParkour();
+
+	float TargetRoll = 0.0f;
+	float TargetMantleLook = 0.0f;
+	float TiltSpeed = 10.0f;
+	float MantleLookSpeed = 7.0f;
+
+	if (Parkour) {
+		const UParkourMovementSettings& Settings = Parkour->GetSettings();
+		const FParkourAnimSnapshot Snapshot = Parkour->GetAnimSnapshot().Read();
+
+		TiltSpeed = Settings.CameraTiltSpeed;
+		MantleLookSpeed = Settings.MantleLookSpeed;
+
+		// Leaning away from the wall
+		if (Settings.bCameraTilt) {
+			if (Snapshot.Mode == EParkourMovement::LeftWallRun) {
+				TargetRoll = Settings.WallRunCameraRoll;
+			}
+			else if (Snapshot.Mode == EParkourMovement::RightWallRun) {
+				TargetRoll = -Settings.WallRunCameraRoll;
+			}
+		}
+
+		// Looking over the ledge, into the wall the mantle climbs
+		if ((Snapshot.Mode == EParkourMovement::Mantle) && !Snapshot.WallNormal.IsNearlyZero()) {
+			const FVector WallNormal = Parkour->GetOwner()->GetActorQuat().RotateVector(Snapshot.WallNormal);
+			MantleYaw = (float)(-WallNormal).Rotation().Yaw;
+			TargetMantleLook = 1.0f;
+		}
+	}
+
+	CurrentRoll = FMath::FInterpTo(CurrentRoll, TargetRoll, DeltaTime, TiltSpeed);
+	MantleLookAlpha = FMath::FInterpTo(MantleLookAlpha, TargetMantleLook, DeltaTime, MantleLookSpeed);
+
+	InOutPOV.Rotation.Roll += CurrentRoll * Alpha;
+	if (MantleLookAlpha > UE_KINDA_SMALL_NUMBER) {
+		InOutPOV.Rotation.Yaw += FMath::FindDeltaAngleDegrees(InOutPOV.Rotation.Yaw, (double)MantleYaw) * MantleLookAlpha * Alpha;
+	}
+
+	// Let the modifiers after this one run
+	return false;
+}
@@ -0,0 +1,282 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourCharacterMovementComponent.h"
+#include "EngineUtils.h"
+#include "GameFramework/Character.h"
+#include "ParkourMovement/ParkourMovement.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Corrections"), STAT_ParkourNetCorrections, STATGROUP_ParkourMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Parkour Correction Bits"), STAT_ParkourNetCorrectionBits, STATGROUP_ParkourMovement);
+
+static FAutoConsoleCommandWithWorld ParkourNetReportCommand(
+	TEXT("Parkour.NetReport"),
+	TEXT("Logs the corrections each parkour character has received, the bits of parkour state they have carried so far,\n")
+	TEXT("and the bytes per second its replicated parkour state costs at its NetUpdateFrequency."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TActorIterator<ACharacter> It(World); It; ++It) {
+			if (const UParkourCharacterMovementComponent* Movement = Cast<UParkourCharacterMovementComponent>(It->GetCharacterMovement())) {
+				UE_LOG(LogTemp, Display, TEXT("Parkour Net Report: %s (%s), predicted %d, %d corrections, %.1f KB of parkour correction data."),
+					*It->GetName(), *UEnum::GetValueAsString(It->GetLocalRole()), Movement->IsUpdatingParkour() ? 1 : 0,
+					Movement->GetNumCorrections(), Movement->GetParkourCorrectionBits() / 8192.0);
+			}
+
+			// Sent on the server, received on a simulated proxy. Per simulated proxy's connection, autonomous proxies don't get it.
+			if (const UParkourMovementComponent* Parkour = It->FindComponentByClass<UParkourMovementComponent>()) {
+				UE_LOG(LogTemp, Display, TEXT("Parkour Net Report: %s (%s), %d replicated state changes, %.2f bytes/s, NetUpdateFrequency %.0f."),
+					*It->GetName(), *UEnum::GetValueAsString(It->GetLocalRole()), Parkour->GetNumReplicatedStateChanges(),
+					Parkour->GetReplicatedStateBytesPerSecond(), It->NetUpdateFrequency);
+			}
+		}
+	}));
+
+/************************************************************/
+/*--------------------- Saved Move -------------------------*/
+/************************************************************/
+
+void FSavedMove_Parkour::Clear()
+{
+	Super::Clear();
+
+	SavedState = FParkourPredictedState();
+}
+
+uint8 FSavedMove_Parkour::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (EnumHasAnyFlags(SavedState.Presses, EParkourPress::Jump)) {
+		Result |= FLAG_JumpPress;
+	}
+	if (EnumHasAnyFlags(SavedState.Presses, EParkourPress::Sprint)) {
+		Result |= FLAG_SprintPress;
+	}
+	if (EnumHasAnyFlags(SavedState.Presses, EParkourPress::CrouchSlide)) {
+		Result |= FLAG_CrouchSlidePress;
+	}
+
+	return Result;
+}
+
+bool FSavedMove_Parkour::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	// A press or a move that changes parkour state has to reach the server on its own
+	const FParkourPredictedState& NewState = static_cast<const FSavedMove_Parkour*>(NewMove.Get())->SavedState;
+	if ((SavedState.Presses != EParkourPress::None) || (NewState.Presses != EParkourPress::None)) {
+		return false;
+	}
+	if ((SavedState.Mode != NewState.Mode) || (SavedState.GateMask != NewState.GateMask) || (SavedState.bSlideQueued != NewState.bSlideQueued) || (SavedState.bSprintQueued != NewState.bSprintQueued)) {
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Parkour::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	const UParkourCharacterMovementComponent* Movement = Cast<UParkourCharacterMovementComponent>(C->GetCharacterMovement());
+	if (Movement && Movement->GetParkourComponent()) {
+		Movement->GetParkourComponent()->GatherPredictedState(SavedState);
+	}
+}
+
+void FSavedMove_Parkour::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	// Replays run the move's presses again from the corrected state, arming timers from when the move was first made
+	const UParkourCharacterMovementComponent* Movement = Cast<UParkourCharacterMovementComponent>(C->GetCharacterMovement());
+	if (Movement && Movement->GetParkourComponent()) {
+		const FNetworkPredictionData_Client_Character* ClientData = Movement->GetPredictionData_Client_Character();
+		Movement->GetParkourComponent()->RestorePredictedInputs(SavedState);
+		Movement->GetParkourComponent()->SetReplayTimeOffset(FMath::Max(ClientData->CurrentTimeStamp - TimeStamp, 0.0f));
+	}
+}
+
+FNetworkPredictionData_Client_Parkour::FNetworkPredictionData_Client_Parkour(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Parkour::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Parkour());
+}
+
+/************************************************************/
+/*-------------------- Move Response -----------------------*/
+/************************************************************/
+
+void FParkourMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment)
+{
+	Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	ParkourState = FParkourPredictedState();
+	const UParkourMovementComponent* Parkour = static_cast<const UParkourCharacterMovementComponent&>(CharacterMovement).GetParkourComponent();
+	if (IsCorrection() && Parkour) {
+		Parkour->GatherPredictedState(ParkourState);
+	}
+}
+
+bool FParkourMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+	if (!Super::Serialize(CharacterMovement, Ar, PackageMap)) {
+		return false;
+	}
+
+	if (!IsCorrection()) {
+		return !Ar.IsError();
+	}
+
+	uint8 ModeBits = (uint8)ParkourState.Mode;
+	Ar.SerializeBits(&ModeBits, 4);
+	Ar.SerializeBits(&ParkourState.GateMask, 6);
+	uint8 QueuedBits = (ParkourState.bSlideQueued ? 1 : 0) | (ParkourState.bSprintQueued ? 2 : 0);
+	Ar.SerializeBits(&QueuedBits, 2);
+	ParkourState.bSlideQueued = (QueuedBits & 1) != 0;
+	ParkourState.bSprintQueued = (QueuedBits & 2) != 0;
+	Ar.SerializeBits(&ParkourState.ArmedTimers, (uint8)EParkourTimer::Count);
+
+	int32 NumBits = 12 + (int32)EParkourTimer::Count;
+	for (int32 Index = 0; Index < (int32)EParkourTimer::Count; ++Index) {
+		if (ParkourState.ArmedTimers & (1 << Index)) {
+			uint16 Milliseconds = Ar.IsSaving() ? (uint16)FMath::Clamp(FMath::RoundToInt(ParkourState.TimerRemaining[Index] * 1000.0f), 0, (int32)MAX_uint16) : 0;
+			Ar << Milliseconds;
+			ParkourState.TimerRemaining[Index] = Milliseconds / 1000.0f;
+			NumBits += 16;
+		}
+	}
+
+	if (Ar.IsLoading()) {
+		ParkourState.Mode = (ModeBits < NumParkourModes) ? (EParkourMovement)ModeBits : EParkourMovement::None;
+	}
+	else {
+		static_cast<UParkourCharacterMovementComponent&>(CharacterMovement).AddParkourCorrectionBits(NumBits);
+		INC_DWORD_STAT_BY(STAT_ParkourNetCorrectionBits, NumBits);
+	}
+
+	return !Ar.IsError();
+}
+
+/************************************************************/
+/*------------------ Movement Component --------------------*/
+/************************************************************/
+
+UParkourCharacterMovementComponent::UParkourCharacterMovementComponent()
+{
+	SetMoveResponseDataContainer(ParkourMoveResponseContainer);
+}
+
+void UParkourCharacterMovementComponent::SetParkourComponent(UParkourMovementComponent* InParkourComponent)
+{
+	ParkourComponent = InParkourComponent;
+}
+
+bool UParkourCharacterMovementComponent::IsUpdatingParkour() const
+{
+	if (!bPredictParkour || !ParkourComponent || !CharacterOwner || (CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)) {
+		return false;
+	}
+
+	// Only a player's client makes moves the server has to check, everyone else is better off on the component's update
+	return bUpdateAllCharacters || ((GetNetMode() != NM_Standalone) && CharacterOwner->IsPlayerControlled());
+}
+
+FNetworkPredictionData_Client* UParkourCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (!ClientPredictionData) {
+		UParkourCharacterMovementComponent* MutableThis = const_cast<UParkourCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Parkour(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UParkourCharacterMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// The frame's moves are done, run the timers that came due, send the Blueprint events, publish the animation snapshot
+	// and push any change to simulated proxies
+	if (IsUpdatingParkour()) {
+		ParkourComponent->RunDueTimers();
+		ParkourComponent->FlushEvents();
+		ParkourComponent->PublishAnimSnapshot();
+		ParkourComponent->UpdateReplicatedState();
+	}
+}
+
+void UParkourCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	// The client's presses for this move, run with it in UpdateCharacterStateBeforeMovement. Replays restore theirs in PrepMoveFor.
+	if (IsUpdatingParkour() && CharacterOwner->HasAuthority()) {
+		EParkourPress Presses = EParkourPress::None;
+		if (Flags & FSavedMove_Parkour::FLAG_JumpPress) {
+			Presses |= EParkourPress::Jump;
+		}
+		if (Flags & FSavedMove_Parkour::FLAG_SprintPress) {
+			Presses |= EParkourPress::Sprint;
+		}
+		if (Flags & FSavedMove_Parkour::FLAG_CrouchSlidePress) {
+			Presses |= EParkourPress::CrouchSlide;
+		}
+		ParkourComponent->PendingPresses = Presses;
+	}
+}
+
+void UParkourCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	// Runs before pending launches are handled, so LaunchCharacter calls from the presses and the update land in this same move
+	if (IsUpdatingParkour()) {
+		ParkourComponent->RunPendingPresses();
+
+		const int32 NumSteps = ParkourComponent->ConsumeFixedSteps(DeltaSeconds);
+		for (int32 Step = 0; Step < NumSteps; ++Step) {
+			ParkourComponent->UpdateEventMethod();
+		}
+		ParkourComponent->ApplyDeferredLaunch();
+	}
+}
+
+void UParkourCharacterMovementComponent::ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations)
+{
+	Super::ProcessLanded(Hit, remainingTime, Iterations);
+
+	// Lands the parkour update in the move that landed, on the client and the server alike. A Blueprint calling Land
+	// from its Landed event as well does nothing more, Land only ends a mode that is still running.
+	if (IsUpdatingParkour()) {
+		ParkourComponent->Land();
+	}
+}
+
+void UParkourCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	// Native replacement for binding OnMovementChanged, the parkour gates react to walking <-> falling
+	if (ParkourComponent) {
+		ParkourComponent->MovementChanged(PreviousMovementMode, MovementMode);
+	}
+}
+
+void UParkourCharacterMovementComponent::OnClientCorrectionReceived(FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode)
+{
+	Super::OnClientCorrectionReceived(ClientData, TimeStamp, NewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
+
+	++NumCorrections;
+	INC_DWORD_STAT(STAT_ParkourNetCorrections);
+
+	// The moves after this one are replayed from the server's parkour state. The legacy unpacked RPCs don't carry it.
+	const FCharacterMoveResponseDataContainer& Response = GetMoveResponseDataContainer();
+	if (IsUpdatingParkour() && Response.IsCorrection() && (Response.ClientAdjustment.TimeStamp == TimeStamp)) {
+		const float SecondsAgo = FMath::Max(ClientData.CurrentTimeStamp - TimeStamp, 0.0f);
+		ParkourComponent->ApplyServerPredictedState(static_cast<const FParkourMoveResponseDataContainer&>(Response).ParkourState, SecondsAgo);
+	}
+}
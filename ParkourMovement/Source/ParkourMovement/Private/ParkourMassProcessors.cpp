@@ -0,0 +1,1019 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourMassProcessors.h"
+#include "ParkourMovementWorldSubsystem.h"
+#include "ParkourTransitions.h"
+#include "Async/ParallelFor.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "MassActorSubsystem.h"
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "MassLODFragments.h"
+#include "MassMovementFragments.h"
+#include "MassSimulationLOD.h"
+#include "ParkourMovement/ParkourMovement.h"
+
+DECLARE_CYCLE_STAT(TEXT("Mass Probe"), STAT_ParkourMassProbe, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Mass Movement"), STAT_ParkourMassMovement, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Mass Handoff"), STAT_ParkourMassHandoff, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mass Runners Updated"), STAT_ParkourMassRunners, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mass Probes From Surface Database"), STAT_ParkourMassDatabaseProbes, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mass Scene Queries"), STAT_ParkourMassSceneQueries, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mass Scene Queries Over Budget"), STAT_ParkourMassSkippedQueries, STATGROUP_ParkourMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Mass Runners Driven By Actors"), STAT_ParkourMassActorDriven, STATGROUP_ParkourMovement);
+
+static TAutoConsoleVariable<int32> CVarParkourMassMaxSceneQueries(
+	TEXT("Parkour.Mass.MaxSceneQueries"),
+	4096,
+	TEXT("Scene queries the crowd runners may issue in one frame. Probes over the cap keep their last result and\n")
+	TEXT("are run first next frame. Probes the surface database answers don't count."),
+	ECVF_Default);
+
+// The floor probe's length, the same as GetSlideVector's
+static constexpr float ParkourMassFloorProbeLength = 200.0f;
+
+// Floor hits within this of the capsule's bottom count as standing on it
+static constexpr float ParkourMassFloorSnapDistance = 5.0f;
+
+// UCharacterMovementComponent's default walkable floor angle, 44.765 degrees
+static constexpr float ParkourMassWalkableFloorZ = 0.71f;
+
+/************************************************************/
+/*------------------------ Runner --------------------------*/
+/************************************************************/
+
+namespace ParkourMass
+{
+	// The probe fragment, as the world the parkour core's probe decisions are made against. The probe processor
+	// already ran each probe from the same origin with the same rules, so a trace reads back what it found.
+	struct FProbeWorldQuery final : public IParkourWorldQuery
+	{
+		explicit FProbeWorldQuery(const FParkourMassProbeFragment& InProbes) : Probes(InProbes) {}
+
+		virtual bool Trace(EParkourProbe Probe, const FVector& Start, const FVector& End, FParkourQueryHit& OutHit) override
+		{
+			OutHit = FParkourQueryHit();
+			if (!Probes.HasHit(Probe)) {
+				return false;
+			}
+
+			OutHit.bBlockingHit = true;
+			OutHit.Location = OutHit.ImpactPoint = Probes.Points[(uint8)Probe];
+			OutHit.Normal = OutHit.ImpactNormal = Probes.Normals[(uint8)Probe];
+			OutHit.Distance = Probes.Distances[(uint8)Probe];
+			OutHit.bWalkable = (OutHit.ImpactNormal.Z >= ParkourMassWalkableFloorZ);
+			return true;
+		}
+
+	private:
+		const FParkourMassProbeFragment& Probes;
+	};
+
+	/**
+	 * One entity's step, written the way UParkourMovementComponent is, function for function, so the two read
+	 * side by side. Triggers and mode changes go through FParkourTransitionTable and the probe decisions through
+	 * the parkour core, the same as the component's. Where the component launches the character or changes its
+	 * CharacterMovementComponent, the runner changes the entity's velocity and the few movement values it keeps itself.
+	 */
+	struct FRunner final : public IParkourTransitionTarget
+	{
+		FParkourMassStateFragment& State;
+		FParkourMassInputFragment& Input;
+		const FParkourMassSettingsFragment& Shared;
+		const UParkourMovementSettings& Tuning;
+		FTransform& Transform;
+		FVector& Velocity;
+		float DeltaTime;
+		int32& NumTransitions;
+		FProbeWorldQuery World;
+
+		FRunner(FParkourMassStateFragment& InState, FParkourMassInputFragment& InInput, const FParkourMassProbeFragment& InProbes, const FParkourMassSettingsFragment& InShared,
+			const UParkourMovementSettings& InTuning, FTransform& InTransform, FVector& InVelocity, float InDeltaTime, int32& InNumTransitions)
+			: State(InState), Input(InInput), Shared(InShared), Tuning(InTuning), Transform(InTransform), Velocity(InVelocity), DeltaTime(InDeltaTime)
+			, NumTransitions(InNumTransitions), World(InProbes)
+		{
+		}
+
+		FVector Forward() const { return Transform.GetRotation().GetForwardVector(); }
+		float ForwardInput() const { return ParkourRules::ForwardInput(Forward(), Input.MoveInput); }
+
+		// MakeProbeOrigin, from the entity's transform and the trait's capsule
+		FParkourProbeOrigin MakeProbeOrigin() const
+		{
+			FParkourProbeOrigin Origin;
+			Origin.Location = Transform.GetLocation();
+			Origin.Forward = Forward();
+			Origin.Right = Transform.GetRotation().GetRightVector();
+			Origin.Up = Transform.GetRotation().GetUpVector();
+			Origin.Eyes = Origin.Location + FVector(0, 0, Shared.BaseEyeHeight);
+			Origin.CapsuleHalfHeight = Shared.CapsuleHalfHeight;
+			Origin.MantleHeight = Tuning.MantleHeight;
+			return Origin;
+		}
+
+		/* Modes */
+		bool SetMode(EParkourMovement NewMode)
+		{
+			if (NewMode == State.Mode) {
+				return false;
+			}
+
+			FParkourTransitionTable::RunExit(*this, State.Mode);
+			State.Mode = NewMode;
+			FParkourTransitionTable::RunEnter(*this, NewMode);
+
+			++NumTransitions;
+			return true;
+		}
+
+		// The defaults come back on returning to None or Crouch, the other modes set their own
+		virtual void ResetMovement() override
+		{
+			if ((State.Mode == EParkourMovement::None) || (State.Mode == EParkourMovement::Crouch)) {
+				State.GravityScale = 1.0f;
+			}
+		}
+
+		virtual void LedgeGrabEnter() override
+		{
+			State.GravityScale = 0.0f;
+			Velocity = FVector::ZeroVector;
+		}
+
+		// The sprint speed is read from the mode by Move
+		virtual void SprintEnter() override {}
+
+		/* Timers */
+		void ArmTimer(EParkourTimer Timer, float Delay)
+		{
+			State.Timers[(uint8)Timer] = FMath::Max(Delay, 0.0f);
+		}
+
+		void RunDueTimers()
+		{
+			for (uint8 Timer = 0; Timer < (uint8)EParkourTimer::Count; ++Timer) {
+				float& Remaining = State.Timers[Timer];
+				if (Remaining <= 0.0f) {
+					continue;
+				}
+
+				Remaining -= DeltaTime;
+				if (Remaining > 0.0f) {
+					continue;
+				}
+
+				Remaining = 0.0f;
+				switch ((EParkourTimer)Timer) {
+				case EParkourTimer::WallRunOpenGate: State.SetGateOpen(EParkourGate::WallRun, true);
+					break;
+				case EParkourTimer::WallRunEnableGravity: State.bWallRunGravity = ParkourRules::IsWallRunning(State.Mode);
+					break;
+				case EParkourTimer::MantleCheck: State.SetGateOpen(EParkourGate::MantleCheck, true);
+					break;
+				case EParkourTimer::VerticalRunEndGate: OpenVerticalWallRunGate();
+					break;
+				case EParkourTimer::CheckQueues: CheckQueues();
+					break;
+				case EParkourTimer::OpenSprintGate: State.SetGateOpen(EParkourGate::Sprint, true);
+					break;
+				case EParkourTimer::VerticalWallRunEnd:
+					if (State.Mode == EParkourMovement::VerticalWallRun) {
+						VerticalWallRunEnd(2.0f);
+					}
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		/* Gates */
+		void OpenVerticalWallRunGate()
+		{
+			if (Tuning.VerticalWallRunTime > 0) {
+				ArmTimer(EParkourTimer::VerticalWallRunEnd, Tuning.VerticalWallRunTime);
+			}
+			State.SetGateOpen(EParkourGate::VerticalWallRun, true);
+		}
+
+		void CloseVerticalWallRunGate()
+		{
+			State.SetGateOpen(EParkourGate::VerticalWallRun, false);
+			State.SetGateOpen(EParkourGate::Mantle, false);
+		}
+
+		virtual void OpenGates() override
+		{
+			State.SetGateOpen(EParkourGate::WallRun, true);
+			OpenVerticalWallRunGate();
+			State.SetGateOpen(EParkourGate::Slide, true);
+			State.SetGateOpen(EParkourGate::Sprint, true);
+		}
+
+		void CloseGates()
+		{
+			State.SetGateOpen(EParkourGate::WallRun, false);
+			CloseVerticalWallRunGate();
+			State.SetGateOpen(EParkourGate::Slide, false);
+			State.SetGateOpen(EParkourGate::Sprint, false);
+		}
+
+		/* Triggers */
+		bool FireTrigger(EParkourTrigger Trigger)
+		{
+			FParkourTransitionContext Context;
+			Context.Mode = State.Mode;
+			Context.bIsFalling = State.bFalling;
+			return FParkourTransitionTable::Fire(*this, Trigger, Context);
+		}
+
+		/* Input */
+		void Jump()
+		{
+			const bool bWasGrounded = !State.bFalling && (State.Mode != EParkourMovement::Slide);
+			FireTrigger(EParkourTrigger::Jump);
+
+			// The character's own jump
+			if (bWasGrounded) {
+				Velocity.Z = Shared.JumpZVelocity;
+				Fall();
+			}
+		}
+
+		void CrouchSlide()
+		{
+			if (FireTrigger(EParkourTrigger::Cancel)) {
+				return;
+			}
+
+			if (ParkourRules::CanSlide(ForwardInput(), State.Mode, State.bSprintQueued)) {
+				if (!State.bFalling) {
+					SlideStart();
+				}
+			}
+			else {
+				FireTrigger(EParkourTrigger::Crouch);
+			}
+		}
+
+		void CheckQueues()
+		{
+			if (State.bSprintQueued) {
+				SprintStart();
+			}
+		}
+
+		/* Movement Changes */
+		void Fall()
+		{
+			if (!State.bFalling) {
+				State.bFalling = true;
+				FireTrigger(EParkourTrigger::Fall);
+				OpenGates();
+			}
+		}
+
+		void Land()
+		{
+			if (State.bFalling) {
+				State.bFalling = false;
+				FireTrigger(EParkourTrigger::Land);
+				CloseGates();
+				CheckQueues();
+			}
+		}
+
+		/* Wall Run */
+		virtual void WallRunEnd(float ResetTime) override
+		{
+			if (ParkourRules::IsWallRunning(State.Mode) && SetMode(EParkourMovement::None)) {
+				State.SetGateOpen(EParkourGate::WallRun, false);
+				ArmTimer(EParkourTimer::WallRunOpenGate, ResetTime);
+			}
+		}
+
+		virtual void WallRunExit() override
+		{
+			ArmTimer(EParkourTimer::WallRunEnableGravity, 0.0f);
+			State.bWallRunGravity = false;
+		}
+
+		bool WallRunMovement(float WallRunDirection)
+		{
+			FParkourQueryHit Hit;
+			const bool bRunnableWall = ParkourCore::FindWallRunWall(World, MakeProbeOrigin(), WallRunDirection, Hit);
+			if (!Hit.bBlockingHit) {
+				return false;
+			}
+
+			State.WallNormal = Hit.Normal;
+			State.WallLocation = Hit.ImpactPoint;
+			if (!bRunnableWall || !State.bFalling) {
+				return false;
+			}
+
+			// LaunchCharacter along the wall, overriding Z until the wall run's gravity kicks in
+			const float Speed = State.bSprintQueued ? Tuning.WallRunSprintSpeed : Tuning.WallRunSpeed;
+			const FVector Launch = ParkourRules::WallRunLaunchVelocity(State.WallNormal, Speed, WallRunDirection);
+			const bool bOverrideZ = !ParkourRules::IsWallRunning(State.Mode) || !State.bWallRunGravity;
+			Velocity = FVector(Launch.X, Launch.Y, bOverrideZ ? Launch.Z : Velocity.Z);
+			return true;
+		}
+
+		void WallRunStarted(EParkourMovement Mode)
+		{
+			if (SetMode(Mode)) {
+				ArmTimer(EParkourTimer::WallRunEnableGravity, 1.0f);
+
+				// CorrectWallRunLocation, the wall correction's end point
+				const FVector Target = ParkourRules::WallRunTargetLocation(State.WallLocation, State.WallNormal, Shared.CapsuleRadius);
+				Transform.SetLocation(FVector(Target.X, Target.Y, Transform.GetLocation().Z));
+			}
+			State.GravityScale = FMath::FInterpTo(State.GravityScale, Tuning.WallRunTargetGravity, DeltaTime, Tuning.WallRunStartSpeed);
+		}
+
+		void WallRunUpdate()
+		{
+			if (!ParkourRules::CanWallRun(ForwardInput(), State.Mode)) {
+				WallRunEnd(1.0f);
+			}
+			else if (WallRunMovement(-1.0f)) {
+				WallRunStarted(EParkourMovement::RightWallRun);
+			}
+			else if (State.Mode == EParkourMovement::RightWallRun) {
+				WallRunEnd(0.5f);
+			}
+			else if (WallRunMovement(1.0f)) {
+				WallRunStarted(EParkourMovement::LeftWallRun);
+			}
+			else {
+				WallRunEnd(0.5f);
+			}
+		}
+
+		virtual void WallRunJump() override
+		{
+			WallRunEnd(0.35f);
+			Velocity += FVector(Tuning.WallRunJumpOffForce * State.WallNormal.X, Tuning.WallRunJumpOffForce * State.WallNormal.Y, 0.0f);
+			Velocity.Z = Tuning.WallRunJumpHeight;
+		}
+
+		/* Vertical Wall Run */
+		bool IsQuickMantle() const
+		{
+			return ParkourRules::IsQuickMantle(State.MantleTraceDistance, Tuning.MantleHeight, false);
+		}
+
+		void VerticalWallRunUpdate()
+		{
+			if (!ParkourRules::CanVerticalWallRun(ForwardInput(), State.Mode, State.bFalling)) {
+				VerticalWallRunEnd(0.35f);
+				return;
+			}
+
+			const FParkourProbeOrigin Origin = MakeProbeOrigin();
+			FParkourLedge Ledge;
+			FParkourQueryHit WallHit;
+			if (ParkourCore::FindLedge(World, Origin, Ledge)) {
+				State.MantleTraceDistance = Ledge.TraceDistance;
+				State.LedgeFloorPosition = Ledge.FloorLocation;
+				State.WallLocation = Ledge.WallLocation;
+				State.WallNormal = Ledge.WallNormal;
+				State.MantlePosition = State.LedgeFloorPosition + FVector(0, 0, ParkourRules::MantleZOffset(Shared.CapsuleHalfHeight));
+				CloseVerticalWallRunGate();
+				LedgeGrab();
+			}
+			else if (ParkourCore::FindClimbWall(World, Origin, WallHit)) {
+				State.WallLocation = WallHit.ImpactPoint;
+				State.WallNormal = WallHit.ImpactNormal;
+				SetMode(EParkourMovement::VerticalWallRun);
+				Velocity = FVector(State.WallNormal.X * -600.0f, State.WallNormal.Y * -600.0f, Tuning.VerticalWallRunSpeed);
+			}
+			else {
+				VerticalWallRunEnd(0.35f);
+			}
+		}
+
+		virtual void VerticalWallRunEnd(float ResetTime) override
+		{
+			if (ParkourRules::IsOnWall(State.Mode) && SetMode(EParkourMovement::None)) {
+				CloseVerticalWallRunGate();
+				State.SetGateOpen(EParkourGate::MantleCheck, false);
+				ArmTimer(EParkourTimer::VerticalRunEndGate, ResetTime);
+				ArmTimer(EParkourTimer::CheckQueues, 0.02f);
+			}
+		}
+
+		virtual void LedgeGrabJump() override
+		{
+			VerticalWallRunEnd(0.35f);
+			Velocity = FVector(Tuning.LedgeGrabJumpOffForce * State.WallNormal.X, Tuning.LedgeGrabJumpOffForce * State.WallNormal.Y, Tuning.LedgeGrabJumpHeight);
+		}
+
+		/* Ledge Grab */
+		// Movement is stopped by the ledge grab entry action
+		void LedgeGrab()
+		{
+			if (!SetMode(EParkourMovement::LedgeGrab)) {
+				return;
+			}
+
+			if (IsQuickMantle()) {
+				State.SetGateOpen(EParkourGate::MantleCheck, true);
+			}
+			else {
+				// CorrectLedgeLocation, the snap's end point, facing the wall
+				Transform.SetLocation(ParkourRules::LedgeTargetLocation(State.WallLocation, State.WallNormal, State.LedgeFloorPosition, Shared.CapsuleRadius, Shared.CapsuleHalfHeight));
+				Transform.SetRotation(FRotator(0.0f, ParkourRules::FacingWallYaw(State.WallNormal), 0.0f).Quaternion());
+				ArmTimer(EParkourTimer::MantleCheck, 0.25f);
+			}
+		}
+
+		/* Mantle */
+		void MantleCheckGate()
+		{
+			if (State.IsGateOpen(EParkourGate::MantleCheck) && ParkourRules::CanMantle(ForwardInput(), State.Mode, IsQuickMantle())) {
+				if (SetMode(EParkourMovement::Mantle)) {
+					State.SetGateOpen(EParkourGate::MantleCheck, false);
+					State.SetGateOpen(EParkourGate::Mantle, true);
+				}
+			}
+		}
+
+		void MantleGate()
+		{
+			if (!State.IsGateOpen(EParkourGate::Mantle)) {
+				return;
+			}
+
+			// The same exponential approach the mantle's root motion source is timed from, ending within 8 units
+			const float Speed = IsQuickMantle() ? Tuning.QuickMantleSpeed : Tuning.MantleSpeed;
+			const FVector Offset = Transform.GetLocation() - State.MantlePosition;
+			Transform.SetLocation(State.MantlePosition + (Offset * FMath::Exp(-Speed * DeltaTime)));
+			Velocity = FVector::ZeroVector;
+
+			if (FVector::Dist(Transform.GetLocation(), State.MantlePosition) < 8.0f) {
+				VerticalWallRunEnd(0.5f);
+				Land();
+			}
+		}
+
+		/* Slide */
+		void SlideStart()
+		{
+			if (!ParkourRules::CanSlide(ForwardInput(), State.Mode, State.bSprintQueued) || State.bFalling) {
+				return;
+			}
+			SprintEnd();
+			SetMode(EParkourMovement::Slide);
+
+			// GetSlideVector, down the floor under the runner
+			FParkourQueryHit FloorHit;
+			const FVector Location = Transform.GetLocation();
+			const FVector FloorNormal = World.Trace(EParkourProbe::SlideFloor, Location, Location - FVector(0, 0, ParkourMassFloorProbeLength), FloorHit) ? FloorHit.ImpactNormal : FVector::UpVector;
+			const FVector SlideVector = ParkourRules::SlideVector(FloorNormal, Transform.GetRotation().GetRightVector());
+			if (SlideVector.Z <= 0.02) {
+				Velocity += SlideVector * Tuning.SlideImpulseAmount;
+			}
+
+			State.SetGateOpen(EParkourGate::Slide, true);
+			State.bSprintQueued = false;
+		}
+
+		virtual void SlideEnd(bool bIsCrouched) override
+		{
+			if ((State.Mode == EParkourMovement::Slide) && SetMode(bIsCrouched ? EParkourMovement::Crouch : EParkourMovement::None)) {
+				State.SetGateOpen(EParkourGate::Slide, false);
+			}
+		}
+
+		void SlideGate()
+		{
+			if (State.IsGateOpen(EParkourGate::Slide) && (State.Mode == EParkourMovement::Slide) && (Velocity.Length() <= 35.0f)) {
+				SlideEnd(true);
+			}
+		}
+
+		virtual void SlideJump() override
+		{
+			SlideEnd(false);
+		}
+
+		/* Crouch */
+		virtual void CrouchStart() override
+		{
+			SetMode(EParkourMovement::Crouch);
+			State.bSprintQueued = false;
+		}
+
+		virtual void CrouchEnd() override
+		{
+			if (State.Mode == EParkourMovement::Crouch) {
+				SetMode(EParkourMovement::None);
+				State.bSprintQueued = false;
+			}
+		}
+
+		virtual void CrouchJump() override
+		{
+			CrouchEnd();
+		}
+
+		/* Sprint */
+		void SprintStart()
+		{
+			SlideEnd(false);
+			CrouchEnd();
+
+			if (ParkourRules::CanSprint(!State.bFalling, State.Mode) && SetMode(EParkourMovement::Sprint)) {
+				State.SetGateOpen(EParkourGate::Sprint, true);
+				State.bSprintQueued = false;
+			}
+		}
+
+		virtual void SprintEnd() override
+		{
+			if ((State.Mode == EParkourMovement::Sprint) && SetMode(EParkourMovement::None)) {
+				State.SetGateOpen(EParkourGate::Sprint, false);
+				ArmTimer(EParkourTimer::OpenSprintGate, 0.1f);
+			}
+		}
+
+		virtual void SprintJump() override
+		{
+			SprintEnd();
+			State.bSprintQueued = true;
+		}
+
+		void SprintGate()
+		{
+			if (State.IsGateOpen(EParkourGate::Sprint) && (State.Mode == EParkourMovement::Sprint) && !(ForwardInput() > 0)) {
+				SprintEnd();
+			}
+		}
+
+		/* Update */
+		// UpdateSequence, then the part of UCharacterMovementComponent the runner stands in for
+		void Update(float GravityZ)
+		{
+			RunDueTimers();
+
+			if (Input.bJumpPressed) {
+				Jump();
+			}
+			if (Input.bCrouchPressed) {
+				CrouchSlide();
+			}
+			if (Input.bSprintPressed) {
+				SprintStart();
+			}
+			Input.bJumpPressed = Input.bCrouchPressed = Input.bSprintPressed = false;
+
+			if (State.IsGateOpen(EParkourGate::WallRun)) {
+				WallRunUpdate();
+			}
+			if (State.IsGateOpen(EParkourGate::VerticalWallRun)) {
+				VerticalWallRunUpdate();
+			}
+			MantleCheckGate();
+			MantleGate();
+			SlideGate();
+			SprintGate();
+
+			Move(GravityZ);
+		}
+
+		void Move(float GravityZ)
+		{
+			if ((State.Mode == EParkourMovement::LedgeGrab) || (State.Mode == EParkourMovement::Mantle)) {
+				return;
+			}
+
+			const FVector MoveInput = Input.MoveInput.GetClampedToMaxSize(1.0f);
+			if (State.bFalling) {
+				Velocity.Z += GravityZ * State.GravityScale * DeltaTime;
+
+				if (!ParkourRules::IsWallRunning(State.Mode) && (State.Mode != EParkourMovement::VerticalWallRun)) {
+					const FVector AirVelocity = FVector(Velocity.X, Velocity.Y, 0.0f) + (MoveInput * Shared.MaxAcceleration * Shared.AirControl * DeltaTime);
+					const float MaxAirSpeed = FMath::Max(FVector(Velocity.X, Velocity.Y, 0.0f).Length(), Shared.MaxWalkSpeed);
+					Velocity = FVector(AirVelocity.GetClampedToMaxSize2D(MaxAirSpeed), Velocity.Z);
+				}
+			}
+			else if (State.Mode == EParkourMovement::Slide) {
+				// No ground friction while sliding, only the slide's braking
+				Velocity = FVector(Velocity.X, Velocity.Y, 0.0f).GetClampedToMaxSize(FMath::Max(Velocity.Length() - (1400.0f * DeltaTime), 0.0f));
+			}
+			else {
+				float MaxSpeed = Shared.MaxWalkSpeed;
+				if (State.Mode == EParkourMovement::Sprint) {
+					MaxSpeed = Tuning.SprintSpeed;
+				}
+				else if (State.Mode == EParkourMovement::Crouch) {
+					MaxSpeed = Shared.MaxWalkSpeedCrouched;
+				}
+
+				const FVector Current = FVector(Velocity.X, Velocity.Y, 0.0f);
+				const FVector Target = MoveInput * MaxSpeed;
+				const float MaxChange = (MoveInput.IsNearlyZero() ? Shared.BrakingDecelerationWalking : Shared.MaxAcceleration) * DeltaTime;
+				Velocity = Current + (Target - Current).GetClampedToMaxSize(MaxChange);
+			}
+
+			FVector Location = Transform.GetLocation() + (Velocity * DeltaTime);
+
+			// Stand on the floor the probe found, fall when it's gone
+			const FVector Start = Transform.GetLocation();
+			FParkourQueryHit FloorHit;
+			const bool bOnFloor = World.Trace(EParkourProbe::SlideFloor, Start, Start - FVector(0, 0, ParkourMassFloorProbeLength), FloorHit) && FloorHit.bWalkable
+				&& (FloorHit.Distance <= Shared.CapsuleHalfHeight + ParkourMassFloorSnapDistance);
+			if (bOnFloor && (Velocity.Z <= 0.0f)) {
+				Location.Z = FloorHit.ImpactPoint.Z + Shared.CapsuleHalfHeight;
+				Velocity.Z = 0.0f;
+				Land();
+			}
+			else if (!bOnFloor) {
+				Fall();
+			}
+			Transform.SetLocation(Location);
+
+			// bOrientRotationToMovement, along the wall while wall running
+			FVector Facing = FVector(Velocity.X, Velocity.Y, 0.0f);
+			if (State.Mode == EParkourMovement::VerticalWallRun) {
+				Facing = -State.WallNormal;
+			}
+			if (Facing.SizeSquared2D() > 1.0f) {
+				Transform.SetRotation(FRotator(0.0f, Facing.Rotation().Yaw, 0.0f).Quaternion());
+			}
+		}
+	};
+}
+
+/************************************************************/
+/*------------------------ Probe ---------------------------*/
+/************************************************************/
+
+UParkourMassProbeProcessor::UParkourMassProbeProcessor()
+{
+	bAutoRegisterWithProcessingPhases = true;
+	ExecutionFlags = (int32)EProcessorExecutionFlags::All;
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+	ExecutionOrder.ExecuteBefore.Add(UParkourMassMovementProcessor::StaticClass()->GetFName());
+
+	// Issues its own ParallelFor over the batch, and scene queries count into GParkourCounters
+	bRequiresGameThreadExecution = true;
+}
+
+void UParkourMassProbeProcessor::Initialize(UObject& Owner)
+{
+	Super::Initialize(Owner);
+
+	ParkourSubsystem = UWorld::GetSubsystem<UParkourMovementWorldSubsystem>(Owner.GetWorld());
+}
+
+void UParkourMassProbeProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FParkourMassStateFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FParkourMassInputFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FParkourMassProbeFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FParkourMassSettingsFragment>(EMassFragmentPresence::All);
+	EntityQuery.AddTagRequirement<FParkourMassAgentTag>(EMassFragmentPresence::All);
+	EntityQuery.AddTagRequirement<FParkourMassActorDrivenTag>(EMassFragmentPresence::None);
+	EntityQuery.AddTagRequirement<FMassOffLODTag>(EMassFragmentPresence::None);
+	EntityQuery.AddChunkRequirement<FMassSimulationVariableTickChunkFragment>(EMassFragmentAccess::ReadOnly, EMassFragmentPresence::Optional);
+	EntityQuery.SetChunkFilter(&FMassSimulationVariableTickChunkFragment::ShouldTickChunkThisFrame);
+	EntityQuery.RegisterWithProcessor(*this);
+}
+
+void UParkourMassProbeProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParkourMassProbe);
+
+	Requests.Reset();
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [this](FMassExecutionContext& Context)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FParkourMassStateFragment> States = Context.GetFragmentView<FParkourMassStateFragment>();
+		const TConstArrayView<FParkourMassInputFragment> Inputs = Context.GetFragmentView<FParkourMassInputFragment>();
+		const TArrayView<FParkourMassProbeFragment> Results = Context.GetMutableFragmentView<FParkourMassProbeFragment>();
+		const FParkourMassSettingsFragment& Settings = Context.GetConstSharedFragment<FParkourMassSettingsFragment>();
+
+		for (int32 Index = 0; Index < Context.GetNumEntities(); ++Index) {
+			GatherRequests(Transforms[Index].GetTransform(), States[Index], Inputs[Index], Settings, Results[Index]);
+		}
+	});
+
+	// Requests the database can't answer are capped, starting where last frame's cap left off
+	const int32 MaxSceneQueries = FMath::Max(CVarParkourMassMaxSceneQueries.GetValueOnGameThread(), 0);
+	int32 NumSceneRequests = 0;
+	for (const FParkourMassProbeRequest& Request : Requests) {
+		NumSceneRequests += Request.bFromDatabase ? 0 : 1;
+	}
+
+	const int32 FirstSceneRequest = (NumSceneRequests > MaxSceneQueries) ? (int32)(FrameCounter++ % (uint32)NumSceneRequests) : 0;
+	int32 SceneRequestIndex = 0;
+	int32 NumSkipped = 0;
+	for (FParkourMassProbeRequest& Request : Requests) {
+		if (!Request.bFromDatabase) {
+			const int32 Slot = (SceneRequestIndex++ - FirstSceneRequest + NumSceneRequests) % FMath::Max(NumSceneRequests, 1);
+			if (Slot >= MaxSceneQueries) {
+				// Keeps last frame's result
+				Request.Result = nullptr;
+				++NumSkipped;
+			}
+		}
+	}
+
+	ParallelFor(Requests.Num(), [this](int32 Index)
+	{
+		if (Requests[Index].Result) {
+			RunRequest(Requests[Index]);
+		}
+	});
+
+	int32 NumDatabase = 0;
+	int32 NumScene = 0;
+	for (FParkourMassProbeRequest& Request : Requests) {
+		if (!Request.Result) {
+			continue;
+		}
+
+		const uint8 Bit = 1 << (uint8)Request.Probe;
+		Request.Result->ProbedMask |= Bit;
+		if (Request.bHit) {
+			Request.Result->HitMask |= Bit;
+			Request.Result->Points[(uint8)Request.Probe] = Request.Hit.ImpactPoint;
+			Request.Result->Normals[(uint8)Request.Probe] = Request.Hit.ImpactNormal;
+			Request.Result->Distances[(uint8)Request.Probe] = Request.Hit.Distance;
+		}
+		else {
+			Request.Result->HitMask &= ~Bit;
+		}
+
+		NumDatabase += Request.bFromDatabase ? 1 : 0;
+		NumScene += Request.bFromDatabase ? 0 : 1;
+	}
+
+	GParkourCounters.SceneQueries += NumScene;
+	INC_DWORD_STAT_BY(STAT_ParkourMassDatabaseProbes, NumDatabase);
+	INC_DWORD_STAT_BY(STAT_ParkourMassSceneQueries, NumScene);
+	INC_DWORD_STAT_BY(STAT_ParkourMassSkippedQueries, NumSkipped);
+}
+
+void UParkourMassProbeProcessor::GatherRequests(const FTransform& Transform, const FParkourMassStateFragment& State, const FParkourMassInputFragment& Input,
+	const FParkourMassSettingsFragment& Settings, FParkourMassProbeFragment& Result)
+{
+	const UParkourMovementSettings& Tuning = Settings.GetSettings();
+	const FVector Location = Transform.GetLocation();
+	const FVector Forward = Transform.GetRotation().GetForwardVector();
+	const FVector Right = Transform.GetRotation().GetRightVector();
+	const float ForwardInput = ParkourRules::ForwardInput(Forward, Input.MoveInput);
+
+	// Probes the runner doesn't need this frame can't be left looking like hits
+	Result.ProbedMask = 0;
+	uint8 NeededMask = 0;
+
+	// The floor, every frame
+	NeededMask |= 1 << (uint8)EParkourProbe::SlideFloor;
+	AddRequest(Result, EParkourProbe::SlideFloor, Location, Location - FVector(0, 0, ParkourMassFloorProbeLength), 0.0f, 0.0f,
+		UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery5));
+
+	if (State.bFalling && State.IsGateOpen(EParkourGate::WallRun) && ParkourRules::CanWallRun(ForwardInput, State.Mode)) {
+		NeededMask |= (1 << (uint8)EParkourProbe::WallRunRight) | (1 << (uint8)EParkourProbe::WallRunLeft);
+		AddRequest(Result, EParkourProbe::WallRunRight, Location, ParkourRules::WallRunEndRight(Location, Right, Forward), 0.0f, 0.0f, ECC_Visibility);
+		AddRequest(Result, EParkourProbe::WallRunLeft, Location, ParkourRules::WallRunEndLeft(Location, Right, Forward), 0.0f, 0.0f, ECC_Visibility);
+	}
+
+	if (State.IsGateOpen(EParkourGate::VerticalWallRun) && ParkourRules::CanVerticalWallRun(ForwardInput, State.Mode, State.bFalling)) {
+		const FVector Eyes = Location + FVector(0, 0, Settings.BaseEyeHeight);
+		const FVector Feet = ParkourRules::MantleVectorFeet(Location, Settings.CapsuleHalfHeight, Tuning.MantleHeight, Forward);
+		NeededMask |= (1 << (uint8)EParkourProbe::LedgeFloor) | (1 << (uint8)EParkourProbe::LedgeWall);
+		AddRequest(Result, EParkourProbe::LedgeFloor, ParkourRules::MantleVectorEyes(Eyes, Forward), Feet, 20.0f, 10.0f,
+			UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery4));
+		AddRequest(Result, EParkourProbe::LedgeWall, Feet, Feet + (Forward * 50), 10.0f, 5.0f,
+			UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery3));
+	}
+
+	Result.HitMask &= NeededMask;
+}
+
+void UParkourMassProbeProcessor::AddRequest(FParkourMassProbeFragment& Result, EParkourProbe Probe, const FVector& Start, const FVector& End, float Radius, float HalfHeight, ECollisionChannel Channel)
+{
+	FParkourMassProbeRequest& Request = Requests.AddDefaulted_GetRef();
+	Request.Result = &Result;
+	Request.Probe = Probe;
+	Request.Start = Start;
+	Request.End = End;
+	Request.Radius = Radius;
+	Request.HalfHeight = HalfHeight;
+	Request.Channel = Channel;
+
+	// Crowd runners only see static geometry where the level is baked, movables need a full character
+	EParkourSurfaceFlags SurfaceFlags;
+	Request.bFromDatabase = ParkourSubsystem && ParkourSubsystem->GetSurfaceDatabase().Contains(Start, End) && FParkourSurfaceDatabase::GetProbeFlags(Probe, SurfaceFlags);
+}
+
+void UParkourMassProbeProcessor::RunRequest(FParkourMassProbeRequest& Request) const
+{
+	EParkourSurfaceFlags SurfaceFlags;
+	if (Request.bFromDatabase && FParkourSurfaceDatabase::GetProbeFlags(Request.Probe, SurfaceFlags)) {
+		Request.bHit = ParkourSubsystem->GetSurfaceDatabase().Sweep(Request.Start, Request.End, Request.Radius, SurfaceFlags, Request.Hit);
+		return;
+	}
+
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ParkourMassProbe), false);
+	UWorld* World = ParkourSubsystem ? ParkourSubsystem->GetWorld() : GetWorld();
+	if (Request.Radius <= 0.0f) {
+		Request.bHit = World->LineTraceSingleByChannel(Request.Hit, Request.Start, Request.End, Request.Channel, QueryParams);
+	}
+	else {
+		Request.bHit = World->SweepSingleByChannel(Request.Hit, Request.Start, Request.End, FQuat::Identity, Request.Channel,
+			FCollisionShape::MakeCapsule(Request.Radius, Request.HalfHeight), QueryParams);
+	}
+}
+
+/************************************************************/
+/*----------------------- Movement -------------------------*/
+/************************************************************/
+
+UParkourMassMovementProcessor::UParkourMassMovementProcessor()
+{
+	bAutoRegisterWithProcessingPhases = true;
+	ExecutionFlags = (int32)EProcessorExecutionFlags::All;
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+}
+
+void UParkourMassMovementProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FParkourMassStateFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FParkourMassInputFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FParkourMassProbeFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FMassSimulationVariableTickFragment>(EMassFragmentAccess::ReadOnly, EMassFragmentPresence::Optional);
+	EntityQuery.AddConstSharedRequirement<FParkourMassSettingsFragment>(EMassFragmentPresence::All);
+	EntityQuery.AddTagRequirement<FParkourMassAgentTag>(EMassFragmentPresence::All);
+	EntityQuery.AddTagRequirement<FParkourMassActorDrivenTag>(EMassFragmentPresence::None);
+	EntityQuery.AddTagRequirement<FMassOffLODTag>(EMassFragmentPresence::None);
+	EntityQuery.AddChunkRequirement<FMassSimulationVariableTickChunkFragment>(EMassFragmentAccess::ReadOnly, EMassFragmentPresence::Optional);
+	EntityQuery.SetChunkFilter(&FMassSimulationVariableTickChunkFragment::ShouldTickChunkThisFrame);
+	EntityQuery.RegisterWithProcessor(*this);
+}
+
+void UParkourMassMovementProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParkourMassMovement);
+
+	const float GravityZ = GetWorld() ? GetWorld()->GetGravityZ() : -980.0f;
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [GravityZ](FMassExecutionContext& Context)
+	{
+		const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+		const TArrayView<FMassVelocityFragment> Velocities = Context.GetMutableFragmentView<FMassVelocityFragment>();
+		const TArrayView<FParkourMassStateFragment> States = Context.GetMutableFragmentView<FParkourMassStateFragment>();
+		const TArrayView<FParkourMassInputFragment> Inputs = Context.GetMutableFragmentView<FParkourMassInputFragment>();
+		const TConstArrayView<FParkourMassProbeFragment> Probes = Context.GetFragmentView<FParkourMassProbeFragment>();
+		const TConstArrayView<FMassSimulationVariableTickFragment> Ticks = Context.GetFragmentView<FMassSimulationVariableTickFragment>();
+		const FParkourMassSettingsFragment& Settings = Context.GetConstSharedFragment<FParkourMassSettingsFragment>();
+		const UParkourMovementSettings& Tuning = Settings.GetSettings();
+
+		// Chunks the Simulation LOD ticks less often carry the time since each entity's last tick
+		int32 NumTransitions = 0;
+		for (int32 Index = 0; Index < Context.GetNumEntities(); ++Index) {
+			const float DeltaTime = Ticks.Num() ? Ticks[Index].DeltaTime : Context.GetDeltaTimeSeconds();
+
+			ParkourMass::FRunner Runner(States[Index], Inputs[Index], Probes[Index], Settings, Tuning,
+				Transforms[Index].GetMutableTransform(), Velocities[Index].Value, DeltaTime, NumTransitions);
+			Runner.Update(GravityZ);
+		}
+
+		INC_DWORD_STAT_BY(STAT_ParkourMassRunners, Context.GetNumEntities());
+	});
+}
+
+/************************************************************/
+/*------------------------ Handoff -------------------------*/
+/************************************************************/
+
+UParkourMassActorHandoffProcessor::UParkourMassActorHandoffProcessor()
+{
+	bAutoRegisterWithProcessingPhases = true;
+	ExecutionFlags = (int32)EProcessorExecutionFlags::All;
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::SyncWorldToMass;
+	ExecutionOrder.ExecuteBefore.Add(UE::Mass::ProcessorGroupNames::Movement);
+
+	// Reads and writes the spawned characters
+	bRequiresGameThreadExecution = true;
+}
+
+void UParkourMassActorHandoffProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FMassActorFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FParkourMassStateFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddTagRequirement<FParkourMassAgentTag>(EMassFragmentPresence::All);
+	EntityQuery.RegisterWithProcessor(*this);
+}
+
+void UParkourMassActorHandoffProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParkourMassHandoff);
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [](FMassExecutionContext& Context)
+	{
+		const TArrayView<FMassActorFragment> Actors = Context.GetMutableFragmentView<FMassActorFragment>();
+		const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+		const TArrayView<FMassVelocityFragment> Velocities = Context.GetMutableFragmentView<FMassVelocityFragment>();
+		const TArrayView<FParkourMassStateFragment> States = Context.GetMutableFragmentView<FParkourMassStateFragment>();
+		const bool bActorDriven = Context.DoesArchetypeHaveTag<FParkourMassActorDrivenTag>();
+
+		for (int32 Index = 0; Index < Context.GetNumEntities(); ++Index) {
+			const ACharacter* Character = Cast<ACharacter>(Actors[Index].Get());
+			UParkourMovementComponent* Parkour = Character ? Character->FindComponentByClass<UParkourMovementComponent>() : nullptr;
+			const bool bHasComponent = Parkour && Parkour->Character && Parkour->CharacterMovementComponent;
+
+			if (bHasComponent && !bActorDriven) {
+				HandToActor(*Parkour, States[Index], Velocities[Index].Value);
+				Context.Defer().AddTag<FParkourMassActorDrivenTag>(Context.GetEntity(Index));
+				INC_DWORD_STAT(STAT_ParkourMassActorDriven);
+			}
+			else if (bHasComponent) {
+				TakeFromActor(*Parkour, States[Index], Transforms[Index].GetMutableTransform(), Velocities[Index].Value);
+			}
+			else if (bActorDriven) {
+				// The actor went back to the pool, the entity carries on from the last copy
+				Context.Defer().RemoveTag<FParkourMassActorDrivenTag>(Context.GetEntity(Index));
+				DEC_DWORD_STAT(STAT_ParkourMassActorDriven);
+			}
+		}
+	});
+}
+
+void UParkourMassActorHandoffProcessor::HandToActor(UParkourMovementComponent& Parkour, const FParkourMassStateFragment& State, const FVector& Velocity)
+{
+	UCharacterMovementComponent* Movement = Parkour.CharacterMovementComponent;
+
+	// Pooled characters come back in whatever mode they were released in
+	Parkour.SetParkourMovementMode(EParkourMovement::None);
+	Parkour.Runtime.WallRunNormal = State.WallNormal;
+	Parkour.Runtime.WallRunLocation = State.WallLocation;
+	Parkour.Runtime.VerticalWallRunNormal = State.WallNormal;
+	Parkour.Runtime.VerticalWallRunLocation = State.WallLocation;
+	Parkour.Runtime.LedgeClimbWallNormal = State.WallNormal;
+	Parkour.Runtime.LedgeClimbWallPosition = State.WallLocation;
+	Parkour.Runtime.LedgeFloorPosition = State.LedgeFloorPosition;
+	Parkour.Runtime.MantlePosition = State.MantlePosition;
+	Parkour.Runtime.MantleTraceDistance = State.MantleTraceDistance;
+	Parkour.Runtime.bSprintQueued = State.bSprintQueued;
+
+	// Going airborne opens the gates through MovementChanged, the entity's own gates then replace them
+	Movement->Velocity = Velocity;
+	Movement->SetMovementMode(State.bFalling ? MOVE_Falling : MOVE_Walking);
+	Parkour.SetGateMask(State.GateMask);
+
+	if (State.Mode == EParkourMovement::Mantle) {
+		// A mantle needs its root motion source, started from the ledge it was grabbed from
+		Parkour.SetParkourMovementMode(EParkourMovement::LedgeGrab);
+		Parkour.MantleStart();
+	}
+	else {
+		Parkour.SetParkourMovementMode(State.Mode);
+	}
+	Parkour.Runtime.bIsWallRunGravity = State.bWallRunGravity;
+
+	for (uint8 Timer = 0; Timer < (uint8)EParkourTimer::Count; ++Timer) {
+		Parkour.ArmTimer((EParkourTimer)Timer, State.Timers[Timer]);
+	}
+}
+
+void UParkourMassActorHandoffProcessor::TakeFromActor(const UParkourMovementComponent& Parkour, FParkourMassStateFragment& State, FTransform& Transform, FVector& Velocity)
+{
+	const UCharacterMovementComponent* Movement = Parkour.CharacterMovementComponent;
+	const FParkourRuntimeState& Runtime = Parkour.Runtime;
+
+	State.Mode = Runtime.GetCurrentMode();
+	State.GateMask = Runtime.GateMask;
+	State.bFalling = Movement->IsFalling();
+	State.bSprintQueued = Runtime.bSprintQueued;
+	State.bWallRunGravity = Runtime.bIsWallRunGravity;
+	State.GravityScale = Movement->GravityScale;
+
+	const bool bWallRunning = ParkourRules::IsWallRunning(State.Mode);
+	State.WallNormal = bWallRunning ? Runtime.WallRunNormal : Runtime.VerticalWallRunNormal;
+	State.WallLocation = bWallRunning ? Runtime.WallRunLocation : Runtime.VerticalWallRunLocation;
+	State.LedgeFloorPosition = Runtime.LedgeFloorPosition;
+	State.MantlePosition = Runtime.MantlePosition;
+	State.MantleTraceDistance = Runtime.MantleTraceDistance;
+
+	const double Now = Parkour.GetWorld()->GetTimeSeconds();
+	for (uint8 Timer = 0; Timer < (uint8)EParkourTimer::Count; ++Timer) {
+		const bool bArmed = (Parkour.ArmedTimers & (1 << Timer)) != 0;
+		State.Timers[Timer] = bArmed ? FMath::Max((float)(Parkour.TimerDeadlines[Timer] - Now), KINDA_SMALL_NUMBER) : 0.0f;
+	}
+
+	Transform = Parkour.Character->GetActorTransform();
+	Velocity = Movement->Velocity;
+}
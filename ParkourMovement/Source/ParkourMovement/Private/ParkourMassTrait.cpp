@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourMassTrait.h"
+#include "MassCommonFragments.h"
+#include "MassEntityTemplateRegistry.h"
+#include "MassEntityUtils.h"
+#include "MassMovementFragments.h"
+
+void UParkourMassTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+	FMassEntityManager& EntityManager = UE::Mass::Utils::GetEntityManagerChecked(World);
+
+	BuildContext.AddTag<FParkourMassAgentTag>();
+
+	BuildContext.AddFragment<FTransformFragment>();
+	BuildContext.AddFragment<FMassVelocityFragment>();
+	BuildContext.AddFragment<FParkourMassStateFragment>();
+	BuildContext.AddFragment<FParkourMassInputFragment>();
+	BuildContext.AddFragment<FParkourMassProbeFragment>();
+
+	// Entities with equal settings share one copy
+	const uint32 SettingsHash = UE::StructUtils::GetStructCrc32(FConstStructView::Make(Settings));
+	const FConstSharedStruct SharedSettings = EntityManager.GetOrCreateConstSharedFragment(SettingsHash, Settings);
+	BuildContext.AddConstSharedFragment(SharedSettings);
+}
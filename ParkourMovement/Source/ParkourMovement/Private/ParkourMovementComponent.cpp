@@ -2,11 +2,177 @@
 
 
 #include "ParkourMovementComponent.h"
+#include "ParkourMovementWorldSubsystem.h"
+#include "ParkourCharacterMovementComponent.h"
+#include "ParkourCameraModifier.h"
 #include "Components/CapsuleComponent.h"
+#include "GameFramework/PlayerController.h"
 #include "Math/Color.h"
 #include "Engine/World.h"
+#include "GameFramework/RootMotionSource.h"
+#include "UObject/UObjectIterator.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "ParkourMovement/ParkourMovement.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Async Probe Mismatches"), STAT_ParkourAsyncProbeMismatches, STATGROUP_ParkourMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Async Probes Late By Over A Frame"), STAT_ParkourAsyncProbeLate, STATGROUP_ParkourMovement);
+
+DECLARE_CYCLE_STAT(TEXT("Update Sequence"), STAT_ParkourUpdateSequence, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Wall Run Gate"), STAT_ParkourWallRunGate, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Vertical Wall Run Gate"), STAT_ParkourVerticalWallRunGate, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Mantle Check Gate"), STAT_ParkourMantleCheckGate, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Mantle Gate"), STAT_ParkourMantleGate, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Slide Gate"), STAT_ParkourSlideGate, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Sprint Gate"), STAT_ParkourSprintGate, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Wall Run Movement"), STAT_ParkourWallRunMovement, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Forward Tracer"), STAT_ParkourForwardTracer, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Get Slide Vector"), STAT_ParkourGetSlideVector, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Mantle Movement"), STAT_ParkourMantleMovement, STATGROUP_ParkourMovement);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scene Queries"), STAT_ParkourSceneQueries, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scene Queries TraceTypeQuery3"), STAT_ParkourSceneQueriesTraceType3, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scene Queries TraceTypeQuery4"), STAT_ParkourSceneQueriesTraceType4, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scene Queries TraceTypeQuery5"), STAT_ParkourSceneQueriesTraceType5, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scene Queries Visibility"), STAT_ParkourSceneQueriesVisibility, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mode Transitions"), STAT_ParkourModeTransitions, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Timers Armed"), STAT_ParkourTimersArmed, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Root Motion Moves Started"), STAT_ParkourRootMotionMoves, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Agents at High Significance"), STAT_ParkourHighSignificanceAgents, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Agents at Medium Significance"), STAT_ParkourMediumSignificanceAgents, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Agents at Low Significance"), STAT_ParkourLowSignificanceAgents, STATGROUP_ParkourMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant Agents"), STAT_ParkourDormantAgents, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Update Heap Allocations"), STAT_ParkourUpdateAllocations, STATGROUP_ParkourMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Net Replicated State Bits"), STAT_ParkourNetStateBits, STATGROUP_ParkourMovement);
+
+// Times a scope in both 'stat ParkourMovement' and the ParkourMovement CSV category
+#define PARKOUR_SCOPE_CYCLE_COUNTER(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_Parkour##Name); \
+	CSV_SCOPED_TIMING_STAT(ParkourMovement, Name)
+
+// Counts in both 'stat ParkourMovement' and the ParkourMovement CSV category
+#define PARKOUR_INC_COUNTER(Name) \
+	INC_DWORD_STAT(STAT_Parkour##Name); \
+	CSV_CUSTOM_STAT(ParkourMovement, Name, 1, ECsvCustomStatOp::Accumulate)
+
+static void CountSceneQuery(ECollisionChannel Channel)
+{
+	PARKOUR_INC_COUNTER(SceneQueries);
+	++GParkourCounters.SceneQueries;
+
+	// Trace types first, the project may map one of them onto Visibility
+	if (Channel == UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery3)) {
+		PARKOUR_INC_COUNTER(SceneQueriesTraceType3);
+	}
+	else if (Channel == UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery4)) {
+		PARKOUR_INC_COUNTER(SceneQueriesTraceType4);
+	}
+	else if (Channel == UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery5)) {
+		PARKOUR_INC_COUNTER(SceneQueriesTraceType5);
+	}
+	else if (Channel == ECC_Visibility) {
+		PARKOUR_INC_COUNTER(SceneQueriesVisibility);
+	}
+}
+
+// Heap allocations made so far by every thread. The allocators only count them outside shipping builds.
+static uint64 CountHeapAllocations()
+{
+#if !UE_BUILD_SHIPPING
+	return FMalloc::TotalMallocCalls + FMalloc::TotalReallocCalls;
+#else
+	return 0;
+#endif
+}
+
+static TAutoConsoleVariable<bool> CVarParkourCompareAsyncQueries(
+	TEXT("Parkour.CompareAsyncQueries"),
+	false,
+	TEXT("When async scene queries are enabled, also run every probe synchronously and count the frames the two disagree.\n")
+	TEXT("A probe that disagrees for more than one frame in a row is logged, since its transition would land late."),
+	ECVF_Cheat);
+
+static const FName ParkourSnapMoveName(TEXT("ParkourSnap"));
+static const FName ParkourMantleMoveName(TEXT("ParkourMantle"));
+
+// Seconds a ledge snap or wall correction takes, the same as the latent moves they replaced
+static constexpr float ParkourSnapTime = 0.1f;
+
+static TAutoConsoleVariable<int32> CVarParkourForceSignificance(
+	TEXT("Parkour.ForceSignificance"),
+	-1,
+	TEXT("Puts every parkour character in one significance bucket, 0 High, 1 Medium, 2 Low. -1 scores them as usual."),
+	ECVF_Cheat);
+
+static FAutoConsoleCommandWithWorld ParkourMemReportCommand(
+	TEXT("Parkour.MemReport"),
+	TEXT("Logs the size of a parkour component and its runtime state, and the memory the world's components and their settings assets use ")
+	TEXT("as the engine counts it, including what each component has allocated."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		int32 NumComponents = 0;
+		SIZE_T TotalBytes = 0;
+		SIZE_T MinBytes = TNumericLimits<SIZE_T>::Max();
+		SIZE_T MaxBytes = 0;
+		TSet<UParkourMovementSettings*> SettingsAssets;
+		for (TObjectIterator<UParkourMovementComponent> It; It; ++It) {
+			if ((It->GetWorld() != World) || It->IsTemplate()) {
+				continue;
+			}
+
+			const SIZE_T Bytes = It->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+			++NumComponents;
+			TotalBytes += Bytes;
+			MinBytes = FMath::Min(MinBytes, Bytes);
+			MaxBytes = FMath::Max(MaxBytes, Bytes);
+			SettingsAssets.Add(const_cast<UParkourMovementSettings*>(&It->GetSettings()));
+		}
+
+		SIZE_T SettingsBytes = 0;
+		for (UParkourMovementSettings* Settings : SettingsAssets) {
+			SettingsBytes += Settings->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("Parkour Mem Report: sizeof component %d bytes, runtime state %d bytes, settings %d bytes."),
+			(int32)sizeof(UParkourMovementComponent), (int32)sizeof(FParkourRuntimeState), (int32)sizeof(UParkourMovementSettings));
+		if (NumComponents > 0) {
+			UE_LOG(LogTemp, Display, TEXT("Parkour Mem Report: %d components, %.1f KB, %llu to %llu bytes each (%.0f mean)."),
+				NumComponents, TotalBytes / 1024.0, (uint64)MinBytes, (uint64)MaxBytes, (double)TotalBytes / NumComponents);
+		}
+		UE_LOG(LogTemp, Display, TEXT("Parkour Mem Report: %d settings assets shared, %.1f KB."), SettingsAssets.Num(), SettingsBytes / 1024.0);
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice ParkourDumpTransitionsCommand(
+	TEXT("Parkour.DumpTransitions"),
+	TEXT("Logs the parkour transition table and how often every parkour component in the world has made each mode change."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		FParkourTransitionTable::DumpTable(Ar);
+
+		const UEnum* ModeEnum = StaticEnum<EParkourMovement>();
+		uint64 Counts[NumParkourModes][NumParkourModes] = {};
+		int32 NumComponents = 0;
+		for (TObjectIterator<UParkourMovementComponent> It; It; ++It) {
+			if (It->GetWorld() == World) {
+				++NumComponents;
+				for (int32 From = 0; From < NumParkourModes; ++From) {
+					for (int32 To = 0; To < NumParkourModes; ++To) {
+						Counts[From][To] += It->GetTransitionCount((EParkourMovement)From, (EParkourMovement)To);
+					}
+				}
+			}
+		}
+
+		Ar.Logf(TEXT("Parkour transitions made by %d components:"), NumComponents);
+		for (int32 From = 0; From < NumParkourModes; ++From) {
+			for (int32 To = 0; To < NumParkourModes; ++To) {
+				if (Counts[From][To] > 0) {
+					Ar.Logf(TEXT("  %-16s -> %-16s %llu"), *ModeEnum->GetNameStringByValue(From), *ModeEnum->GetNameStringByValue(To), Counts[From][To]);
+				}
+			}
+		}
+	}));
+
 /************************************************************/
 /*------------------ Initial Set Up ------------------------*/
 /************************************************************/
@@ -14,30 +180,20 @@
 // Sets default values for this component's properties
 UParkourMovementComponent::UParkourMovementComponent()
 {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = false;
-
-	// ...
-	// Initialize Character, CharacterMovement Component, and the Previous and Current Parkour modes
-
-	PreviousParkourMode = EParkourMovement::None;
-	CurrentParkourMode = EParkourMovement::None;
+	// The parkour update runs from the component tick at a fixed step. Ticking starts once Initialize has a character,
+	// and runs after physics so it sees the same movement results the old timer update did.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
 
-	// Main Event Delegates
-	this->OnMovementChanged.AddDynamic(this, &UParkourMovementComponent::MovementChanged);
-	this->OnParkourChanged.AddDynamic(this, &UParkourMovementComponent::ParkourMovementChanged);
-	this->OnJumpEvent.AddDynamic(this, &UParkourMovementComponent::Jump);
-	//this->OnCameraShakeEvent.AddDynamic(this, &UParkourMovementComponent::PlayCameraShake);
-	this->OnLandEvent.AddDynamic(this, &UParkourMovementComponent::Land);
-	this->OnSprintEvent.AddDynamic(this, &UParkourMovementComponent::Sprint);
-	this->OnQueuesCheckEvent.AddDynamic(this, &UParkourMovementComponent::CheckQueues);
-	this->OnCrouchSlideEvent.AddDynamic(this, &UParkourMovementComponent::CrouchSlide);
+	// The mode, wall and target go to simulated proxies, see ReplicatedState
+	SetIsReplicatedByDefault(true);
 
+	// ...
+	// Initialize Character, CharacterMovement Component. Both parkour modes start at None in Runtime.
 
-	// In Program Events
-	this->OnWallRunEnd.AddDynamic(this, &UParkourMovementComponent::WallRunEnd);
-	this->OnUpdateEvent.AddDynamic(this, &UParkourMovementComponent::UpdateSequence);
+	// The component calls its own events natively. The Blueprint dispatchers are only raised for listeners,
+	// from the queue flushed at the end of each frame's update.
 
 	/*
 	// JumpLand Camera Shake Set Up, All Oscillation 0.25,0.1,0.2, RotOscillation Pitch Amp -50, Freq 1, Initial OffsetZero
@@ -68,10 +224,260 @@ void UParkourMovementComponent::BeginPlay()
 	// ...
 }
 
+// Called when the game ends or the component is destroyed
+void UParkourMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if ((BatchedUpdateIndex != INDEX_NONE) && ParkourSubsystem) {
+		ParkourSubsystem->UnregisterComponent(this);
+	}
+
+	if ((AsyncForceId != INDEX_NONE) && ParkourSubsystem) {
+		ParkourSubsystem->UnregisterAsyncForces(this);
+	}
+
+	if (bDormant) {
+		DEC_DWORD_STAT(STAT_ParkourDormantAgents);
+		bDormant = false;
+	}
+
+	StopRecording();
+	StopPlayback();
+
+	if (Character) {
+		Character->ReceiveControllerChangedDelegate.RemoveDynamic(this, &UParkourMovementComponent::OnControllerChanged);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UParkourMovementComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Recorder.GetAllocatedSize() + Player.GetAllocatedSize());
+}
+
 // Called every frame
 void UParkourMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateSignificance();
+
+	if (IsUpdatedByMovement()) {
+		return;
+	}
+
+	if (IsSimulatedProxy()) {
+		SimulateProxy(DeltaTime);
+		FlushEvents();
+		PublishAnimSnapshot();
+		TryGoDormant();
+		return;
+	}
+
+	const int32 NumSteps = ConsumeFixedSteps(DeltaTime);
+	for (int32 Step = 0; Step < NumSteps; ++Step) {
+		UpdateEventMethod();
+	}
+	ApplyDeferredLaunch();
+
+	RunDueTimers();
+	FlushEvents();
+	PublishAnimSnapshot();
+	UpdateReplicatedState();
+	TryGoDormant();
+}
+
+int32 UParkourMovementComponent::ConsumeFixedSteps(float DeltaTime)
+{
+	UpdateAccumulator += DeltaTime;
+
+	const float StepTime = GetStepTime();
+	int32 NumSteps = FMath::FloorToInt(UpdateAccumulator / StepTime);
+	if (NumSteps > MaxSubSteps) {
+		// Drop the time we can't catch up on, keeping only the partial step.
+		NumSteps = MaxSubSteps;
+		UpdateAccumulator = FMath::Fmod(UpdateAccumulator, StepTime);
+	}
+	else {
+		UpdateAccumulator -= NumSteps * StepTime;
+	}
+
+	return NumSteps;
+}
+
+void UParkourMovementComponent::LaunchCharacter(const FVector& Velocity, bool bXYOverride, bool bZOverride)
+{
+	if (!bDeferLaunches) {
+		Character->LaunchCharacter(Velocity, bXYOverride, bZOverride);
+		return;
+	}
+
+	// A later step's launch replaces an earlier one, as it would have on the character
+	DeferredLaunch.Velocity = Velocity;
+	DeferredLaunch.bXYOverride = bXYOverride;
+	DeferredLaunch.bZOverride = bZOverride;
+	DeferredLaunch.bPending = true;
+}
+
+void UParkourMovementComponent::ApplyDeferredLaunch()
+{
+	if (DeferredLaunch.bPending) {
+		DeferredLaunch.bPending = false;
+		Character->LaunchCharacter(DeferredLaunch.Velocity, DeferredLaunch.bXYOverride, DeferredLaunch.bZOverride);
+	}
+}
+
+bool UParkourMovementComponent::UsesAsyncPhysicsForces() const
+{
+	return (AsyncForceId != INDEX_NONE) && !IsUpdatedByMovement() && !IsRecording() && !IsPlayingBack();
+}
+
+float UParkourMovementComponent::GetStepTime() const
+{
+	return FixedTimeStep * GetSignificanceBucket().StepMultiplier;
+}
+
+void UParkourMovementComponent::SetUpdateEnabled(bool bEnabled)
+{
+	if (bUseBatchedUpdate && ParkourSubsystem) {
+		if (bEnabled) {
+			ParkourSubsystem->RegisterComponent(this);
+		}
+		else {
+			ParkourSubsystem->UnregisterComponent(this);
+		}
+	}
+	else {
+		SetComponentTickEnabled(bEnabled);
+	}
+}
+
+/************************************************************/
+/*----------------------- Dormancy -------------------------*/
+/************************************************************/
+
+bool UParkourMovementComponent::CanGoDormant() const
+{
+	// Predicted characters run the update from their moves, which the server has to mirror step for step
+	if (!bAllowDormancy || !Character || !CharacterMovementComponent || IsUpdatedByMovement()) {
+		return false;
+	}
+
+	// A recording or playback is step for step too
+	if (Recorder.IsRecording() || Player.IsPlaying()) {
+		return false;
+	}
+
+	// A simulated proxy's gates are never used, only a replicated mode change moves it
+	if (IsSimulatedProxy()) {
+		return (Runtime.GetCurrentMode() == EParkourMovement::None) && PendingEvents.IsEmpty();
+	}
+
+	return (Runtime.GetCurrentMode() == EParkourMovement::None) && CharacterMovementComponent->IsWalking() && (GetGateMask() == 0) && (ArmedTimers == 0)
+		&& !Runtime.bSlideQueued && !Runtime.bSprintQueued && (PendingPresses == EParkourPress::None) && PendingEvents.IsEmpty();
+}
+
+void UParkourMovementComponent::TryGoDormant()
+{
+	if (bDormant || !CanGoDormant()) {
+		return;
+	}
+
+	bDormant = true;
+	INC_DWORD_STAT(STAT_ParkourDormantAgents);
+
+	SetUpdateEnabled(false);
+}
+
+void UParkourMovementComponent::WakeUp()
+{
+	if (!bDormant) {
+		return;
+	}
+
+	bDormant = false;
+	DEC_DWORD_STAT(STAT_ParkourDormantAgents);
+
+	// Time spent asleep isn't caught up on
+	UpdateAccumulator = 0.0f;
+	SetUpdateEnabled(true);
+}
+
+/************************************************************/
+/*--------------------- Significance -----------------------*/
+/************************************************************/
+
+const FParkourSignificanceBucket& UParkourMovementComponent::GetSignificanceBucket() const
+{
+	switch (Significance) {
+	case EParkourSignificance::Medium: return GetSettings().MediumSignificance;
+	case EParkourSignificance::Low: return GetSettings().LowSignificance;
+	default: return GetSettings().HighSignificance;
+	}
+}
+
+void UParkourMovementComponent::UpdateSignificance()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (Now >= NextSignificanceTime) {
+		Significance = ScoreSignificance();
+		NextSignificanceTime = Now + GetSettings().SignificanceInterval;
+	}
+
+	switch (Significance) {
+	case EParkourSignificance::High: PARKOUR_INC_COUNTER(HighSignificanceAgents);
+		break;
+	case EParkourSignificance::Medium: PARKOUR_INC_COUNTER(MediumSignificanceAgents);
+		break;
+	case EParkourSignificance::Low: PARKOUR_INC_COUNTER(LowSignificanceAgents);
+		break;
+	}
+}
+
+EParkourSignificance UParkourMovementComponent::ScoreSignificance() const
+{
+	// Predicted moves have to run the same update on the client and the server, and recordings are made
+	// and played back one FixedTimeStep at a time
+	if (IsUpdatedByMovement() || Recorder.IsRecording() || Player.IsPlaying()) {
+		return EParkourSignificance::High;
+	}
+
+	const int32 Forced = CVarParkourForceSignificance.GetValueOnGameThread();
+	if (Forced >= 0) {
+		return (EParkourSignificance)FMath::Min(Forced, (int32)EParkourSignificance::Low);
+	}
+
+	if (!Character || !ParkourSubsystem || (Character->IsPlayerControlled() && Character->IsLocallyControlled())) {
+		return EParkourSignificance::High;
+	}
+
+	const TArray<FVector>& Viewpoints = ParkourSubsystem->GetViewpoints();
+	if (Viewpoints.Num() == 0) {
+		return EParkourSignificance::High;
+	}
+
+	const FVector Location = Character->GetActorLocation();
+	double ClosestDistanceSquared = TNumericLimits<double>::Max();
+	for (const FVector& Viewpoint : Viewpoints) {
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(Location, Viewpoint));
+	}
+
+	int32 Bucket = (int32)EParkourSignificance::High;
+	if (ClosestDistanceSquared > FMath::Square(GetSettings().HighSignificance.MaxDistance)) {
+		Bucket = (int32)EParkourSignificance::Medium;
+	}
+	if (ClosestDistanceSquared > FMath::Square(GetSettings().MediumSignificance.MaxDistance)) {
+		Bucket = (int32)EParkourSignificance::Low;
+	}
+
+	// Behind a wall or off screen. A dedicated server renders nothing, so there it is distance only.
+	if ((GetNetMode() != NM_DedicatedServer) && !Character->WasRecentlyRendered(0.5f)) {
+		Bucket = FMath::Min(Bucket + 1, (int32)EParkourSignificance::Low);
+	}
+
+	return (EParkourSignificance)Bucket;
 }
 
 /************************************************************/
@@ -80,7 +486,9 @@ void UParkourMovementComponent::TickComponent(float DeltaTime, ELevelTick TickTy
 
 void UParkourMovementComponent::Land()
 {
-	EndEvents();
+	QueueEvent(EParkourEventFlags::Land);
+
+	FireTrigger(EParkourTrigger::Land);
 	CloseGates();
 	// Broadcast Land Camera Shake
 	//OnCameraShakeEvent.Broadcast(JumpLandCamera);
@@ -88,44 +496,50 @@ void UParkourMovementComponent::Land()
 
 void UParkourMovementComponent::Jump()
 {
-	// If No Current Parkour Mode is used, check if the character is falling.
-	if (CurrentParkourMode == EParkourMovement::None) {
-		// If Not falling, Call OpenGates and then the PlayCameraShake Event
-		if (!CharacterMovementComponent->IsFalling()) {
-			OpenGates();
-			// Broadcast Jump Camera Shake
-			//OnCameraShakeEvent.Broadcast();
-		}
-	}
-	else {
-		// If in a Current Parkour Mode, go through the sequence of Jump Events.
-		JumpEvent();
+	if (IsIgnoringLiveInput() || DeferPress(EParkourPress::Jump)) {
+		return;
 	}
+	WakeUp();
+	RecordEvent(EParkourRecordedEvent::Jump);
+
+	QueueEvent(EParkourEventFlags::Jump);
+
+	// Jumping off the ground opens the gates, any parkour mode jumps out of itself
+	FireTrigger(EParkourTrigger::Jump);
 }
 
 void UParkourMovementComponent::PlayCameraShake(TSubclassOf<UCameraShakeBase> Camera)
 {
+	if (!Character || (GetNetMode() == NM_DedicatedServer) || !GetSettings().bCameraShake || !GetSignificanceBucket().bCosmetics) {
+		return;
+	}
 
-	if (CameraShake) {
-		// Play World Camera Shake with the Shake Camera Selected, Epicenter of Character Location
-		// Inner Radius of 0, Outer Radius of 100, Falloff at 1, and No Orient Shake Towards Epicenter
-		UGameplayStatics::PlayWorldCameraShake(this, Camera, Character->GetActorLocation(), 0.f, 100.f, 1.0f, false);
+	// Only the player's own camera shakes, the other players' cameras are left alone
+	if (UParkourCameraModifier* CameraModifier = UParkourCameraModifier::FindOn(Cast<APlayerController>(Character->GetController()))) {
+		CameraModifier->PlayShake(Camera);
 	}
 }
 
 void UParkourMovementComponent::CrouchSlide()
 {
+	if (IsIgnoringLiveInput() || DeferPress(EParkourPress::CrouchSlide)) {
+		return;
+	}
+	WakeUp();
+	RecordEvent(EParkourRecordedEvent::CrouchSlide);
+
+	QueueEvent(EParkourEventFlags::CrouchSlide);
+
 	if (CancelMovement()) {
-		FString message = "Parkour Movement Component_CrouchSlide: Cancel Movement Returned True.";
-		UE_LOG(LogTemp, Warning, TEXT("%s"), *message);
+		UE_LOG(LogTemp, Verbose, TEXT("Parkour Movement Component_CrouchSlide: Cancel Movement Returned True."));
 	}
 	else {
-		if (MacroCanSlide()) {
+		if (CanSlide()) {
 			if (CharacterMovementComponent->IsWalking()) {
 				SlideStart();
 			}
 			else {
-				SlideQueued = true;
+				Runtime.bSlideQueued = true;
 			}
 		}
 		else {
@@ -136,19 +550,24 @@ void UParkourMovementComponent::CrouchSlide()
 
 void UParkourMovementComponent::CheckQueues()
 {
-	if (SlideQueued) {
+	QueueEvent(EParkourEventFlags::QueuesCheck);
+
+	if (Runtime.bSlideQueued) {
 		SlideStart();
 	}
-	else if (SprintQueued) {
+	else if (Runtime.bSprintQueued) {
 		SprintStart();
 	}
 }
 
 void UParkourMovementComponent::MovementChanged(EMovementMode PrevMovementMode, EMovementMode NewMovementMode)
 {
-	if (IsValid(CharacterMovementComponent)) {
-		PreviousMovementMode = PrevMovementMode;
-		CurrentMovementMode = NewMovementMode;
+	if (IsValid(CharacterMovementComponent) && !bSnapChangingMovementMode) {
+		WakeUp();
+		QueueMovementChanged(PrevMovementMode, NewMovementMode);
+
+		Runtime.PreviousMovementMode = PrevMovementMode;
+		Runtime.CurrentMovementMode = NewMovementMode;
 
 		OpenMovementGates();
 	}
@@ -156,37 +575,69 @@ void UParkourMovementComponent::MovementChanged(EMovementMode PrevMovementMode,
 
 void UParkourMovementComponent::ParkourMovementChanged(EParkourMovement PrevParkourMode, EParkourMovement NewParkourMode)
 {
-	PreviousParkourMode = PrevParkourMode;
-	CurrentParkourMode = NewParkourMode;
+	Runtime.SetModes(PrevParkourMode, NewParkourMode);
 
 	ResetMovement();
 }
 
 void UParkourMovementComponent::Sprint()
 {
+	if (IsIgnoringLiveInput() || DeferPress(EParkourPress::Sprint)) {
+		return;
+	}
+	WakeUp();
+	RecordEvent(EParkourRecordedEvent::Sprint);
+
+	QueueEvent(EParkourEventFlags::Sprint);
+
 	SprintStart();
 }
 
 bool UParkourMovementComponent::SetParkourMovementMode(EParkourMovement NewMode)
 {
-	bool results = false;
+	// A simulated proxy takes its mode from the server, see ApplyReplicatedState
+	if ((NewMode == Runtime.GetCurrentMode()) || IsSimulatedProxy()) {
+		return false;
+	}
+
+	WakeUp();
+
+	// Batched predicates were evaluated against the old mode
+	bHasBatchedPredicates = false;
+
+	// A snap or mantle belongs to the mode that started it
+	StopRootMotionMoves();
 
-	if (NewMode == CurrentParkourMode) {
+	const EParkourMovement PrevMode = Runtime.GetCurrentMode();
+	++TransitionCounts[(uint8)PrevMode][(uint8)NewMode];
+	PARKOUR_INC_COUNTER(ModeTransitions);
+	++GParkourCounters.ModeTransitions;
 
+	FParkourComponentTransitionTarget Target(*this);
+	FParkourTransitionTable::RunExit(Target, PrevMode);
+
+	Runtime.SetModes(PrevMode, NewMode);
+	ModeEnterTime = GetWorld()->GetTimeSeconds();
+
+	FParkourTransitionTable::RunEnter(Target, NewMode);
+
+	if (Recorder.IsRecording() && !IsReplayingMove()) {
+		Recorder.RecordTransition((uint8)PrevMode, (uint8)NewMode, Character->GetActorLocation(), CharacterMovementComponent->Velocity);
 	}
-	else {
-		// Call Event Dispatcher to change Current Parkour Mode to New Parkour Mode
-		OnParkourChanged.Broadcast(CurrentParkourMode, NewMode);
-		results = true;
+	if (Player.IsPlaying()) {
+		++PlaybackTransitions;
 	}
-	return results;
+
+	OnParkourModeChangedNative.Broadcast(PrevMode, NewMode);
+	QueueParkourChanged(PrevMode, NewMode);
+	return true;
 }
 
 void UParkourMovementComponent::ResetMovement()
 {
 	//if (GEngine) { GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Yellow, TEXT("Reset Movement Called")); }
 
-	if ((CurrentParkourMode == EParkourMovement::None) || (CurrentParkourMode == EParkourMovement::Crouch)) {
+	if ((Runtime.GetCurrentMode() == EParkourMovement::None) || (Runtime.GetCurrentMode() == EParkourMovement::Crouch)) {
 		CharacterMovementComponent->bOrientRotationToMovement = true;
 		Character->bUseControllerRotationYaw = DefaultUseControllerRotationYaw;
 		CharacterMovementComponent->GravityScale = DefaultGravity;
@@ -198,7 +649,7 @@ void UParkourMovementComponent::ResetMovement()
 
 		TEnumAsByte<EMovementMode> NewMode;
 
-		switch (PreviousParkourMode) {
+		switch (Runtime.GetPreviousMode()) {
 		case EParkourMovement::None: NewMode = EMovementMode::MOVE_Walking;
 			break;
 		case EParkourMovement::LeftWallRun: NewMode = EMovementMode::MOVE_Falling;
@@ -221,40 +672,25 @@ void UParkourMovementComponent::ResetMovement()
 		CharacterMovementComponent->SetMovementMode(NewMode, 0);
 	}
 	else {
-		CharacterMovementComponent->bOrientRotationToMovement = (CurrentParkourMode == EParkourMovement::Sprint);
+		CharacterMovementComponent->bOrientRotationToMovement = (Runtime.GetCurrentMode() == EParkourMovement::Sprint);
 
-		Character->bUseControllerRotationYaw = ((CurrentParkourMode == EParkourMovement::Sprint) && DefaultUseControllerRotationYaw);
+		Character->bUseControllerRotationYaw = ((Runtime.GetCurrentMode() == EParkourMovement::Sprint) && DefaultUseControllerRotationYaw);
 	}
 }
 
 bool UParkourMovementComponent::CancelMovement()
 {
-	bool Results = true;
-
-	if ((CurrentParkourMode == EParkourMovement::LedgeGrab) || (CurrentParkourMode == EParkourMovement::VerticalWallRun) || (CurrentParkourMode == EParkourMovement::Mantle)) {
-		VerticalWallRunEnd(0.5);
-	}
-	else if (MacroWallRunning()) {
-		WallRunEnd(0.5);
-	}
-	else {
-		Results = false;
-	}
-
-	return Results;
+	return FireTrigger(EParkourTrigger::Cancel);
 }
 
 bool UParkourMovementComponent::ForwardTracer(FHitResult& OutResult)
 {
-	FHitResult HitResult;
-	FVector EndVector = (MacroMantleVectorsFeet() + (Character->GetActorForwardVector() * 50));
-	FLinearColor ColorOne = FLinearColor(0, 1, 0, 1);
-	FLinearColor ColorTwo = FLinearColor(1, 0, 0, 1);
+	PARKOUR_SCOPE_CYCLE_COUNTER(ForwardTracer);
 
-	UKismetSystemLibrary::CapsuleTraceSingle(Character->GetCapsuleComponent(), MacroMantleVectorsFeet(), EndVector, 10, 5, TraceTypeQuery3, false, ActorsToIgnore, EDrawDebugTrace::Type::None, HitResult, true, ColorTwo, ColorOne, 5);
-
-	if ((HitResult.Normal.Z >= -0.1) && HitResult.bBlockingHit) {
-		OutResult = HitResult;
+	FParkourComponentWorldQuery World(*this);
+	FParkourQueryHit Hit;
+	if (ParkourCore::FindClimbWall(World, MakeProbeOrigin(), Hit)) {
+		OutResult = World.GetLastHit();
 		return true;
 	}
 	return false;
@@ -262,7 +698,38 @@ bool UParkourMovementComponent::ForwardTracer(FHitResult& OutResult)
 
 void UParkourMovementComponent::UpdateEventMethod()
 {
-	OnUpdateEvent.Broadcast();
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const uint64 StartAllocations = CountHeapAllocations();
+	const uint64 StartTransitions = GParkourCounters.ModeTransitions;
+	TGuardValue<bool> DeferLaunches(bDeferLaunches, true);
+
+	if (Player.IsPlaying() && !FeedPlayback()) {
+		StopPlayback();
+	}
+
+	UpdateSequence();
+
+	// Entering a mode may start a root motion source, a step that stays in its mode should allocate nothing.
+	// The benchmark warns when one does, and the SteadyStateAllocations test fails.
+	const uint64 Allocations = CountHeapAllocations() - StartAllocations;
+	INC_DWORD_STAT_BY(STAT_ParkourUpdateAllocations, Allocations);
+	if (GParkourCounters.ModeTransitions == StartTransitions) {
+		++GParkourCounters.SteadyUpdates;
+		GParkourCounters.SteadyUpdateAllocations += Allocations;
+	}
+	GParkourCounters.UpdateCycles += FPlatformTime::Cycles64() - StartCycles;
+
+	if (Player.IsPlaying()) {
+		MaxPlaybackDrift = FMath::Max(MaxPlaybackDrift, FVector::Dist(Character->GetActorLocation(), PlaybackLocation));
+	}
+	else if (Recorder.IsRecording() && !IsReplayingMove()) {
+		Recorder.RecordStep(CharacterMovementComponent->GetLastInputVector(), Character->GetActorLocation(), CharacterMovementComponent->Velocity);
+	}
+
+	// Predicates from the subsystem only hold for the step they were gathered for.
+	bHasBatchedPredicates = false;
+
+	QueueEvent(EParkourEventFlags::Update);
 }
 
 // Initialize Event called using Initialize Broadcast
@@ -280,7 +747,367 @@ void UParkourMovementComponent::Initialize(ACharacter* PlayerCharacter)
 	DefaultMaxCrouchSpeed = CharacterMovementComponent->MaxWalkSpeedCrouched;
 	DefaultBrakingDeceleration = CharacterMovementComponent->BrakingDecelerationWalking;
 
-	GetWorld()->GetTimerManager().SetTimer(UpdateEventHandle, this, &UParkourMovementComponent::UpdateEventMethod, InitializeTime, true);
+	// A parkour movement component runs the update from the character's moves, so it is predicted and replayed
+	ParkourCharacterMovement = Cast<UParkourCharacterMovementComponent>(CharacterMovementComponent);
+	if (ParkourCharacterMovement) {
+		ParkourCharacterMovement->SetParkourComponent(this);
+	}
+
+	BuildProbeQueries();
+
+	// Start the fixed step update, either batched with every other parkour component in the world or on our own tick
+	UpdateAccumulator = 0.0f;
+
+	ParkourSubsystem = GetWorld()->GetSubsystem<UParkourMovementWorldSubsystem>();
+	SetUpdateEnabled(true);
+
+	if (bUseAsyncPhysicsForces && ParkourSubsystem) {
+		ParkourSubsystem->RegisterAsyncForces(this);
+	}
+
+	// Camera effects belong to whoever controls the character locally, a dedicated server has no camera
+	if (GetNetMode() != NM_DedicatedServer) {
+		PlayerCharacter->ReceiveControllerChangedDelegate.AddUniqueDynamic(this, &UParkourMovementComponent::OnControllerChanged);
+		AddCameraModifier();
+	}
+
+	// A state that arrived before the character was set up
+	ReplicationStartTime = GetWorld()->GetTimeSeconds();
+	if (IsSimulatedProxy()) {
+		ApplyReplicatedState();
+	}
+}
+
+/************************************************************/
+/*-------------------- Scene Queries -----------------------*/
+/************************************************************/
+
+void UParkourMovementComponent::BuildProbeQueries()
+{
+	const auto Build = [this](EParkourProbe Probe, FName StatName, ECollisionChannel Channel, const FCollisionShape& Shape)
+	{
+		FParkourProbeQuery& Query = ProbeQueries[(uint8)Probe];
+		Query.Channel = Channel;
+		Query.Shape = Shape;
+		Query.Params = FCollisionQueryParams(StatName, false, Character);
+		Query.DynamicParams = Query.Params;
+		Query.DynamicParams.MobilityType = EQueryMobilityType::Dynamic;
+		Query.IgnoredClass = Character->GetClass();
+	};
+
+	Build(EParkourProbe::WallRunRight, SCENE_QUERY_STAT(ParkourWallRunRight), ECC_Visibility, FCollisionShape::LineShape);
+	Build(EParkourProbe::WallRunLeft, SCENE_QUERY_STAT(ParkourWallRunLeft), ECC_Visibility, FCollisionShape::LineShape);
+	Build(EParkourProbe::LedgeFloor, SCENE_QUERY_STAT(ParkourLedgeFloor), UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery4), FCollisionShape::MakeCapsule(20.0f, 10.0f));
+	Build(EParkourProbe::LedgeWall, SCENE_QUERY_STAT(ParkourLedgeWall), UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery3), FCollisionShape::MakeCapsule(10.0f, 5.0f));
+	Build(EParkourProbe::LedgeGround, SCENE_QUERY_STAT(ParkourLedgeGround), UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery4), FCollisionShape::LineShape);
+	Build(EParkourProbe::SlideFloor, SCENE_QUERY_STAT(ParkourSlideFloor), UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery5), FCollisionShape::LineShape);
+}
+
+bool UParkourMovementComponent::TraceProbe(EParkourProbe Probe, const FVector& Start, const FVector& End, FHitResult& OutHit)
+{
+	const FCollisionShape& Shape = ProbeQueries[(uint8)Probe].Shape;
+
+	// The center line misses what only the capsule's edge would have hit, so its result stays out of the shared cache
+	if (!Shape.IsLine() && GetSignificanceBucket().bLineTraceProbes) {
+		return RunProbe(Probe, Start, End, FCollisionShape::LineShape, OutHit, false);
+	}
+
+	return RunProbe(Probe, Start, End, Shape, OutHit);
+}
+
+bool UParkourMovementComponent::RunProbe(EParkourProbe Probe, const FVector& Start, const FVector& End, const FCollisionShape& Shape, FHitResult& OutHit, bool bAddToCache)
+{
+	// Static geometry the level was baked with comes from the surface database, only movables need a live trace
+	EParkourSurfaceFlags SurfaceFlags;
+	if (ParkourSubsystem && ParkourSubsystem->GetSurfaceDatabase().Contains(Start, End) && FParkourSurfaceDatabase::GetProbeFlags(Probe, SurfaceFlags)) {
+		FHitResult StaticHit;
+		const bool bStaticHit = ParkourSubsystem->GetSurfaceDatabase().Sweep(Start, End, Shape.IsLine() ? 0.0f : Shape.GetExtent().GetMax(), SurfaceFlags, StaticHit);
+		const bool bDynamicHit = RunSyncProbe(Probe, Start, End, Shape, OutHit, true);
+
+		if (bStaticHit && (!bDynamicHit || (StaticHit.Time < OutHit.Time))) {
+			OutHit = StaticHit;
+		}
+		return bStaticHit || bDynamicHit;
+	}
+
+	FParkourProbeCache* ProbeCache = (bUseProbeCache && ParkourSubsystem) ? &ParkourSubsystem->GetProbeCache() : nullptr;
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	bool bHit = false;
+	const FParkourProbeQuery& Query = ProbeQueries[(uint8)Probe];
+	if (ProbeCache && ProbeCache->Find(Probe, Query, Shape, Start, End, Now, OutHit, bHit)) {
+		return bHit;
+	}
+
+	if (bUseAsyncSceneQueries) {
+		// Async results were traced from a predicted start, so they don't go into the cache
+		return RunAsyncProbe(Probe, Start, End, Shape, OutHit);
+	}
+
+	bHit = RunSyncProbe(Probe, Start, End, Shape, OutHit);
+	if (ProbeCache && bAddToCache) {
+		ProbeCache->Add(Probe, Query, Shape, Start, End, Now, OutHit, bHit);
+	}
+	return bHit;
+}
+
+bool UParkourMovementComponent::RunSyncProbe(EParkourProbe Probe, const FVector& Start, const FVector& End, const FCollisionShape& Shape, FHitResult& OutHit, bool bDynamicOnly)
+{
+	const FParkourProbeQuery& Query = ProbeQueries[(uint8)Probe];
+	const FCollisionQueryParams& QueryParams = bDynamicOnly ? Query.DynamicParams : Query.Params;
+
+	CountSceneQuery(Query.Channel);
+
+	if (Shape.IsLine()) {
+		return GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, Query.Channel, QueryParams);
+	}
+	return GetWorld()->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, Query.Channel, Shape, QueryParams);
+}
+
+bool UParkourMovementComponent::RunAsyncProbe(EParkourProbe Probe, const FVector& Start, const FVector& End, const FCollisionShape& Shape, FHitResult& OutHit)
+{
+	UWorld* World = GetWorld();
+	FParkourProbeSlot& Slot = ProbeSlots[(uint8)Probe];
+
+	// Async results are ready from the frame after they were requested, and are kept once read. The world only
+	// holds them for that one frame, a probe that wasn't run then loses its request.
+	if (Slot.PendingHandle.IsValid() && (Slot.SubmitFrame != GFrameCounter)) {
+		FTraceDatum TraceData;
+		if (World->QueryTraceData(Slot.PendingHandle, TraceData)) {
+			Slot.bResultBlockingHit = (TraceData.OutHits.Num() > 0) && TraceData.OutHits[0].bBlockingHit;
+			Slot.Result = Slot.bResultBlockingHit ? TraceData.OutHits[0] : FHitResult();
+			Slot.bHasResult = true;
+			Slot.ResultFrame = Slot.SubmitFrame;
+		}
+		Slot.PendingHandle = FTraceHandle();
+	}
+
+	// Any result from an earlier frame, up to the age limit. One from this frame was traced for a step already run.
+	const uint64 ResultAge = GFrameCounter - Slot.ResultFrame;
+	const bool bUsable = Slot.bHasResult && (ResultAge > 0) && (ResultAge <= (uint64)MaxAsyncProbeAge);
+
+	bool bHit = false;
+	if (bUsable) {
+		OutHit = Slot.Result;
+		bHit = Slot.bResultBlockingHit;
+
+		if (CVarParkourCompareAsyncQueries.GetValueOnGameThread()) {
+			FHitResult SyncHit;
+			if (RunSyncProbe(Probe, Start, End, Shape, SyncHit) != bHit) {
+				INC_DWORD_STAT(STAT_ParkourAsyncProbeMismatches);
+				if (++Slot.MismatchFrames > 1) {
+					INC_DWORD_STAT(STAT_ParkourAsyncProbeLate);
+					UE_LOG(LogTemp, Warning, TEXT("Parkour Movement Component_RunAsyncProbe: Probe %d on %s disagreed with the sync trace for %d frames."), (int32)Probe, *GetNameSafe(Character), Slot.MismatchFrames);
+				}
+			}
+			else {
+				Slot.MismatchFrames = 0;
+			}
+		}
+	}
+	else {
+		// Nothing usable yet. The sync trace answers this step and stands in for the next frame's result, so no
+		// request goes out for it.
+		bHit = RunSyncProbe(Probe, Start, End, Shape, OutHit);
+
+		Slot.Result = OutHit;
+		Slot.bResultBlockingHit = bHit;
+		Slot.bHasResult = true;
+		Slot.ResultFrame = GFrameCounter;
+		return bHit;
+	}
+
+	// Request the next result from where the character will be a step from now, when it is first read.
+	if (!Slot.PendingHandle.IsValid()) {
+		const FParkourProbeQuery& Query = ProbeQueries[(uint8)Probe];
+		const FVector Compensation = CharacterMovementComponent->Velocity * GetStepTime();
+
+		CountSceneQuery(Query.Channel);
+
+		if (Shape.IsLine()) {
+			Slot.PendingHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start + Compensation, End + Compensation, Query.Channel, Query.Params);
+		}
+		else {
+			Slot.PendingHandle = World->AsyncSweepByChannel(EAsyncTraceType::Single, Start + Compensation, End + Compensation, FQuat::Identity, Query.Channel, Shape, Query.Params);
+		}
+		Slot.SubmitFrame = GFrameCounter;
+	}
+
+	return bHit;
+}
+
+FParkourProbeOrigin UParkourMovementComponent::MakeProbeOrigin() const
+{
+	FParkourProbeOrigin Origin;
+	Origin.Location = Character->GetActorLocation();
+	Origin.Forward = Character->GetActorForwardVector();
+	Origin.Right = Character->GetActorRightVector();
+	Origin.Up = Character->GetActorUpVector();
+	Origin.CapsuleHalfHeight = Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	Origin.MantleHeight = GetSettings().MantleHeight;
+
+	FRotator EyesRotation;
+	Character->GetController()->GetActorEyesViewPoint(Origin.Eyes, EyesRotation);
+	return Origin;
+}
+
+bool FParkourComponentWorldQuery::Trace(EParkourProbe Probe, const FVector& Start, const FVector& End, FParkourQueryHit& OutHit)
+{
+	LastHit = FHitResult();
+	OutHit.bBlockingHit = Component.TraceProbe(Probe, Start, End, LastHit) && LastHit.bBlockingHit;
+	OutHit.Location = LastHit.Location;
+	OutHit.ImpactPoint = LastHit.ImpactPoint;
+	OutHit.Normal = LastHit.Normal;
+	OutHit.ImpactNormal = LastHit.ImpactNormal;
+	OutHit.Distance = LastHit.Distance;
+	OutHit.bWalkable = OutHit.bBlockingHit && Component.CharacterMovementComponent->IsWalkable(LastHit);
+	return OutHit.bBlockingHit;
+}
+
+/************************************************************/
+/*------------------------ Timers --------------------------*/
+/************************************************************/
+
+void UParkourMovementComponent::ArmTimer(EParkourTimer Timer, float Delay)
+{
+	// Same as the timer manager, a timer set to zero or less is cleared rather than fired
+	if (Delay <= 0.0f) {
+		ClearTimer(Timer);
+		return;
+	}
+
+	PARKOUR_INC_COUNTER(TimersArmed);
+	WakeUp();
+
+	TimerDeadlines[(uint8)Timer] = GetStepWorldTime() + Delay;
+	ArmedTimers |= (1 << (uint8)Timer);
+}
+
+double UParkourMovementComponent::GetStepWorldTime() const
+{
+	return GetWorld()->GetTimeSeconds() - (IsReplayingMove() ? ReplayTimeOffset : 0.0);
+}
+
+void UParkourMovementComponent::ClearTimer(EParkourTimer Timer)
+{
+	ArmedTimers &= ~(1 << (uint8)Timer);
+}
+
+void UParkourMovementComponent::RunDueTimers()
+{
+	static_assert((uint8)EParkourTimer::Count <= 8, "ArmedTimers has a bit per timer");
+
+	static void (UParkourMovementComponent::* const Callbacks[])() = {
+		&UParkourMovementComponent::OpenWallRunGate,
+		&UParkourMovementComponent::WallRunEnableGravity,
+		&UParkourMovementComponent::OpenMantleCheckGate,
+		&UParkourMovementComponent::OpenVerticalWallRunGate,
+		&UParkourMovementComponent::CheckQueues,
+		&UParkourMovementComponent::OpenSprintGate,
+		&UParkourMovementComponent::VerticalWallRunEndEvent
+	};
+	static_assert(UE_ARRAY_COUNT(Callbacks) == (int32)EParkourTimer::Count, "A callback for every EParkourTimer");
+
+	if (!ArmedTimers || IsReplayingMove()) {
+		return;
+	}
+
+	// A callback can arm another timer, which is never due before the next frame
+	const double Now = GetWorld()->GetTimeSeconds();
+	while (true) {
+		int32 Next = INDEX_NONE;
+		for (int32 Index = 0; Index < (int32)EParkourTimer::Count; ++Index) {
+			if ((ArmedTimers & (1 << Index)) && (TimerDeadlines[Index] <= Now) && ((Next == INDEX_NONE) || (TimerDeadlines[Index] < TimerDeadlines[Next]))) {
+				Next = Index;
+			}
+		}
+
+		if (Next == INDEX_NONE) {
+			return;
+		}
+
+		ArmedTimers &= ~(1 << Next);
+		(this->*Callbacks[Next])();
+	}
+}
+
+/************************************************************/
+/*---------------------- Root Motion -----------------------*/
+/************************************************************/
+
+void UParkourMovementComponent::StartWallCorrection(const FVector& TargetLocation, const FVector& WallNormal, const FRotator& TargetRotation)
+{
+	SnapRotation(TargetRotation);
+
+	const FVector Normal = WallNormal.GetSafeNormal2D();
+	const float Gap = FVector::DotProduct(TargetLocation - Character->GetActorLocation(), Normal);
+	if (FMath::IsNearlyZero(Gap)) {
+		return;
+	}
+
+	TSharedPtr<FRootMotionSource_ConstantForce> Correction = MakeShared<FRootMotionSource_ConstantForce>();
+	Correction->InstanceName = ParkourSnapMoveName;
+	Correction->AccumulateMode = ERootMotionAccumulateMode::Additive;
+	Correction->Force = Normal * (Gap / ParkourSnapTime);
+	Correction->Duration = ParkourSnapTime;
+	ApplyRootMotionMove(Correction);
+}
+
+void UParkourMovementComponent::StartSnapMove(FName Name, const FVector& TargetLocation, float Duration)
+{
+	// Root motion doesn't move a character whose movement is disabled, as it is while hanging from a ledge
+	if (CharacterMovementComponent->MovementMode == MOVE_None) {
+		TGuardValue<bool> SnapGuard(bSnapChangingMovementMode, true);
+		CharacterMovementComponent->SetMovementMode(MOVE_Flying);
+	}
+
+	TSharedPtr<FRootMotionSource_MoveToForce> Move = MakeShared<FRootMotionSource_MoveToForce>();
+	Move->InstanceName = Name;
+	Move->AccumulateMode = ERootMotionAccumulateMode::Override;
+	Move->StartLocation = Character->GetActorLocation();
+	Move->TargetLocation = TargetLocation;
+	Move->Duration = Duration;
+	Move->bRestrictSpeedToExpected = false;
+	Move->FinishVelocityParams.Mode = ERootMotionFinishVelocityMode::SetVelocity;
+	Move->FinishVelocityParams.SetVelocity = FVector::ZeroVector;
+	ApplyRootMotionMove(Move);
+}
+
+void UParkourMovementComponent::StartMantleMove()
+{
+	// The time the old per step VInterpTo took to close in to 8 units, worked out once for the whole move
+	const float Distance = FMath::Max(FVector::Dist(Character->GetActorLocation(), Runtime.MantlePosition), 8.0f);
+	const float Speed = FMath::Max(IsQuickMantle() ? GetSettings().QuickMantleSpeed : GetSettings().MantleSpeed, KINDA_SMALL_NUMBER);
+	StartSnapMove(ParkourMantleMoveName, Runtime.MantlePosition, FMath::Max(FMath::Loge(Distance / 8.0f) / Speed, 0.05f));
+}
+
+void UParkourMovementComponent::ApplyRootMotionMove(const TSharedPtr<FRootMotionSource>& Move)
+{
+	PARKOUR_INC_COUNTER(RootMotionMoves);
+
+	CharacterMovementComponent->RemoveRootMotionSource(Move->InstanceName);
+	CharacterMovementComponent->ApplyRootMotionSource(Move);
+}
+
+bool UParkourMovementComponent::IsRootMotionMoveActive(FName Name) const
+{
+	// Finished sources stay in the group until the next move cleans them up
+	const TSharedPtr<FRootMotionSource> Move = CharacterMovementComponent->GetRootMotionSource(Name);
+	return Move.IsValid() && !Move->Status.HasFlag(ERootMotionSourceStatusFlags::Finished);
+}
+
+void UParkourMovementComponent::StopRootMotionMoves()
+{
+	if (CharacterMovementComponent) {
+		CharacterMovementComponent->RemoveRootMotionSource(ParkourSnapMoveName);
+		CharacterMovementComponent->RemoveRootMotionSource(ParkourMantleMoveName);
+	}
+}
+
+void UParkourMovementComponent::SnapRotation(const FRotator& TargetRotation)
+{
+	const FRotator Rotation = Character->GetActorRotation();
+	Character->SetActorRotation(FRotator(Rotation.Pitch, TargetRotation.Yaw, Rotation.Roll));
 }
 
 /************************************************************/
@@ -289,7 +1116,7 @@ void UParkourMovementComponent::Initialize(ACharacter* PlayerCharacter)
 
 void UParkourMovementComponent::WallRunEnd(float ResetTime)
 {
-	if (MacroWallRunning()) {
+	if (IsWallRunning()) {
 		if (SetParkourMovementMode(EParkourMovement::None)) {
 			// Call Close Wall Run Gate Event Dispatcher
 			CloseWallRunGate();
@@ -297,119 +1124,107 @@ void UParkourMovementComponent::WallRunEnd(float ResetTime)
 			// Call the update to stop the wall run
 			//WallRunGate();
 
-			// Open the gate upon finishing.
-			GetWorld()->GetTimerManager().SetTimer(WallRunOpenGateEventHandle, this, &UParkourMovementComponent::OpenWallRunGate, ResetTime, false);
-
-			// Clear the Wall Run Enable Gravity Timer
-			GetWorld()->GetTimerManager().ClearTimer(WallRunEnableGravityEventHandle);
+			QueueWallRunEnd(ResetTime);
 
-			// Set Wall Run Gravity to false;
-			bIsWallRunGravity = false;
+			// Open the gate upon finishing.
+			// Wall run gravity is reset by the wall run exit action.
+			ArmTimer(EParkourTimer::WallRunOpenGate, ResetTime);
 		}
 		else {
-			FString message = "Parkour Movement Component_WallRunEnd: SetParkourMode to None Failed.";
-			//UE_LOG(LogTemp, Warning, TEXT("%s"), *message);
-			//return;
+			//UE_LOG(LogTemp, Warning, TEXT("Parkour Movement Component_WallRunEnd: SetParkourMode to None Failed."));
 		}
 	}
 	else {
-		FString message = "Parkour Movement Component_WallRunEnd: MacroWallRunning returned false.";
-		//UE_LOG(LogTemp, Warning, TEXT("%s"), *message);
-		//return;
+		//UE_LOG(LogTemp, Warning, TEXT("Parkour Movement Component_WallRunEnd: IsWallRunning returned false."));
 	}
 }
 
-bool UParkourMovementComponent::WallRunMovement(FVector Start, FVector End, float WallRunDirection)
+bool UParkourMovementComponent::WallRunMovement(float WallRunDirection)
 {
-	// Create a Hit Result for the Outhit Parameters
-	FHitResult Hit;
+	PARKOUR_SCOPE_CYCLE_COUNTER(WallRunMovement);
 
-	// Call Line Trace By Channel with the Start and End Vector, Needing the bool BlockingHit, OutHitImpactPoint, and OutHitNormal.
-	if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility)) {
-		if (Hit.bBlockingHit)
-		{
-			// Set WallRunNormal and Location to their respects variables
-			WallRunNormal = Hit.Normal;
-			WallRunLocation = Hit.ImpactPoint;
-
-			// Call Macro Valid Wall Run Vector and get the charactermovement if falling
-			if (MacroValidWallRunVector(Hit.Normal) && Character->GetCharacterMovement()->IsFalling())
-			{
-				float select = UKismetMathLibrary::SelectFloat(WallRunSprintSpeed, WallRunSpeed, SprintQueued);
-				float FResults = select * WallRunDirection;
-				FVector VResults = FVector::CrossProduct(WallRunNormal, { 0, 0, 1 });
-				bool BResults = (!MacroWallRunning() || !bIsWallRunGravity);
-
-				// Launch character to wall, sticking them in the forward direction
-				Character->LaunchCharacter((VResults * FResults), true, BResults);
-				return true;
-			}
-			else {
-				return false;
-			}
+	FParkourComponentWorldQuery World(*this);
+	FParkourQueryHit Hit;
+	const bool bRunnableWall = ParkourCore::FindWallRunWall(World, MakeProbeOrigin(), WallRunDirection, Hit);
+	if (!Hit.bBlockingHit) {
+		return false;
+	}
+
+	// Kept for any wall, the corrections only run once the wall is accepted
+	Runtime.WallRunNormal = Hit.Normal;
+	Runtime.WallRunLocation = Hit.ImpactPoint;
+
+	if (bRunnableWall && Character->GetCharacterMovement()->IsFalling()) {
+		const float Speed = Runtime.bSprintQueued ? GetSettings().WallRunSprintSpeed : GetSettings().WallRunSpeed;
+		const bool bOverrideZ = (!IsWallRunning() || !Runtime.bIsWallRunGravity);
+
+		// Launch character to wall, sticking them in the forward direction
+		const FVector Launch = ParkourRules::WallRunLaunchVelocity(Runtime.WallRunNormal, Speed, WallRunDirection);
+		if (UsesAsyncPhysicsForces()) {
+			AsyncForces.StickVelocity = Launch;
+			AsyncForces.bStick = true;
+			AsyncForces.bStickZ = bOverrideZ;
 		}
 		else {
-			return false;
+			LaunchCharacter(Launch, true, bOverrideZ);
 		}
+		return true;
 	}
-	else {
-		return false;
-	}
+	return false;
 }
 
 void UParkourMovementComponent::WallRunGravity()
 {
-	float Results = UKismetMathLibrary::FInterpTo(CharacterMovementComponent->GravityScale, WallRunTargetGravity, GetWorld()->GetDeltaSeconds(), WallRunStartSpeed);
+	float Results = UKismetMathLibrary::FInterpTo(CharacterMovementComponent->GravityScale, GetSettings().WallRunTargetGravity, GetStepTime(), GetSettings().WallRunStartSpeed);
 	CharacterMovementComponent->GravityScale = Results;
 }
 
 void UParkourMovementComponent::WallRunEnableGravity()
 {
-	if (MacroWallRunning()) {
-		bIsWallRunGravity = true;
+	if (IsWallRunning()) {
+		Runtime.bIsWallRunGravity = true;
 	}
 	else {
-		bIsWallRunGravity = false;
+		Runtime.bIsWallRunGravity = false;
 	}
 }
 
-void UParkourMovementComponent::CorrectWallRunLocation()
+void UParkourMovementComponent::WallRunExit()
 {
-	if (MacroWallRunning()) {
-		FLatentActionInfo LatentInfo;
-		LatentInfo.CallbackTarget = this;
+	// Clear the Wall Run Enable Gravity Timer
+	ClearTimer(EParkourTimer::WallRunEnableGravity);
 
-		UKismetSystemLibrary::MoveComponentTo(Character->GetRootComponent(), WallRunTargetVector(), WallRunTargetRotation(), false, false, 0.1, false, EMoveComponentAction::Move, LatentInfo);
+	// Set Wall Run Gravity to false;
+	Runtime.bIsWallRunGravity = false;
+}
+
+void UParkourMovementComponent::CorrectWallRunLocation()
+{
+	if (IsWallRunning()) {
+		StartWallCorrection(WallRunTargetVector(), Runtime.WallRunNormal, WallRunTargetRotation());
 	}
 }
 
 FVector UParkourMovementComponent::WallRunTargetVector()
 {
-	float CapRadius = Character->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
-	return (WallRunLocation + (WallRunNormal * CapRadius));
+	return ParkourRules::WallRunTargetLocation(Runtime.WallRunLocation, Runtime.WallRunNormal, Character->GetCapsuleComponent()->GetUnscaledCapsuleRadius());
 }
 
 FRotator UParkourMovementComponent::WallRunTargetRotation()
 {
-	float RotX = Character->GetCapsuleComponent()->GetRelativeRotation().Roll;
-	float RotY = Character->GetCapsuleComponent()->GetRelativeRotation().Pitch;
-	FRotator Conversion = UKismetMathLibrary::Conv_VectorToRotator(WallRunNormal);
-	float RawZValue = Conversion.Yaw;
-	float Selection = UKismetMathLibrary::SelectFloat(90, -90, (CurrentParkourMode == EParkourMovement::LeftWallRun));
-
-	FRotator Results = UKismetMathLibrary::MakeRotator(RotX, RotY, (RawZValue - Selection));
-	return Results;
+	const FRotator CapsuleRotation = Character->GetCapsuleComponent()->GetRelativeRotation();
+	return FRotator(CapsuleRotation.Pitch, ParkourRules::WallRunTargetYaw(Runtime.WallRunNormal, (Runtime.GetCurrentMode() == EParkourMovement::LeftWallRun)), CapsuleRotation.Roll);
 }
 
 void UParkourMovementComponent::WallRunUpdate()
 {
-	if (MacroCanWallRun()) {
+	if (CanWallRun()) {
 		// Call Function WallRunMovement With Character's Location Vector, the Wall Run End Right Vector, and Run Direction of -1.0. Returns a Boolean.
 
-		if (WallRunMovement(Character->GetActorLocation(), MacroWallRunEndVectorsRight(), -1.0)) {
+		if (WallRunMovement(-1.0)) {
 			if (SetParkourMovementMode(EParkourMovement::RightWallRun)) {
 				// Call Function Set Timer By Function Name, with function name WallRunEnableGravity, and a float time set as 1
-				GetWorld()->GetTimerManager().SetTimer(WallRunEnableGravityEventHandle, this, &UParkourMovementComponent::WallRunEnableGravity, 1.0f, false);
+				ArmTimer(EParkourTimer::WallRunEnableGravity, 1.0f);
 
 				// Call Delegate Correct Wall Run Location
 				CorrectWallRunLocation();
@@ -422,15 +1237,15 @@ void UParkourMovementComponent::WallRunUpdate()
 			}
 		}
 		else {
-			if (CurrentParkourMode == EParkourMovement::RightWallRun) {
+			if (Runtime.GetCurrentMode() == EParkourMovement::RightWallRun) {
 				// Call Wall Run End at 0.5 seconds
-				OnWallRunEnd.Broadcast(0.5);
+				WallRunEnd(0.5);
 			}
 			else {
-				if (WallRunMovement(Character->GetActorLocation(), MacroWallRunEndVectorsLeft(), 1.0)) {
+				if (WallRunMovement(1.0)) {
 					if (SetParkourMovementMode(EParkourMovement::LeftWallRun)) {
 						// Call Function Set Timer By Function Name, with function name WallRunEnableGravity, and a float time set as 1
-						GetWorld()->GetTimerManager().SetTimer(WallRunEnableGravityEventHandle, this, &UParkourMovementComponent::WallRunEnableGravity, 1.0f, false);
+						ArmTimer(EParkourTimer::WallRunEnableGravity, 1.0f);
 
 						// Call Delegate Correct Wall Run Location
 						CorrectWallRunLocation();
@@ -445,14 +1260,14 @@ void UParkourMovementComponent::WallRunUpdate()
 				}
 				else {
 					// Call Wall Run End at 0.5 seconds
-					OnWallRunEnd.Broadcast(0.5);
+					WallRunEnd(0.5);
 				}
 			}
 		}
 	}
 	else {
 		// Call Wall Run End at 1 second
-		OnWallRunEnd.Broadcast(1.0);
+		WallRunEnd(1.0);
 	}
 }
 
@@ -462,56 +1277,33 @@ void UParkourMovementComponent::WallRunUpdate()
 
 void UParkourMovementComponent::VerticalWallRunUpdate()
 {
-	if (MacroCanVerticalWallRun()) {
-		FHitResult HitResults;
-
-		FLinearColor ColorOne = FLinearColor(0, 1, 0, 1);
-		FLinearColor ColorTwo = FLinearColor(1, 0, 0, 0);
-
-		if (UKismetSystemLibrary::CapsuleTraceSingle(
-			Character->GetCapsuleComponent(),
-			MacroMantleVectorsEyes(),
-			MacroMantleVectorsFeet(),
-			20,
-			10,
-			ETraceTypeQuery::TraceTypeQuery4,
-			false,
-			ActorsToIgnore,
-			EDrawDebugTrace::Type::None,
-			HitResults,
-			true,
-			ColorTwo,
-			ColorOne,
-			5)) {
-
-			MantleTraceDistance = HitResults.Distance;
-			LedgeFloorPosition = HitResults.ImpactPoint;
-			FHitResult ForwardTraceHitResults;
-
-			if (ForwardTracer(ForwardTraceHitResults) && CharacterMovementComponent->IsWalkable(HitResults)) {
-				LedgeClimbWallPosition = ForwardTraceHitResults.ImpactPoint;
-				LedgeClimbWallNormal = ForwardTraceHitResults.ImpactNormal;
-				MantlePosition = (LedgeFloorPosition + FVector(0, 0, MantleZOffset()));
-				CloseVerticalWallRunGate();
-				LedgeGrab();
-
-				FVector Start = Character->GetActorLocation();
-				FVector End = Character->GetActorLocation() - (Character->GetActorUpVector() * CapsuleZOffset());
-				FHitResult LineHitResult;
-
-				bool Results = UKismetSystemLibrary::LineTraceSingle(this, Start, End, ETraceTypeQuery::TraceTypeQuery4, false, ActorsToIgnore, EDrawDebugTrace::Type::None, LineHitResult, true, FLinearColor(1, 0, 0, 1), FLinearColor(0, 1, 0, 1), 5);
-				LedgeCloseToGround = Results;
-
-				if (MacroQuickMantle()) {
-					OpenMantleCheckGate();
-				}
-				else {
-					CorrectLedgeLocation();
-					GetWorld()->GetTimerManager().SetTimer(MantleCheckEventHandle, this, &UParkourMovementComponent::OpenMantleCheckGate, 0.25f, false);
-				}
+	if (CanVerticalWallRun()) {
+		FParkourComponentWorldQuery World(*this);
+		const FParkourProbeOrigin Origin = MakeProbeOrigin();
+		FParkourLedge Ledge;
+		const bool bFoundLedge = ParkourCore::FindLedge(World, Origin, Ledge);
+
+		if (Ledge.bFoundFloor) {
+			Runtime.MantleTraceDistance = Ledge.TraceDistance;
+			Runtime.LedgeFloorPosition = Ledge.FloorLocation;
+		}
+
+		if (bFoundLedge) {
+			Runtime.LedgeClimbWallPosition = Ledge.WallLocation;
+			Runtime.LedgeClimbWallNormal = Ledge.WallNormal;
+			Runtime.MantlePosition = (Runtime.LedgeFloorPosition + FVector(0, 0, MantleZOffset()));
+			CloseVerticalWallRunGate();
+			LedgeGrab();
+
+			// The grab hasn't moved the character yet, its snap runs with the next movement update
+			Runtime.bLedgeCloseToGround = ParkourCore::IsLedgeCloseToGround(World, Origin);
+
+			if (IsQuickMantle()) {
+				OpenMantleCheckGate();
 			}
 			else {
-				VerticalWallRunMovement();
+				CorrectLedgeLocation();
+				ArmTimer(EParkourTimer::MantleCheck, 0.25f);
 			}
 		}
 		else {
@@ -525,7 +1317,7 @@ void UParkourMovementComponent::VerticalWallRunUpdate()
 
 void UParkourMovementComponent::VerticalWallRunEnd(float ResetTime)
 {
-	if ((CurrentParkourMode == EParkourMovement::LedgeGrab) || (CurrentParkourMode == EParkourMovement::VerticalWallRun) || (CurrentParkourMode == EParkourMovement::Mantle)) {
+	if ((Runtime.GetCurrentMode() == EParkourMovement::LedgeGrab) || (Runtime.GetCurrentMode() == EParkourMovement::VerticalWallRun) || (Runtime.GetCurrentMode() == EParkourMovement::Mantle)) {
 		if (SetParkourMovementMode(EParkourMovement::None)) {
 			// Close The Vertical Wall Run Gate
 			CloseVerticalWallRunGate();
@@ -533,10 +1325,10 @@ void UParkourMovementComponent::VerticalWallRunEnd(float ResetTime)
 			// Close Mantle Check Gate
 			CloseMantleCheckGate();
 
-			LedgeCloseToGround = false;
+			Runtime.bLedgeCloseToGround = false;
 
-			GetWorld()->GetTimerManager().SetTimer(VerticalRunEndGateEventHandle, this, &UParkourMovementComponent::OpenVerticalWallRunGate, ResetTime, false);
-			GetWorld()->GetTimerManager().SetTimer(CheckQueuesEventHandle, this, &UParkourMovementComponent::CheckQueues, 0.02f, false);
+			ArmTimer(EParkourTimer::VerticalRunEndGate, ResetTime);
+			ArmTimer(EParkourTimer::CheckQueues, 0.02f);
 		}
 	}
 }
@@ -545,18 +1337,21 @@ void UParkourMovementComponent::VerticalWallRunMovement()
 {
 	FHitResult Hit;
 	if (ForwardTracer(Hit)) {
-		VerticalWallRunLocation = Hit.Location;
-		VerticalWallRunNormal = Hit.Normal;
+		Runtime.VerticalWallRunLocation = Hit.Location;
+		Runtime.VerticalWallRunNormal = Hit.Normal;
 
 		if (SetParkourMovementMode(EParkourMovement::VerticalWallRun)) {
 			CorrectVerticalWallRunLocation();
+		}
 
-			FVector LaunchResults = FVector(VerticalWallRunNormal.X * -600.0f, VerticalWallRunNormal.Y * -600.0f, VerticalWallRunSpeed);
-			Character->LaunchCharacter(LaunchResults, true, true);
+		const FVector Launch = ParkourRules::VerticalWallRunLaunchVelocity(Runtime.VerticalWallRunNormal, GetSettings().VerticalWallRunSpeed);
+		if (UsesAsyncPhysicsForces()) {
+			AsyncForces.StickVelocity = Launch;
+			AsyncForces.bStick = true;
+			AsyncForces.bStickZ = true;
 		}
 		else {
-			FVector LaunchResults = FVector(VerticalWallRunNormal.X * -600.0f, VerticalWallRunNormal.Y * -600.0f, VerticalWallRunSpeed);
-			Character->LaunchCharacter(LaunchResults, true, true);
+			LaunchCharacter(Launch, true, true);
 		}
 	}
 	else {
@@ -566,70 +1361,52 @@ void UParkourMovementComponent::VerticalWallRunMovement()
 
 void UParkourMovementComponent::CorrectVerticalWallRunLocation()
 {
-	FLatentActionInfo LatentActionInfo;
-	LatentActionInfo.CallbackTarget = this;
-
-	if (CurrentParkourMode == EParkourMovement::VerticalWallRun) {
-		UKismetSystemLibrary::MoveComponentTo(Character->GetRootComponent(), VerticalWallRunTargetLocation(), VerticalWallRunTargetRotation(), false, false, 0.1, false, EMoveComponentAction::Move, LatentActionInfo);
+	if (Runtime.GetCurrentMode() == EParkourMovement::VerticalWallRun) {
+		StartWallCorrection(VerticalWallRunTargetLocation(), Runtime.VerticalWallRunNormal, VerticalWallRunTargetRotation());
 	}
 }
 
 FVector UParkourMovementComponent::VerticalWallRunTargetLocation()
 {
-	FVector Location = VerticalWallRunNormal * (Character->GetCapsuleComponent()->GetUnscaledCapsuleRadius());
-
-	return (VerticalWallRunLocation + Location);
+	return ParkourRules::WallRunTargetLocation(Runtime.VerticalWallRunLocation, Runtime.VerticalWallRunNormal, Character->GetCapsuleComponent()->GetUnscaledCapsuleRadius());
 }
 
 FRotator UParkourMovementComponent::VerticalWallRunTargetRotation()
 {
-	FRotator RawYaw = UKismetMathLibrary::Conv_VectorToRotator(VerticalWallRunNormal);
-	float Yaw = RawYaw.Yaw;
-	FRotator results = UKismetMathLibrary::MakeRotator(Character->GetCapsuleComponent()->GetRelativeRotation().Roll, Character->GetCapsuleComponent()->GetRelativeRotation().Pitch, (Yaw - 180.0f));
-	return results;
+	const FRotator CapsuleRotation = Character->GetCapsuleComponent()->GetRelativeRotation();
+	return FRotator(CapsuleRotation.Pitch, ParkourRules::FacingWallYaw(Runtime.VerticalWallRunNormal), CapsuleRotation.Roll);
 }
 
 void UParkourMovementComponent::CorrectLedgeLocation()
 {
-	FLatentActionInfo LatentActionInfo;
-	LatentActionInfo.CallbackTarget = this;
-
-	if (CurrentParkourMode == EParkourMovement::LedgeGrab) {
-		UKismetSystemLibrary::MoveComponentTo(Character->GetRootComponent(), LedgeTargetLocation(), LedgeTargetRotation(), false, false, 0.1, false, EMoveComponentAction::Move, LatentActionInfo);
+	if (Runtime.GetCurrentMode() == EParkourMovement::LedgeGrab) {
+		SnapRotation(LedgeTargetRotation());
+		StartSnapMove(ParkourSnapMoveName, LedgeTargetLocation(), ParkourSnapTime);
 	}
 }
 
 FVector UParkourMovementComponent::LedgeTargetLocation()
 {
-	FVector RollPitchResults = (LedgeClimbWallPosition + (LedgeClimbWallNormal * Character->GetCapsuleComponent()->GetUnscaledCapsuleRadius()));
-	float YawResults = LedgeFloorPosition.Z - Character->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
-	FVector results = UKismetMathLibrary::MakeVector(RollPitchResults.X, RollPitchResults.Y, YawResults);
-	return results;
+	const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+	return ParkourRules::LedgeTargetLocation(Runtime.LedgeClimbWallPosition, Runtime.LedgeClimbWallNormal, Runtime.LedgeFloorPosition, Capsule->GetUnscaledCapsuleRadius(), Capsule->GetUnscaledCapsuleHalfHeight());
 }
 
 FRotator UParkourMovementComponent::LedgeTargetRotation()
 {
-	FRotator YawResults = UKismetMathLibrary::Conv_VectorToRotator(LedgeClimbWallNormal);
-	float Yaw = YawResults.Yaw;
-	FRotator results = UKismetMathLibrary::MakeRotator(Character->GetCapsuleComponent()->GetRelativeRotation().Roll, Character->GetCapsuleComponent()->GetRelativeRotation().Pitch, (Yaw - 180.0f));
-	return results;
+	const FRotator CapsuleRotation = Character->GetCapsuleComponent()->GetRelativeRotation();
+	return FRotator(CapsuleRotation.Pitch, ParkourRules::FacingWallYaw(Runtime.LedgeClimbWallNormal), CapsuleRotation.Roll);
 }
 
 float UParkourMovementComponent::MantleZOffset()
 {
-	return Character->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight() * 1;
-}
-
-float UParkourMovementComponent::CapsuleZOffset()
-{
-	return Character->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight() + 40.f;
+	return ParkourRules::MantleZOffset(Character->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight());
 }
 
 void UParkourMovementComponent::VerticalWallRunEndEvent()
 {
-	GetWorld()->GetTimerManager().ClearTimer(VerticalWallRunEndEventHandle);
+	ClearTimer(EParkourTimer::VerticalWallRunEnd);
 
-	if (CurrentParkourMode == EParkourMovement::VerticalWallRun) {
+	if (Runtime.GetCurrentMode() == EParkourMovement::VerticalWallRun) {
 		VerticalWallRunEnd(2);
 	}
 }
@@ -637,52 +1414,43 @@ void UParkourMovementComponent::VerticalWallRunEndEvent()
 /************************************************************/
 /*------------------------ Jump ----------------------------*/
 /************************************************************/
+// Only reached through the transition table, which has already matched the mode
 void UParkourMovementComponent::WallRunJump()
 {
-	if (MacroWallRunning()) {
-		WallRunEnd(0.35);
+	WallRunEnd(0.35);
 
-		float LaunchX = (WallRunJumpOffForce * WallRunNormal.X);
-		float LaunchY = (WallRunJumpOffForce * WallRunNormal.Y);
-		FVector Launch = { LaunchX, LaunchY, WallRunJumpHeight };
+	float LaunchX = (GetSettings().WallRunJumpOffForce * Runtime.WallRunNormal.X);
+	float LaunchY = (GetSettings().WallRunJumpOffForce * Runtime.WallRunNormal.Y);
+	FVector Launch = { LaunchX, LaunchY, GetSettings().WallRunJumpHeight };
 
-		Character->LaunchCharacter(Launch, false, true);
-	}
+	LaunchCharacter(Launch, false, true);
 }
 
 void UParkourMovementComponent::LedgeGrabJump()
 {
-	if ((CurrentParkourMode == EParkourMovement::LedgeGrab) || (CurrentParkourMode == EParkourMovement::VerticalWallRun) || (CurrentParkourMode == EParkourMovement::Mantle)) {
-		VerticalWallRunEnd(0.35);
+	VerticalWallRunEnd(0.35);
 
-		float LaunchX = (LedgeGrabJumpOffForce * VerticalWallRunNormal.X);
-		float LaunchY = (LedgeGrabJumpOffForce * VerticalWallRunNormal.Y);
-		FVector Launch = { LaunchX, LaunchY, LedgeGrabJumpHeight };
+	float LaunchX = (GetSettings().LedgeGrabJumpOffForce * Runtime.VerticalWallRunNormal.X);
+	float LaunchY = (GetSettings().LedgeGrabJumpOffForce * Runtime.VerticalWallRunNormal.Y);
+	FVector Launch = { LaunchX, LaunchY, GetSettings().LedgeGrabJumpHeight };
 
-		Character->LaunchCharacter(Launch, true, true);
-	}
+	LaunchCharacter(Launch, true, true);
 }
 
 void UParkourMovementComponent::SlideJump()
 {
-	if (CurrentParkourMode == EParkourMovement::Slide) {
-		SlideEnd(false);
-	}
+	SlideEnd(false);
 }
 
 void UParkourMovementComponent::CrouchJump()
 {
-	if (CurrentParkourMode == EParkourMovement::Crouch) {
-		CrouchEnd();
-	}
+	CrouchEnd();
 }
 
 void UParkourMovementComponent::SprintJump()
 {
-	if (CurrentParkourMode == EParkourMovement::Sprint) {
-		SprintEnd();
-		SprintQueued = true;
-	}
+	SprintEnd();
+	Runtime.bSprintQueued = true;
 }
 
 /************************************************************/
@@ -690,13 +1458,26 @@ void UParkourMovementComponent::SprintJump()
 /************************************************************/
 void UParkourMovementComponent::LedgeGrab()
 {
-	if (SetParkourMovementMode(EParkourMovement::LedgeGrab)) {
-		CharacterMovementComponent->DisableMovement();
-		CharacterMovementComponent->StopMovementImmediately();
-		CharacterMovementComponent->GravityScale = 0;
+	// Movement is stopped by the ledge grab entry action
+	if (SetParkourMovementMode(EParkourMovement::LedgeGrab)) {
+		// Broadcast Ledge Grab Camera Shake
+		//OnCameraShakeEvent.Broadcast();
+	}
+}
+
+void UParkourMovementComponent::LedgeGrabEnter()
+{
+	CharacterMovementComponent->DisableMovement();
+	CharacterMovementComponent->StopMovementImmediately();
+	CharacterMovementComponent->GravityScale = 0;
+}
 
-		// Broadcast Ledge Grab Camera Shake
-		//OnCameraShakeEvent.Broadcast();
+void UParkourMovementComponent::LedgeGrabHang()
+{
+	// Movement stays disabled while hanging, apart from the snap onto the ledge
+	if ((Runtime.GetCurrentMode() == EParkourMovement::LedgeGrab) && (CharacterMovementComponent->MovementMode != MOVE_None) && !IsRootMotionMoveActive(ParkourSnapMoveName)) {
+		TGuardValue<bool> SnapGuard(bSnapChangingMovementMode, true);
+		CharacterMovementComponent->DisableMovement();
 	}
 }
 
@@ -706,8 +1487,8 @@ void UParkourMovementComponent::LedgeGrab()
 
 void UParkourMovementComponent::SprintUpdate()
 {
-	if (CurrentParkourMode == EParkourMovement::Sprint) {
-		if (!(MacroForwardInput() > 0)) {
+	if (Runtime.GetCurrentMode() == EParkourMovement::Sprint) {
+		if (!(ForwardInput() > 0)) {
 			SprintEnd();
 		}
 	}
@@ -715,25 +1496,29 @@ void UParkourMovementComponent::SprintUpdate()
 
 void UParkourMovementComponent::SprintEnd()
 {
-	if (CurrentParkourMode == EParkourMovement::Sprint) {
+	if (Runtime.GetCurrentMode() == EParkourMovement::Sprint) {
 		if (SetParkourMovementMode(EParkourMovement::None)) {
 			CloseSprintGate();
-			GetWorld()->GetTimerManager().SetTimer(OpenSprintGateEventHandle, this, &UParkourMovementComponent::OpenSprintGate, 0.1f, false);
+			ArmTimer(EParkourTimer::OpenSprintGate, 0.1f);
 		}
 	}
 }
 
+void UParkourMovementComponent::SprintEnter()
+{
+	CharacterMovementComponent->MaxWalkSpeed = GetSettings().SprintSpeed;
+}
+
 void UParkourMovementComponent::SprintStart()
 {
 	SlideEnd(false);
 	CrouchEnd();
 
-	if (MacroCanSprint()) {
+	if (CanSprint()) {
 		if (SetParkourMovementMode(EParkourMovement::Sprint)) {
-			CharacterMovementComponent->MaxWalkSpeed = SprintSpeed;
 			OpenSprintGate();
-			SprintQueued = false;
-			SlideQueued = false;
+			Runtime.bSprintQueued = false;
+			Runtime.bSlideQueued = false;
 		}
 	}
 }
@@ -744,33 +1529,26 @@ void UParkourMovementComponent::SprintStart()
 
 void UParkourMovementComponent::CrouchStart()
 {
-	if (CurrentParkourMode == EParkourMovement::None) {
-		Character->Crouch();
-		SetParkourMovementMode(EParkourMovement::Crouch);
-		SprintQueued = false;
-		SlideQueued = false;
-	}
+	Character->Crouch();
+	SetParkourMovementMode(EParkourMovement::Crouch);
+	Runtime.bSprintQueued = false;
+	Runtime.bSlideQueued = false;
 }
 
 void UParkourMovementComponent::CrouchEnd()
 {
-	if (CurrentParkourMode == EParkourMovement::Crouch) {
+	if (Runtime.GetCurrentMode() == EParkourMovement::Crouch) {
 		Character->UnCrouch();
 		SetParkourMovementMode(EParkourMovement::None);
-		SprintQueued = false;
-		SlideQueued = false;
+		Runtime.bSprintQueued = false;
+		Runtime.bSlideQueued = false;
 	}
 }
 
 void UParkourMovementComponent::CrouchToggle()
 {
-	switch (CurrentParkourMode) {
-	case EParkourMovement::None: CrouchStart();
-		break;
-	case EParkourMovement::Crouch: CrouchEnd();
-		break;
-	default: UE_LOG(LogTemp, Warning, TEXT("None"));
-		break;
+	if (!FireTrigger(EParkourTrigger::Crouch)) {
+		UE_LOG(LogTemp, Warning, TEXT("None"));
 	}
 }
 
@@ -780,7 +1558,7 @@ void UParkourMovementComponent::CrouchToggle()
 
 void UParkourMovementComponent::SlideUpdate()
 {
-	if (CurrentParkourMode == EParkourMovement::Slide) {
+	if (Runtime.GetCurrentMode() == EParkourMovement::Slide) {
 		if (CharacterMovementComponent->Velocity.Length() <= 35.f) {
 			SlideEnd(true);
 		}
@@ -789,7 +1567,7 @@ void UParkourMovementComponent::SlideUpdate()
 
 void UParkourMovementComponent::SlideStart()
 {
-	if (MacroCanSlide() && CharacterMovementComponent->IsWalking()) {
+	if (CanSlide() && CharacterMovementComponent->IsWalking()) {
 		SprintEnd();
 
 		SetParkourMovementMode(EParkourMovement::Slide);
@@ -804,15 +1582,20 @@ void UParkourMovementComponent::SlideStart()
 		CharacterMovementComponent->SetPlaneConstraintEnabled(true);
 
 		if (GetSlideVector().Z <= 0.02) {
-			CharacterMovementComponent->AddImpulse((GetSlideVector() * SlideImpulseAmount), true);
+			if (UsesAsyncPhysicsForces()) {
+				AsyncForces.Impulse += GetSlideVector() * GetSettings().SlideImpulseAmount;
+			}
+			else {
+				CharacterMovementComponent->AddImpulse((GetSlideVector() * GetSettings().SlideImpulseAmount), true);
+			}
 			OpenSlideGate();
-			SprintQueued = false;
-			SlideQueued = false;
+			Runtime.bSprintQueued = false;
+			Runtime.bSlideQueued = false;
 		}
 		else {
 			OpenSlideGate();
-			SprintQueued = false;
-			SlideQueued = false;
+			Runtime.bSprintQueued = false;
+			Runtime.bSlideQueued = false;
 		}
 	}
 }
@@ -820,7 +1603,7 @@ void UParkourMovementComponent::SlideStart()
 void UParkourMovementComponent::SlideEnd(bool IsCrouched)
 {
 	EParkourMovement NewMode = EParkourMovement::None;
-	if (CurrentParkourMode == EParkourMovement::Slide) {
+	if (Runtime.GetCurrentMode() == EParkourMovement::Slide) {
 		switch (IsCrouched) {
 		case false: NewMode = EParkourMovement::None;
 			break;
@@ -845,20 +1628,16 @@ FVector UParkourMovementComponent::VelocityNormal()
 
 FVector UParkourMovementComponent::GetSlideVector()
 {
-	FHitResult HitResults;
+	PARKOUR_SCOPE_CYCLE_COUNTER(GetSlideVector);
 
-	FLinearColor ColorOne = FLinearColor(0, 1, 0, 1);
-	FLinearColor ColorTwo = FLinearColor(1, 0, 0, 0);
+	FHitResult HitResults;
 
 	FVector Start = Character->GetActorLocation();
 	FVector End = (Character->GetActorLocation() + (Character->GetActorUpVector() * -200.f));
 
-	UKismetSystemLibrary::LineTraceSingle(this, Start, End, TraceTypeQuery5, false, ActorsToIgnore, EDrawDebugTrace::Type::None, HitResults, true, ColorOne, ColorTwo, 5);
+	TraceProbe(EParkourProbe::SlideFloor, Start, End, HitResults);
 
-	FVector CrossResults = UKismetMathLibrary::Cross_VectorVector(HitResults.ImpactNormal, Character->GetActorRightVector());
-	//GetWorld()->LineTraceSingleByChannel(HitResults, Start, End, ECC_Visibility); /*Duh, will fix all the kismets after this*/
-	FVector Results = CrossResults * -1.f;
-	return Results;
+	return ParkourRules::SlideVector(HitResults.ImpactNormal, Character->GetActorRightVector());
 }
 
 /************************************************************/
@@ -866,18 +1645,11 @@ FVector UParkourMovementComponent::GetSlideVector()
 /************************************************************/
 void UParkourMovementComponent::MantleMovement()
 {
-	FRotator CurrentRotator = Character->GetController()->GetControlRotation();
-	FRotator TargetRotator = UKismetMathLibrary::FindLookAtRotation(FVector(Character->GetActorLocation().X, Character->GetActorLocation().Y, 0), FVector(MantlePosition.X, MantlePosition.Y, 0));
-	FRotator InterpR = UKismetMathLibrary::RInterpTo(CurrentRotator, TargetRotator, GetWorld()->DeltaTimeSeconds, 7.0f);
-	Character->GetController()->SetControlRotation(InterpR);
+	PARKOUR_SCOPE_CYCLE_COUNTER(MantleMovement);
 
-	FVector CurrentVector = Character->GetActorLocation();
-	FVector InterpV = UKismetMathLibrary::VInterpTo(CurrentVector, MantlePosition, GetWorld()->DeltaTimeSeconds, UKismetMathLibrary::SelectFloat(QuickMantleSpeed, MantleSpeed, MacroQuickMantle()));
-	Character->SetActorLocation(InterpV);
-
-
-	float Distance = UKismetMathLibrary::Vector_Distance(Character->GetActorLocation(), MantlePosition);
-	if (Distance < 8) {
+	// The character is carried by the mantle's root motion source, the local player's camera modifier looks over the ledge
+	float Distance = UKismetMathLibrary::Vector_Distance(Character->GetActorLocation(), Runtime.MantlePosition);
+	if ((Distance < 8) || !IsRootMotionMoveActive(ParkourMantleMoveName)) {
 		VerticalWallRunEnd(0.5);
 	}
 }
@@ -890,63 +1662,344 @@ void UParkourMovementComponent::UpdateCameraProperties()
 	DefaultUseControllerRotationYaw = Character->bUseControllerRotationYaw;
 }
 
-void UParkourMovementComponent::CameraTilt(float TargetXRoll)
+void UParkourMovementComponent::AddCameraModifier()
 {
-	// Create the starting rotation for the camera tilt
-	FRotator Starter = FRotator(TargetXRoll, Character->GetController()->GetControlRotation().Pitch, Character->GetController()->GetControlRotation().Yaw);
+	if (!Character || !Character->IsLocallyControlled()) {
+		return;
+	}
 
-	// Create the new rotation from RInterpTo
-	FRotator NewRotation = UKismetMathLibrary::RInterpTo(Character->GetController()->GetControlRotation(), Starter, GetWorld()->GetDeltaSeconds(), 10.f);
+	UParkourCameraModifier::AddTo(Cast<APlayerController>(Character->GetController()));
+}
 
-	// Set the Character's control rotation to the new rotation
-	Character->GetController()->SetControlRotation(NewRotation);
+void UParkourMovementComponent::OnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+	AddCameraModifier();
 }
 
-void UParkourMovementComponent::CameraTick()
+/************************************************************/
+/*--------------------- Transitions ------------------------*/
+/************************************************************/
+bool UParkourMovementComponent::FireTrigger(EParkourTrigger Trigger)
 {
-	//UE_LOG(LogTemp, Warning, TEXT("Current Parkour Mode: %s"), *UEnum::GetValueAsString(CurrentParkourMode));
+	// The server fires a simulated proxy's triggers, their effects come back as replicated movement and state
+	if (IsSimulatedProxy()) {
+		return false;
+	}
 
-	/*
-	switch (CurrentParkourMode) {
-	case EParkourMovement::LeftWallRun: CameraTilt(15.f); UE_LOG(LogTemp, Warning, TEXT("Camera Tilting Left"));
-		break;
-	case EParkourMovement::RightWallRun: CameraTilt(-15.f); UE_LOG(LogTemp, Warning, TEXT("Camera Tilting Right"));
-		break;
-	case EParkourMovement::None:CameraTilt(0.f);
-		break;
-	case EParkourMovement::VerticalWallRun:CameraTilt(0.f);
-		break;
-	case EParkourMovement::LedgeGrab:CameraTilt(0.f);
-		break;
-	case EParkourMovement::Mantle:CameraTilt(0.f);
-		break;
-	case EParkourMovement::Slide:CameraTilt(0.f);
-		break;
-	case EParkourMovement::Crouch:CameraTilt(0.f);
-		break;
-	case EParkourMovement::Sprint: CameraTilt(0.f);
-		break;
-	}*/
+	FParkourTransitionContext Context;
+	Context.Mode = Runtime.GetCurrentMode();
+	Context.bIsFalling = CharacterMovementComponent->IsFalling();
+
+	FParkourComponentTransitionTarget Target(*this);
+	return FParkourTransitionTable::Fire(Target, Trigger, Context);
+}
+
+void FParkourComponentTransitionTarget::OpenGates() { Component.OpenGates(); }
+void FParkourComponentTransitionTarget::CrouchStart() { Component.CrouchStart(); }
+void FParkourComponentTransitionTarget::CrouchEnd() { Component.CrouchEnd(); }
+void FParkourComponentTransitionTarget::WallRunJump() { Component.WallRunJump(); }
+void FParkourComponentTransitionTarget::WallRunEnd(float ResetTime) { Component.WallRunEnd(ResetTime); }
+void FParkourComponentTransitionTarget::VerticalWallRunEnd(float ResetTime) { Component.VerticalWallRunEnd(ResetTime); }
+void FParkourComponentTransitionTarget::LedgeGrabJump() { Component.LedgeGrabJump(); }
+void FParkourComponentTransitionTarget::SlideJump() { Component.SlideJump(); }
+void FParkourComponentTransitionTarget::SlideEnd(bool bIsCrouched) { Component.SlideEnd(bIsCrouched); }
+void FParkourComponentTransitionTarget::CrouchJump() { Component.CrouchJump(); }
+void FParkourComponentTransitionTarget::SprintJump() { Component.SprintJump(); }
+void FParkourComponentTransitionTarget::SprintEnd() { Component.SprintEnd(); }
+void FParkourComponentTransitionTarget::ResetMovement() { Component.ResetMovement(); }
+void FParkourComponentTransitionTarget::WallRunExit() { Component.WallRunExit(); }
+void FParkourComponentTransitionTarget::LedgeGrabEnter() { Component.LedgeGrabEnter(); }
+void FParkourComponentTransitionTarget::SprintEnter() { Component.SprintEnter(); }
+
+/************************************************************/
+/*----------------------- Recorder -------------------------*/
+/************************************************************/
+
+void UParkourMovementComponent::StartRecording()
+{
+	if (!Character || Player.IsPlaying()) {
+		return;
+	}
+
+	const FString Path = FParkourRecorder::MakeRecordingPath(Character->GetName());
+	if (Recorder.Start(Path, FixedTimeStep, MakeRecordingInitialState())) {
+		WakeUp();
+		UE_LOG(LogTemp, Display, TEXT("Parkour Movement Component_StartRecording: Recording %s to %s."), *Character->GetName(), *Path);
+	}
+}
+
+void UParkourMovementComponent::StopRecording()
+{
+	if (Recorder.IsRecording()) {
+		Recorder.Stop();
+		UE_LOG(LogTemp, Display, TEXT("Parkour Movement Component_StopRecording: Wrote %llu records to %s."), Recorder.GetNumRecords(), *Recorder.GetPath());
+	}
+}
+
+void UParkourMovementComponent::StartPlayback(const FString& Path)
+{
+	StopRecording();
+
+	if (!Character || !Player.Load(Path)) {
+		return;
+	}
+
+	if (!FMath::IsNearlyEqual(Player.GetFixedTimeStep(), FixedTimeStep)) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Movement Component_StartPlayback: %s was recorded at a %f step, playing back at %f."), *Path, Player.GetFixedTimeStep(), FixedTimeStep);
+	}
+
+	ApplyRecordingInitialState(Player.GetInitialState());
+
+	PlaybackTransitions = 0;
+	RecordedTransitions = 0;
+	MaxPlaybackDrift = 0.0;
+
+	WakeUp();
+}
+
+void UParkourMovementComponent::StopPlayback()
+{
+	if (!Player.IsPlaying()) {
+		return;
+	}
+
+	Player.Unload();
+	bHasPlaybackInput = false;
+
+	UE_LOG(LogTemp, Display, TEXT("Parkour Movement Component_StopPlayback: %u of %u recorded transitions made, drifted up to %.1f units from the recording."),
+		PlaybackTransitions, RecordedTransitions, MaxPlaybackDrift);
+}
+
+void UParkourMovementComponent::RecordEvent(EParkourRecordedEvent Event)
+{
+	if (Recorder.IsRecording() && !IsReplayingMove()) {
+		Recorder.RecordEvent(Event);
+	}
+}
+
+static_assert((int32)EParkourTimer::Count <= FParkourRecordingInitialState::MaxTimers, "Every timer has to fit in a recording");
+
+FParkourRecordingInitialState UParkourMovementComponent::MakeRecordingInitialState() const
+{
+	FParkourPredictedState Parkour;
+	GatherPredictedState(Parkour);
+
+	FParkourRecordingInitialState State;
+	State.Rotation = Character->GetActorQuat();
+	State.Location = Character->GetActorLocation();
+	State.Velocity = CharacterMovementComponent->Velocity;
+	State.MovementMode = CharacterMovementComponent->MovementMode;
+	State.Mode = (uint8)Parkour.Mode;
+	State.GateMask = Parkour.GateMask;
+	State.ArmedTimers = Parkour.ArmedTimers;
+	State.bSlideQueued = Parkour.bSlideQueued;
+	State.bSprintQueued = Parkour.bSprintQueued;
+	State.UpdateAccumulator = Parkour.UpdateAccumulator;
+	FMemory::Memcpy(State.TimerRemaining, Parkour.TimerRemaining, sizeof(Parkour.TimerRemaining));
+	return State;
+}
+
+void UParkourMovementComponent::ApplyRecordingInitialState(const FParkourRecordingInitialState& State)
+{
+	// Into the recorded mode through its entry actions, so the mode's movement settings come with it
+	SetParkourMovementMode((EParkourMovement)FMath::Min<uint8>(State.Mode, NumParkourModes - 1));
+
+	FParkourPredictedState Parkour;
+	Parkour.Mode = Runtime.GetCurrentMode();
+	Parkour.GateMask = State.GateMask;
+	Parkour.ArmedTimers = State.ArmedTimers;
+	Parkour.bSlideQueued = State.bSlideQueued != 0;
+	Parkour.bSprintQueued = State.bSprintQueued != 0;
+	FMemory::Memcpy(Parkour.TimerRemaining, State.TimerRemaining, sizeof(Parkour.TimerRemaining));
+	ApplyServerPredictedState(Parkour, 0.0f);
+	UpdateAccumulator = State.UpdateAccumulator;
+
+	// The entry actions may have changed the movement mode and velocity, the recording's come last
+	Character->SetActorLocationAndRotation(State.Location, State.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	CharacterMovementComponent->SetMovementMode((EMovementMode)FMath::Min<uint8>(State.MovementMode, MOVE_Custom));
+	CharacterMovementComponent->Velocity = State.Velocity;
+	PlaybackLocation = State.Location;
+}
+
+bool UParkourMovementComponent::FeedPlayback()
+{
+	// The predicates have to see the recorded input, not the batch gathered from the live one
+	bHasBatchedPredicates = false;
+	bFeedingPlayback = true;
+
+	bool bReachedStep = false;
+	FParkourRecord Record;
+	while (!bReachedStep && Player.Read(Record)) {
+		switch (Record.Type) {
+		case EParkourRecordType::Event:
+			if (Record.Event == EParkourRecordedEvent::Jump) {
+				// The character Blueprint jumps the character along with the component
+				Character->Jump();
+				Jump();
+			}
+			else if (Record.Event == EParkourRecordedEvent::CrouchSlide) {
+				CrouchSlide();
+			}
+			else if (Record.Event == EParkourRecordedEvent::Sprint) {
+				Sprint();
+			}
+			break;
+		case EParkourRecordType::Transition:
+			++RecordedTransitions;
+			break;
+		case EParkourRecordType::Step:
+			// Steers the character's next move as well as this step's predicates
+			bHasPlaybackInput = true;
+			PlaybackInput = Record.Input;
+			PlaybackLocation = Record.Location;
+			Character->AddMovementInput(Record.Input);
+			bReachedStep = true;
+			break;
+		}
+	}
+
+	bFeedingPlayback = false;
+	return bReachedStep;
 }
 
 /************************************************************/
-/*------------------------ Events --------------------------*/
+/*------------------- Deferred Events ----------------------*/
 /************************************************************/
-void UParkourMovementComponent::EndEvents()
+bool UParkourMovementComponent::IsReplayingMove() const
 {
-	WallRunEnd(0);
-	VerticalWallRunEnd(0);
-	SprintEnd();
-	SlideEnd(false);
+	return ParkourCharacterMovement && ParkourCharacterMovement->bClientUpdating;
+}
+
+void UParkourMovementComponent::QueueEvent(EParkourEventFlags Event)
+{
+	if (!IsReplayingMove()) {
+		PendingEvents.Flags |= Event;
+	}
+}
+
+void UParkourMovementComponent::QueueParkourChanged(EParkourMovement PrevMode, EParkourMovement NewMode)
+{
+	if (IsReplayingMove()) {
+		return;
+	}
+
+	if (!PendingEvents.bParkourChanged) {
+		PendingEvents.bParkourChanged = true;
+		PendingEvents.ParkourChangedFrom = PrevMode;
+	}
+	PendingEvents.ParkourChangedTo = NewMode;
+}
+
+void UParkourMovementComponent::QueueMovementChanged(EMovementMode PrevMode, EMovementMode NewMode)
+{
+	if (IsReplayingMove()) {
+		return;
+	}
+
+	if (!PendingEvents.bMovementChanged) {
+		PendingEvents.bMovementChanged = true;
+		PendingEvents.MovementChangedFrom = PrevMode;
+	}
+	PendingEvents.MovementChangedTo = NewMode;
+}
+
+void UParkourMovementComponent::QueueWallRunEnd(float ResetTime)
+{
+	if (IsReplayingMove()) {
+		return;
+	}
+
+	PendingEvents.bWallRunEnd = true;
+	PendingEvents.WallRunEndResetTime = ResetTime;
+}
+
+void UParkourMovementComponent::FlushEvents()
+{
+	if (PendingEvents.IsEmpty()) {
+		return;
+	}
+
+	// Listeners may call back into the component, anything they raise goes out with the next flush
+	const FParkourPendingEvents Events = PendingEvents;
+	PendingEvents = FParkourPendingEvents();
+
+	// A bounce back to the mode the frame started in is no change at all
+	if (Events.bMovementChanged && (Events.MovementChangedFrom != Events.MovementChangedTo)) {
+		OnMovementChanged.Broadcast(Events.MovementChangedFrom, Events.MovementChangedTo);
+	}
+	if (Events.bParkourChanged && (Events.ParkourChangedFrom != Events.ParkourChangedTo)) {
+		OnParkourChanged.Broadcast(Events.ParkourChangedFrom, Events.ParkourChangedTo);
+	}
+	if (Events.bWallRunEnd) {
+		OnWallRunEnd.Broadcast(Events.WallRunEndResetTime);
+	}
+	if (EnumHasAnyFlags(Events.Flags, EParkourEventFlags::Jump)) {
+		OnJumpEvent.Broadcast();
+	}
+	if (EnumHasAnyFlags(Events.Flags, EParkourEventFlags::Land)) {
+		OnLandEvent.Broadcast();
+	}
+	if (EnumHasAnyFlags(Events.Flags, EParkourEventFlags::Sprint)) {
+		OnSprintEvent.Broadcast();
+	}
+	if (EnumHasAnyFlags(Events.Flags, EParkourEventFlags::CrouchSlide)) {
+		OnCrouchSlideEvent.Broadcast();
+	}
+	if (EnumHasAnyFlags(Events.Flags, EParkourEventFlags::QueuesCheck)) {
+		OnQueuesCheckEvent.Broadcast();
+	}
+	if (EnumHasAnyFlags(Events.Flags, EParkourEventFlags::Update)) {
+		OnUpdateEvent.Broadcast();
+	}
 }
 
-void UParkourMovementComponent::JumpEvent()
+/************************************************************/
+/*------------------ Animation Snapshot --------------------*/
+/************************************************************/
+
+void UParkourMovementComponent::PublishAnimSnapshot()
 {
-	WallRunJump();
-	LedgeGrabJump();
-	SlideJump();
-	CrouchJump();
-	SprintJump();
+	if (!Character || !CharacterMovementComponent) {
+		return;
+	}
+
+	const EParkourMovement Mode = Runtime.GetCurrentMode();
+
+	FParkourAnimSnapshot Snapshot;
+	Snapshot.Mode = Mode;
+	Snapshot.TimeInMode = (float)(GetWorld()->GetTimeSeconds() - ModeEnterTime);
+	Snapshot.FrameNumber = GFrameCounter;
+
+	if (ParkourRules::IsWallRunning(Mode)) {
+		Snapshot.Side = (Mode == EParkourMovement::LeftWallRun) ? EParkourWallSide::Left : EParkourWallSide::Right;
+		Snapshot.WallNormal = Character->GetActorQuat().UnrotateVector(Runtime.WallRunNormal);
+	}
+	else if (ParkourRules::IsOnWall(Mode)) {
+		Snapshot.Side = EParkourWallSide::Front;
+		Snapshot.WallNormal = Character->GetActorQuat().UnrotateVector(Runtime.VerticalWallRunNormal);
+	}
+
+	if ((Mode == EParkourMovement::LedgeGrab) || (Mode == EParkourMovement::Mantle)) {
+		const float FeetZ = Character->GetActorLocation().Z - Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		Snapshot.LedgeHeight = Runtime.LedgeFloorPosition.Z - FeetZ;
+	}
+
+	if (Mode == EParkourMovement::Mantle) {
+		// The mantle's move may already be done and waiting for the mode to end
+		const TSharedPtr<FRootMotionSource> Move = CharacterMovementComponent->GetRootMotionSource(ParkourMantleMoveName);
+		Snapshot.MantleProgress = (Move.IsValid() && (Move->GetDuration() > 0.0f)) ? FMath::Clamp(Move->GetTime() / Move->GetDuration(), 0.0f, 1.0f) : 1.0f;
+	}
+
+	const FFindFloorResult& Floor = CharacterMovementComponent->CurrentFloor;
+	if (CharacterMovementComponent->IsMovingOnGround() && Floor.IsWalkableFloor()) {
+		FVector Direction = CharacterMovementComponent->Velocity.GetSafeNormal2D();
+		if (Direction.IsZero()) {
+			Direction = Character->GetActorForwardVector().GetSafeNormal2D();
+		}
+		Snapshot.SlideSlope = FMath::RadiansToDegrees(FMath::Asin(FMath::Clamp(FVector::DotProduct(Floor.HitResult.ImpactNormal, Direction), -1.0f, 1.0f)));
+	}
+
+	AnimSnapshot.Publish(Snapshot);
 }
 
 /************************************************************/
@@ -962,45 +2015,41 @@ void UParkourMovementComponent::OpenGates()
 
 void UParkourMovementComponent::CloseGates()
 {
-	CloseWallRunGate();
-	CloseVerticalWallRunGate();
-	CloseSlideGate();
-	CloseSprintGate();
+	Runtime.GateMask = ParkourRules::CloseGates(Runtime.GateMask, ParkourRules::AirborneGates);
 }
 
 void UParkourMovementComponent::OpenMovementGates()
 {
-	if ((PreviousMovementMode == EMovementMode::MOVE_Walking) && (CurrentMovementMode == EMovementMode::MOVE_Falling))
+	if ((Runtime.PreviousMovementMode == EMovementMode::MOVE_Walking) && (Runtime.CurrentMovementMode == EMovementMode::MOVE_Falling))
 	{
-		SprintJump();
-		EndEvents();
+		FireTrigger(EParkourTrigger::Fall);
 		OpenGates();
 	}
-	else if ((PreviousMovementMode == EMovementMode::MOVE_Falling) && (CurrentMovementMode == EMovementMode::MOVE_Walking)) {
+	else if ((Runtime.PreviousMovementMode == EMovementMode::MOVE_Falling) && (Runtime.CurrentMovementMode == EMovementMode::MOVE_Walking)) {
 		CheckQueues();
 	}
 }
 
 void UParkourMovementComponent::WallRunGate()
 {
-	if (IsWallrunGateOpen) {
+	if (Runtime.IsGateOpen(EParkourGate::WallRun)) {
 		WallRunUpdate();
 	}
 }
 
 void UParkourMovementComponent::OpenWallRunGate()
 {
-	IsWallrunGateOpen = true;
+	Runtime.SetGateOpen(EParkourGate::WallRun, true);
 }
 
 void UParkourMovementComponent::CloseWallRunGate()
 {
-	IsWallrunGateOpen = false;
+	Runtime.SetGateOpen(EParkourGate::WallRun, false);
 }
 
 void UParkourMovementComponent::VerticalWallRunGate()
 {
-	if (IsVerticalWallrunGateOpen) {
+	if (Runtime.IsGateOpen(EParkourGate::VerticalWallRun)) {
 		VerticalWallRunUpdate();
 	}
 }
@@ -1011,82 +2060,81 @@ void UParkourMovementComponent::OpenVerticalWallRunGate()
 	// If this value is 0, VerticalWallRun is Unlimited and will not fall.
 	// If this does have a value, the character's vertical wall run will end after a set amount of time.
 
-	if (VerticalWallRunTime > 0) {
-		GetWorld()->GetTimerManager().SetTimer(VerticalWallRunEndEventHandle, this, &UParkourMovementComponent::VerticalWallRunEndEvent, VerticalWallRunTime, false);
+	if (GetSettings().VerticalWallRunTime > 0) {
+		ArmTimer(EParkourTimer::VerticalWallRunEnd, GetSettings().VerticalWallRunTime);
 	}
 
-	IsVerticalWallrunGateOpen = true;
+	Runtime.SetGateOpen(EParkourGate::VerticalWallRun, true);
 }
 
 void UParkourMovementComponent::CloseVerticalWallRunGate()
 {
-	IsVerticalWallrunGateOpen = false;
-	CloseMantleGate();
+	Runtime.GateMask = ParkourRules::CloseGates(Runtime.GateMask, EParkourGate::VerticalWallRun);
 }
 
 void UParkourMovementComponent::SlideGate()
 {
-	if (IsSlideGateOpen) {
+	if (Runtime.IsGateOpen(EParkourGate::Slide)) {
 		SlideUpdate();
 	}
 }
 
 void UParkourMovementComponent::OpenSlideGate()
 {
-	IsSlideGateOpen = true;
+	Runtime.SetGateOpen(EParkourGate::Slide, true);
 }
 
 void UParkourMovementComponent::CloseSlideGate()
 {
-	IsSlideGateOpen = false;
+	Runtime.SetGateOpen(EParkourGate::Slide, false);
 }
 
 void UParkourMovementComponent::SprintGate()
 {
-	if (IsSprintGateOpen) {
+	if (Runtime.IsGateOpen(EParkourGate::Sprint)) {
 		SprintUpdate();
 	}
 }
 
 void UParkourMovementComponent::OpenSprintGate()
 {
-	IsSprintGateOpen = true;
+	Runtime.SetGateOpen(EParkourGate::Sprint, true);
 }
 
 void UParkourMovementComponent::CloseSprintGate()
 {
-	IsSprintGateOpen = false;
+	Runtime.SetGateOpen(EParkourGate::Sprint, false);
 }
 
 void UParkourMovementComponent::MantleCheck()
 {
-	if (MacroCanMantle()) {
+	if (CanMantle()) {
 		MantleStart();
 	}
 }
 
 void UParkourMovementComponent::MantleCheckGate()
 {
-	if (IsMantleCheckGateOpen) {
+	if (Runtime.IsGateOpen(EParkourGate::MantleCheck)) {
 		MantleCheck();
 	}
 }
 
 void UParkourMovementComponent::OpenMantleCheckGate()
 {
-	IsMantleCheckGateOpen = true;
+	Runtime.SetGateOpen(EParkourGate::MantleCheck, true);
 }
 
 void UParkourMovementComponent::CloseMantleCheckGate()
 {
-	IsMantleCheckGateOpen = false;
+	Runtime.SetGateOpen(EParkourGate::MantleCheck, false);
 }
 
 void UParkourMovementComponent::MantleStart()
 {
 	if (SetParkourMovementMode(EParkourMovement::Mantle)) {
 
-		if (MacroQuickMantle()) {
+		if (IsQuickMantle()) {
 			// Broadcast QuickMantle Camera Shake
 			//OnCameraShakeEvent.Broadcast();
 		}
@@ -1096,24 +2144,25 @@ void UParkourMovementComponent::MantleStart()
 		}
 		CloseMantleCheckGate();
 		OpenMantleGate();
+		StartMantleMove();
 	}
 }
 
 void UParkourMovementComponent::MantleGate()
 {
-	if (IsMantleGateOpen) {
+	if (Runtime.IsGateOpen(EParkourGate::Mantle)) {
 		MantleMovement();
 	}
 }
 
 void UParkourMovementComponent::OpenMantleGate()
 {
-	IsMantleGateOpen = true;
+	Runtime.SetGateOpen(EParkourGate::Mantle, true);
 }
 
 void UParkourMovementComponent::CloseMantleGate()
 {
-	IsMantleGateOpen = false;
+	Runtime.SetGateOpen(EParkourGate::Mantle, false);
 }
 
 /************************************************************/
@@ -1121,128 +2170,418 @@ void UParkourMovementComponent::CloseMantleGate()
 /************************************************************/
 void UParkourMovementComponent::UpdateSequence()
 {
-	WallRunGate();
-	VerticalWallRunGate();
-	MantleCheckGate();
-	MantleGate();
-	SlideGate();
-	SprintGate();
-	//CameraTick();
+	PARKOUR_SCOPE_CYCLE_COUNTER(UpdateSequence);
+
+	LedgeGrabHang();
+
+	{
+		PARKOUR_SCOPE_CYCLE_COUNTER(WallRunGate);
+		WallRunGate();
+	}
+	{
+		PARKOUR_SCOPE_CYCLE_COUNTER(VerticalWallRunGate);
+		VerticalWallRunGate();
+	}
+	{
+		PARKOUR_SCOPE_CYCLE_COUNTER(MantleCheckGate);
+		MantleCheckGate();
+	}
+	{
+		PARKOUR_SCOPE_CYCLE_COUNTER(MantleGate);
+		MantleGate();
+	}
+	{
+		PARKOUR_SCOPE_CYCLE_COUNTER(SlideGate);
+		SlideGate();
+	}
+	{
+		PARKOUR_SCOPE_CYCLE_COUNTER(SprintGate);
+		SprintGate();
+	}
 }
 
 /************************************************************/
-/*----------------------- Macros ---------------------------*/
+/*--------------------- Predicates -------------------------*/
 /************************************************************/
 
-/* Macro - Wall Running */
-bool UParkourMovementComponent::MacroCanWallRun()
+/* Wall Running */
+bool UParkourMovementComponent::CanWallRun()
+{
+	if (bHasBatchedPredicates) {
+		return BatchedPredicates.bCanWallRun;
+	}
+
+	return ParkourRules::CanWallRun(ForwardInput(), Runtime.GetCurrentMode());
+}
+
+bool UParkourMovementComponent::IsWallRunning()
+{
+	return ParkourRules::IsWallRunning(Runtime.GetCurrentMode());
+}
+
+bool UParkourMovementComponent::IsValidWallRunNormal(FVector InVector)
+{
+	return ParkourRules::IsValidWallRunNormal(InVector);
+}
+
+/* Input */
+float UParkourMovementComponent::ForwardInput()
 {
-	bool results = false;
-	float MyFloat = MacroForwardInput();
-	bool MyBool = MacroWallRunning();
-	bool MacroResults = CanWallRun(MyFloat, CurrentParkourMode, MyBool);
+	if (bHasPlaybackInput) {
+		return ParkourRules::ForwardInput(Character->GetActorForwardVector(), PlaybackInput);
+	}
+
+	if (bHasBatchedPredicates) {
+		return BatchedPredicates.ForwardInputValue;
+	}
+
+	return ParkourRules::ForwardInput(Character->GetActorForwardVector(), Character->GetCharacterMovement()->GetLastInputVector());
+}
 
-	if (MacroResults) {
-		results = true;
+/* Vertical Wall Running */
+bool UParkourMovementComponent::CanVerticalWallRun()
+{
+	if (bHasBatchedPredicates) {
+		return BatchedPredicates.bCanVerticalWallRun;
 	}
 
-	return results;
+	return ParkourRules::CanVerticalWallRun(ForwardInput(), Runtime.GetCurrentMode(), CharacterMovementComponent->IsFalling());
 }
 
-bool UParkourMovementComponent::MacroWallRunning()
+/* Mantling */
+bool UParkourMovementComponent::CanMantle()
 {
-	bool results = false;
+	return ParkourRules::CanMantle(ForwardInput(), Runtime.GetCurrentMode(), IsQuickMantle());
+}
+
+bool UParkourMovementComponent::IsQuickMantle()
+{
+	return ParkourRules::IsQuickMantle(Runtime.MantleTraceDistance, GetSettings().MantleHeight, Runtime.bLedgeCloseToGround);
+}
+
+/* Sliding */
+bool UParkourMovementComponent::CanSlide()
+{
+	if (bHasBatchedPredicates) {
+		return BatchedPredicates.bCanSlide;
+	}
+
+	return ParkourRules::CanSlide(ForwardInput(), Runtime.GetCurrentMode(), Runtime.bSprintQueued);
+}
 
-	if (WallRunning(CurrentParkourMode)) {
-		results = true;
+/* Sprinting */
+bool UParkourMovementComponent::CanSprint()
+{
+	if (bHasBatchedPredicates) {
+		return BatchedPredicates.bCanSprint;
 	}
 
-	return results;
+	return ParkourRules::CanSprint(CharacterMovementComponent->IsWalking(), Runtime.GetCurrentMode());
+}
+
+/************************************************************/
+/*------------------- Batched Update -----------------------*/
+/************************************************************/
+
+void FParkourAgentHotState::EvaluatePredicates()
+{
+	// Same rules as the predicate functions above, evaluated from the gathered copy of the inputs.
+	ForwardInputValue = ParkourRules::ForwardInput(ForwardVector, LastInputVector);
+
+	bCanWallRun = ParkourRules::CanWallRun(ForwardInputValue, CurrentParkourMode);
+	bCanVerticalWallRun = ParkourRules::CanVerticalWallRun(ForwardInputValue, CurrentParkourMode, bIsFalling);
+	bCanSlide = ParkourRules::CanSlide(ForwardInputValue, CurrentParkourMode, bSprintQueued);
+	bCanSprint = ParkourRules::CanSprint(bIsWalking, CurrentParkourMode);
+}
+
+void UParkourMovementComponent::GatherHotState(FParkourAgentHotState& OutState) const
+{
+	OutState.ForwardVector = Character->GetActorForwardVector();
+	OutState.LastInputVector = CharacterMovementComponent->GetLastInputVector();
+	OutState.CurrentParkourMode = Runtime.GetCurrentMode();
+	OutState.bIsFalling = CharacterMovementComponent->IsFalling();
+	OutState.bIsWalking = CharacterMovementComponent->IsWalking();
+	OutState.bSprintQueued = Runtime.bSprintQueued;
+}
+
+void UParkourMovementComponent::ApplyBatchedPredicates(const FParkourAgentHotState& State)
+{
+	BatchedPredicates = State;
+	bHasBatchedPredicates = true;
 }
+/************************************************************/
+/*---------------------- Prediction ------------------------*/
+/************************************************************/
 
-FVector UParkourMovementComponent::MacroWallRunEndVectorsLeft()
+bool UParkourMovementComponent::IsUpdatedByMovement() const
 {
-	return WallRunEndLeft(Character->GetActorLocation(), Character->GetActorRightVector(), Character->GetActorForwardVector());
+	return ParkourCharacterMovement && ParkourCharacterMovement->IsUpdatingParkour();
 }
 
-FVector UParkourMovementComponent::MacroWallRunEndVectorsRight()
+uint8 UParkourMovementComponent::GetGateMask() const
 {
-	return WallRunEndRight(Character->GetActorLocation(), Character->GetActorRightVector(), Character->GetActorForwardVector());
+	return Runtime.GateMask;
 }
 
-bool UParkourMovementComponent::MacroValidWallRunVector(FVector InVector)
+void UParkourMovementComponent::SetGateMask(uint8 GateMask)
 {
-	MacroOutValidWallRunVector = InVector;
-	return ValidWallRunVector(InVector);
+	// Only the gate bits, the mask may have come off the wire
+	Runtime.GateMask = GateMask & AllParkourGates;
 }
 
-/* Macro - Input */
-float UParkourMovementComponent::MacroForwardInput()
+bool UParkourMovementComponent::DeferPress(EParkourPress Press)
 {
-	return ForwardInput(Character->GetActorForwardVector(), Character->GetCharacterMovement()->GetLastInputVector());
+	if (bRunningPresses || !IsUpdatedByMovement()) {
+		return false;
+	}
+
+	WakeUp();
+	PendingPresses |= Press;
+	return true;
 }
 
-/* Macro - Vertical Wall Running */
-bool UParkourMovementComponent::MacroCanVerticalWallRun()
+void UParkourMovementComponent::RunPendingPresses()
 {
-	bool results = false;
-	float MyFloat = MacroForwardInput();
-	bool MyBool = CharacterMovementComponent->IsFalling();
-	bool MySecondBool = MacroWallRunning();
+	if (PendingPresses == EParkourPress::None) {
+		return;
+	}
+
+	const EParkourPress Presses = PendingPresses;
+	PendingPresses = EParkourPress::None;
+
+	// In the order a frame's input usually comes in, a sprint held into a jump sprints first
+	bRunningPresses = true;
+	if (EnumHasAnyFlags(Presses, EParkourPress::Sprint)) {
+		Sprint();
+	}
+	if (EnumHasAnyFlags(Presses, EParkourPress::CrouchSlide)) {
+		CrouchSlide();
+	}
+	if (EnumHasAnyFlags(Presses, EParkourPress::Jump)) {
+		Jump();
+	}
+	bRunningPresses = false;
+}
 
-	results = CanVerticalWallRun(MyFloat, CurrentParkourMode, MyBool, MySecondBool);
+void UParkourMovementComponent::GatherPredictedState(FParkourPredictedState& OutState) const
+{
+	OutState.Presses = PendingPresses;
+	OutState.Mode = Runtime.GetCurrentMode();
+	OutState.GateMask = GetGateMask();
+	OutState.bSlideQueued = Runtime.bSlideQueued;
+	OutState.bSprintQueued = Runtime.bSprintQueued;
+	OutState.UpdateAccumulator = UpdateAccumulator;
 
-	return results;
+	const double Now = GetStepWorldTime();
+	OutState.ArmedTimers = ArmedTimers;
+	for (int32 Index = 0; Index < (int32)EParkourTimer::Count; ++Index) {
+		OutState.TimerRemaining[Index] = (ArmedTimers & (1 << Index)) ? FMath::Max((float)(TimerDeadlines[Index] - Now), 0.0f) : 0.0f;
+	}
 }
 
-/* Macro - Mantling */
-FVector UParkourMovementComponent::MacroMantleVectorsEyes()
+void UParkourMovementComponent::RestorePredictedInputs(const FParkourPredictedState& State)
 {
-	FVector EyesVector;
-	FRotator EyesRotator;
-	Character->GetController()->GetActorEyesViewPoint(EyesVector, EyesRotator);
+	PendingPresses = State.Presses;
+	UpdateAccumulator = State.UpdateAccumulator;
+}
 
-	FVector ForwardVector = Character->GetActorForwardVector();
+void UParkourMovementComponent::ApplyServerPredictedState(const FParkourPredictedState& State, float SecondsAgo)
+{
+	// Raw restore, the server ran the transition into this state and the replayed moves run any after it
+	if (State.Mode != Runtime.GetCurrentMode()) {
+		// The walk speed is the one movement setting a mode holds across moves, the replayed moves walk at the server's
+		if ((State.Mode == EParkourMovement::Sprint) || (Runtime.GetCurrentMode() == EParkourMovement::Sprint)) {
+			CharacterMovementComponent->MaxWalkSpeed = (State.Mode == EParkourMovement::Sprint) ? GetSettings().SprintSpeed : DefaultMaxWalkSpeed;
+		}
 
-	FVector Results = ((EyesVector + FVector(0, 0, 50)) + (ForwardVector * 50.0f));
+		Runtime.SetModes(Runtime.GetCurrentMode(), State.Mode);
+		bHasBatchedPredicates = false;
+	}
 
-	//return Results;
+	SetGateMask(State.GateMask);
+	Runtime.bSlideQueued = State.bSlideQueued;
+	Runtime.bSprintQueued = State.bSprintQueued;
 
-	return MantleVectorEyes(EyesVector, ForwardVector);
+	// The timers were read when the corrected move was made, they count down from then
+	const double CorrectionTime = GetWorld()->GetTimeSeconds() - SecondsAgo;
+	ArmedTimers = State.ArmedTimers & ((1 << (uint8)EParkourTimer::Count) - 1);
+	for (int32 Index = 0; Index < (int32)EParkourTimer::Count; ++Index) {
+		TimerDeadlines[Index] = (ArmedTimers & (1 << Index)) ? (CorrectionTime + State.TimerRemaining[Index]) : 0.0;
+	}
 }
 
-FVector UParkourMovementComponent::MacroMantleVectorsFeet()
+/************************************************************/
+/*--------------------- Replication ------------------------*/
+/************************************************************/
+
+void UParkourMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	FVector LocationVector = Character->GetActorLocation();
-	float CapsuleHalfHeight = Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-	float mHeight = MantleHeight;
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	FVector ForwardVector = Character->GetActorForwardVector();
+	FDoRepLifetimeParams Params;
+	Params.Condition = COND_SimulatedOnly;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UParkourMovementComponent, ReplicatedState, Params);
+}
 
-	FVector Results = ((LocationVector - FVector(0, 0, (CapsuleHalfHeight - mHeight))) + (ForwardVector * 50.0f));
-	//return Results;
+bool UParkourMovementComponent::IsSimulatedProxy() const
+{
+	return Character && (Character->GetLocalRole() == ROLE_SimulatedProxy);
+}
 
-	return MantleVectorFeet(LocationVector, CapsuleHalfHeight, mHeight, ForwardVector);
+double UParkourMovementComponent::GetReplicatedStateBytesPerSecond() const
+{
+	const double Elapsed = GetWorld() ? (GetWorld()->GetTimeSeconds() - ReplicationStartTime) : 0.0;
+	return (Elapsed > 0.0) ? ((ReplicatedStateBits / 8.0) / Elapsed) : 0.0;
 }
 
-bool UParkourMovementComponent::MacroCanMantle()
+void UParkourMovementComponent::UpdateReplicatedState()
 {
-	return CanMantle(MacroForwardInput(), CurrentParkourMode, MacroQuickMantle());
+	if (!Character || !GetIsReplicated() || (Character->GetLocalRole() != ROLE_Authority) || (GetNetMode() == NM_Standalone)) {
+		return;
+	}
+
+	const EParkourMovement Mode = Runtime.GetCurrentMode();
+
+	FParkourReplicatedState State;
+	State.Mode = Mode;
+	if (ParkourRules::IsWallRunning(Mode)) {
+		State.WallNormal = Runtime.WallRunNormal;
+		State.Target = WallRunTargetVector();
+	}
+	else if (Mode == EParkourMovement::VerticalWallRun) {
+		State.WallNormal = Runtime.VerticalWallRunNormal;
+		State.Target = VerticalWallRunTargetLocation();
+	}
+	else if (Mode == EParkourMovement::LedgeGrab) {
+		State.WallNormal = Runtime.LedgeClimbWallNormal;
+		State.Target = LedgeTargetLocation();
+	}
+	else if (Mode == EParkourMovement::Mantle) {
+		State.WallNormal = Runtime.LedgeClimbWallNormal;
+		State.Target = Runtime.MantlePosition;
+	}
+	State.Quantize();
+
+	// A wall run's target slides along the wall every step, a point further along the same wall isn't a change
+	const bool bRunningAlongWall = ParkourRules::IsWallRunning(Mode) || (Mode == EParkourMovement::VerticalWallRun);
+	if (bRunningAlongWall && (State.Mode == ReplicatedState.Mode) && (State.WallNormal == ReplicatedState.WallNormal)
+		&& (FMath::Abs(FVector::DotProduct(State.Target - ReplicatedState.Target, State.WallNormal)) < ParkourPlaneTolerance)) {
+		State.Target = ReplicatedState.Target;
+	}
+
+	if (State == ReplicatedState) {
+		return;
+	}
+
+	ReplicatedState = State;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UParkourMovementComponent, ReplicatedState, this);
+
+	const int32 Bits = ReplicatedState.CountBits();
+	++ReplicatedStateChanges;
+	ReplicatedStateBits += Bits;
+	INC_DWORD_STAT_BY(STAT_ParkourNetStateBits, Bits);
 }
 
-bool UParkourMovementComponent::MacroQuickMantle()
+void UParkourMovementComponent::OnRep_ReplicatedState()
 {
-	return QuickMantle(MantleTraceDistance, MantleHeight, LedgeCloseToGround);
+	const int32 Bits = ReplicatedState.CountBits();
+	++ReplicatedStateChanges;
+	ReplicatedStateBits += Bits;
+	INC_DWORD_STAT_BY(STAT_ParkourNetStateBits, Bits);
+
+	// Before Initialize there's no character to apply it to, Initialize picks it up
+	if (Character && CharacterMovementComponent && IsSimulatedProxy()) {
+		WakeUp();
+		ApplyReplicatedState();
+	}
 }
 
-/* Macro - Sliding */
-bool UParkourMovementComponent::MacroCanSlide()
+void UParkourMovementComponent::ApplyReplicatedState()
 {
-	return CanSlide(MacroForwardInput(), CurrentParkourMode, SprintQueued);
+	const EParkourMovement PrevMode = Runtime.GetCurrentMode();
+	const EParkourMovement NewMode = ReplicatedState.Mode;
+	const FVector& Normal = ReplicatedState.WallNormal;
+
+	// The surfaces the animation snapshot reads
+	if (ParkourRules::IsWallRunning(NewMode)) {
+		Runtime.WallRunNormal = Normal;
+	}
+	else if (ParkourRules::IsOnWall(NewMode)) {
+		Runtime.VerticalWallRunNormal = Normal;
+		Runtime.LedgeClimbWallNormal = Normal;
+	}
+
+	const float HalfHeight = Character->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+	if (NewMode == EParkourMovement::LedgeGrab) {
+		Runtime.LedgeFloorPosition = ReplicatedState.Target + FVector(0, 0, HalfHeight);
+	}
+	else if (NewMode == EParkourMovement::Mantle) {
+		Runtime.MantlePosition = ReplicatedState.Target;
+		Runtime.LedgeFloorPosition = ReplicatedState.Target - FVector(0, 0, MantleZOffset());
+	}
+
+	// SimulateProxy sets the parkour gravity while it runs, the ground modes fall the usual way
+	if (!ReplicatedState.HasWall()) {
+		CharacterMovementComponent->GravityScale = DefaultGravity;
+	}
+
+	if (NewMode == PrevMode) {
+		return;
+	}
+
+	++TransitionCounts[(uint8)PrevMode][(uint8)NewMode];
+	Runtime.SetModes(PrevMode, NewMode);
+	ModeEnterTime = GetWorld()->GetTimeSeconds();
+
+	OnParkourModeChangedNative.Broadcast(PrevMode, NewMode);
+	QueueParkourChanged(PrevMode, NewMode);
 }
 
-/* Macro - Sprinting */
-bool UParkourMovementComponent::MacroCanSprint()
+void UParkourMovementComponent::SimulateProxy(float DeltaTime)
 {
-	return CanSprint(CharacterMovementComponent->IsWalking(), CurrentParkourMode);
-}
\ No newline at end of file
+	if (!Character || !CharacterMovementComponent || !ReplicatedState.HasWall()) {
+		return;
+	}
+
+	const UParkourMovementSettings& Tuning = GetSettings();
+	const EParkourMovement Mode = Runtime.GetCurrentMode();
+	const FVector& Normal = ReplicatedState.WallNormal;
+	const FVector Location = Character->GetActorLocation();
+
+	FVector Target = ReplicatedState.Target;
+	float TargetYaw = ParkourRules::FacingWallYaw(Normal);
+	float LocationSmoothing = Tuning.ProxyLocationSmoothing;
+
+	if (ParkourRules::IsWallRunning(Mode)) {
+		// Along the wall at the wall run's gravity, held on the line through the target
+		CharacterMovementComponent->Velocity = FVector::VectorPlaneProject(CharacterMovementComponent->Velocity, Normal);
+		CharacterMovementComponent->GravityScale = Tuning.WallRunTargetGravity;
+		Target = Location + (Normal * FVector::DotProduct(ReplicatedState.Target - Location, Normal));
+		TargetYaw = ParkourRules::WallRunTargetYaw(Normal, (Mode == EParkourMovement::LeftWallRun));
+	}
+	else if (Mode == EParkourMovement::VerticalWallRun) {
+		// Straight up, the server launches it up every step and gravity never gets a hold
+		CharacterMovementComponent->Velocity = FVector(0.0f, 0.0f, Tuning.VerticalWallRunSpeed);
+		CharacterMovementComponent->GravityScale = 0.0f;
+		Target = Location + (Normal * FVector::DotProduct(ReplicatedState.Target - Location, Normal));
+	}
+	else {
+		// Ledge grab and mantle are moved onto the target, nothing else should move them
+		CharacterMovementComponent->Velocity = FVector::ZeroVector;
+		CharacterMovementComponent->GravityScale = 0.0f;
+		if (Mode == EParkourMovement::Mantle) {
+			LocationSmoothing = Tuning.MantleSpeed;
+		}
+	}
+
+	// Exponential, the same curve the mantle's move follows, so a late update eases in instead of snapping
+	const float Alpha = 1.0f - FMath::Exp(-LocationSmoothing * DeltaTime);
+	if (!Target.Equals(Location, 0.1f)) {
+		Character->SetActorLocation(FMath::Lerp(Location, Target, Alpha));
+	}
+
+	const FRotator Rotation = Character->GetActorRotation();
+	const FRotator NewRotation = FMath::RInterpTo(Rotation, FRotator(Rotation.Pitch, TargetYaw, Rotation.Roll), DeltaTime, Tuning.ProxyRotationSmoothing);
+	Character->SetActorRotation(NewRotation);
+}
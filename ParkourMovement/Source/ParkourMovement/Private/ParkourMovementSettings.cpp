@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourMovementSettings.h"
+
+UParkourMovementSettings::UParkourMovementSettings()
+{
+	// High keeps the struct defaults, a full update near the players
+	MediumSignificance.MaxDistance = 6000.0f;
+	MediumSignificance.StepMultiplier = 2;
+	MediumSignificance.bLineTraceProbes = true;
+	MediumSignificance.bCosmetics = false;
+
+	LowSignificance.StepMultiplier = 4;
+	LowSignificance.bLineTraceProbes = true;
+	LowSignificance.bCosmetics = false;
+}
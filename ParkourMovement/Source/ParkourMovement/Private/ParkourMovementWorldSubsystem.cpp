@@ -0,0 +1,436 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourMovementWorldSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/PackageName.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "PBDRigidsSolver.h"
+#include "ParkourMovement/ParkourMovement.h"
+
+DECLARE_CYCLE_STAT(TEXT("Batched Update"), STAT_ParkourBatchedUpdate, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Gather Phase"), STAT_ParkourGatherPhase, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Predicate Phase"), STAT_ParkourPredicatePhase, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Update Phase"), STAT_ParkourUpdatePhase, STATGROUP_ParkourMovement);
+DECLARE_CYCLE_STAT(TEXT("Event Phase"), STAT_ParkourEventPhase, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Agents"), STAT_ParkourBatchedAgents, STATGROUP_ParkourMovement);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Batched Update (ms)"), STAT_ParkourBatchedUpdateMs, STATGROUP_ParkourMovement);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Batched Update per 100 Agents, Extrapolated (ms)"), STAT_ParkourBatchedUpdateMsPer100, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Probe Cache Hits"), STAT_ParkourProbeCacheHits, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Probe Cache Misses"), STAT_ParkourProbeCacheMisses, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Probe Cache Evictions"), STAT_ParkourProbeCacheEvictions, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Probe Cache Entries"), STAT_ParkourProbeCacheEntries, STATGROUP_ParkourMovement);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Probe Cache Hit Rate"), STAT_ParkourProbeCacheHitRate, STATGROUP_ParkourMovement);
+
+static FAutoConsoleCommandWithWorld ParkourProbeCacheReportCommand(
+	TEXT("Parkour.ProbeCacheReport"),
+	TEXT("Logs the world's probe cache hit rate since it was created, overall and for each probe type."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		static const TCHAR* ProbeNames[] = { TEXT("WallRunRight"), TEXT("WallRunLeft"), TEXT("LedgeFloor"), TEXT("LedgeWall"), TEXT("LedgeGround"), TEXT("SlideFloor") };
+		static_assert(UE_ARRAY_COUNT(ProbeNames) == (int32)EParkourProbe::Count, "Every probe needs a name");
+
+		UParkourMovementWorldSubsystem* Subsystem = World ? World->GetSubsystem<UParkourMovementWorldSubsystem>() : nullptr;
+		if (!Subsystem) {
+			return;
+		}
+
+		const FParkourProbeCache& Cache = Subsystem->GetProbeCache();
+		UE_LOG(LogTemp, Display, TEXT("Parkour Probe Cache Report: %.1f%% of %llu lookups hit, %u entries, %llu evictions."),
+			Cache.GetHitRate() * 100.0f, Cache.GetTotalHits() + Cache.GetTotalMisses(), Cache.GetNumEntries(), Cache.GetTotalEvictions());
+
+		for (int32 Probe = 0; Probe < (int32)EParkourProbe::Count; ++Probe) {
+			UE_LOG(LogTemp, Display, TEXT("Parkour Probe Cache Report: %s, %.1f%% of %llu lookups hit."),
+				ProbeNames[Probe], Cache.GetHitRate((EParkourProbe)Probe) * 100.0f, Cache.GetTotalLookups((EParkourProbe)Probe));
+		}
+	}));
+
+/************************************************************/
+/*---------------------- Subsystem -------------------------*/
+/************************************************************/
+
+bool UParkourMovementWorldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return (WorldType == EWorldType::Game) || (WorldType == EWorldType::PIE);
+}
+
+void UParkourMovementWorldSubsystem::Deinitialize()
+{
+	for (UParkourMovementComponent* Agent : Agents) {
+		if (IsValid(Agent)) {
+			Agent->BatchedUpdateIndex = INDEX_NONE;
+		}
+	}
+
+	Agents.Reset();
+	HotStates.Reset();
+	StepCounts.Reset();
+	PendingRegistrations.Reset();
+	Viewpoints.Reset();
+	ProbeCache.Empty();
+	SurfaceDatabase.Unload();
+
+	for (const TWeakObjectPtr<UParkourMovementComponent>& AsyncAgent : AsyncForceAgents) {
+		if (UParkourMovementComponent* Component = AsyncAgent.Get()) {
+			Component->AsyncForceId = INDEX_NONE;
+		}
+	}
+	AsyncForceAgents.Reset();
+	DestroyAsyncForceCallback();
+
+	Super::Deinitialize();
+}
+
+void UParkourMovementWorldSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Baked by the ParkourSurfaceBake commandlet, under the level's short name
+	const FString MapName = UWorld::RemovePIEPrefix(FPackageName::GetShortName(InWorld.GetOutermost()->GetName()));
+	SurfaceDatabase.Load(FParkourSurfaceDatabase::GetDatabasePath(MapName));
+}
+
+TStatId UParkourMovementWorldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UParkourMovementWorldSubsystem, STATGROUP_Tickables);
+}
+
+/************************************************************/
+/*----------------------- Registry -------------------------*/
+/************************************************************/
+
+void UParkourMovementWorldSubsystem::RegisterComponent(UParkourMovementComponent* Component)
+{
+	if (!IsValid(Component) || Component->BatchedUpdateIndex != INDEX_NONE) {
+		return;
+	}
+
+	if (bIsUpdating) {
+		PendingRegistrations.AddUnique(Component);
+	}
+	else {
+		AddAgent(Component);
+	}
+}
+
+void UParkourMovementWorldSubsystem::UnregisterComponent(UParkourMovementComponent* Component)
+{
+	PendingRegistrations.Remove(Component);
+
+	const int32 Index = Component->BatchedUpdateIndex;
+	if (!Agents.IsValidIndex(Index) || Agents[Index] != Component) {
+		return;
+	}
+
+	Component->BatchedUpdateIndex = INDEX_NONE;
+
+	if (bIsUpdating) {
+		// Keep the arrays stable while the phases walk them, the empty slot is compacted afterwards.
+		Agents[Index] = nullptr;
+	}
+	else {
+		RemoveAgent(Index);
+	}
+}
+
+void UParkourMovementWorldSubsystem::AddAgent(UParkourMovementComponent* Component)
+{
+	Component->BatchedUpdateIndex = Agents.Add(Component);
+	HotStates.AddDefaulted();
+	StepCounts.Add(0);
+}
+
+void UParkourMovementWorldSubsystem::RemoveAgent(int32 Index)
+{
+	Agents.RemoveAtSwap(Index, 1, false);
+	HotStates.RemoveAtSwap(Index, 1, false);
+	StepCounts.RemoveAtSwap(Index, 1, false);
+
+	// The last agent was swapped into this slot
+	if (Agents.IsValidIndex(Index) && Agents[Index]) {
+		Agents[Index]->BatchedUpdateIndex = Index;
+	}
+}
+
+void UParkourMovementWorldSubsystem::FlushPendingRegistry()
+{
+	for (int32 Index = Agents.Num() - 1; Index >= 0; --Index) {
+		if (!IsValid(Agents[Index])) {
+			RemoveAgent(Index);
+		}
+	}
+
+	for (const TWeakObjectPtr<UParkourMovementComponent>& Pending : PendingRegistrations) {
+		if (UParkourMovementComponent* Component = Pending.Get()) {
+			if (Component->BatchedUpdateIndex == INDEX_NONE) {
+				AddAgent(Component);
+			}
+		}
+	}
+	PendingRegistrations.Reset();
+}
+
+/************************************************************/
+/*----------------- Async Physics Forces -------------------*/
+/************************************************************/
+
+void UParkourMovementWorldSubsystem::RegisterAsyncForces(UParkourMovementComponent* Component)
+{
+	if (!IsValid(Component) || (Component->AsyncForceId != INDEX_NONE)) {
+		return;
+	}
+
+	if (!AsyncForceCallback) {
+		FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+		if (!PhysScene || !PhysScene->GetSolver()) {
+			return;
+		}
+
+		// Without async physics the callback still runs, but on the game thread once per frame at the frame's delta
+		if (!UPhysicsSettings::Get()->bTickPhysicsAsync) {
+			UE_LOG(LogTemp, Warning, TEXT("Parkour RegisterAsyncForces: Tick Physics Async is off, the parkour forces follow the frame rate."));
+		}
+
+		AsyncForceCallback = PhysScene->GetSolver()->CreateAndRegisterSimCallbackObject_External<FParkourAsyncForceCallback>();
+	}
+
+	int32 Id = AsyncForceAgents.IndexOfByPredicate([](const TWeakObjectPtr<UParkourMovementComponent>& Agent) { return !Agent.IsValid(); });
+	if (Id == INDEX_NONE) {
+		Id = AsyncForceAgents.Add(Component);
+	}
+	else {
+		AsyncForceAgents[Id] = Component;
+	}
+
+	Component->AsyncForceId = Id;
+	Component->AsyncForces = FParkourAsyncForces();
+}
+
+void UParkourMovementWorldSubsystem::UnregisterAsyncForces(UParkourMovementComponent* Component)
+{
+	const int32 Id = Component->AsyncForceId;
+	if (AsyncForceAgents.IsValidIndex(Id) && (AsyncForceAgents[Id] == Component)) {
+		AsyncForceAgents[Id] = nullptr;
+	}
+	Component->AsyncForceId = INDEX_NONE;
+}
+
+void UParkourMovementWorldSubsystem::ApplyAsyncForceOutputs()
+{
+	// Every physics step since the last frame, added up per agent so each character takes a single velocity change
+	TArray<FVector, TInlineAllocator<64>> Deltas;
+	Deltas.SetNumZeroed(AsyncForceAgents.Num());
+
+	while (Chaos::TSimCallbackOutputHandle<FParkourAsyncForceOutput> Output = AsyncForceCallback->PopOutputData_External()) {
+		for (const FParkourAsyncForceAgentOutput& Agent : Output->Agents) {
+			if (Deltas.IsValidIndex(Agent.AgentId)) {
+				Deltas[Agent.AgentId] += Agent.VelocityDelta;
+			}
+		}
+	}
+
+	// Added as a velocity change impulse, which the movement component applies at the start of its next move on top
+	// of anything else queued, instead of overwriting it the way a launch does
+	for (int32 Id = 0; Id < Deltas.Num(); ++Id) {
+		UParkourMovementComponent* Component = AsyncForceAgents[Id].Get();
+		if (!Component || Deltas[Id].IsZero() || !Component->UsesAsyncPhysicsForces()) {
+			continue;
+		}
+
+		if (UCharacterMovementComponent* Movement = Component->CharacterMovementComponent) {
+			Movement->AddImpulse(Deltas[Id], true);
+		}
+	}
+}
+
+void UParkourMovementWorldSubsystem::PushAsyncForceInputs()
+{
+	FParkourAsyncForceInput* Input = AsyncForceCallback->GetProducerInputData_External();
+	Input->Reset();
+	Input->Sequence = ++AsyncForceSequence;
+
+	for (int32 Id = 0; Id < AsyncForceAgents.Num(); ++Id) {
+		UParkourMovementComponent* Component = AsyncForceAgents[Id].Get();
+		if (!Component || !Component->UsesAsyncPhysicsForces() || !Component->CharacterMovementComponent) {
+			continue;
+		}
+
+		// The stick holds for as long as the character stays in the wall run that asked for it
+		FParkourAsyncForces& Forces = Component->AsyncForces;
+		const EParkourMovement Mode = Component->GetCurrentParkourMode();
+		Forces.bStick &= (Mode == EParkourMovement::LeftWallRun) || (Mode == EParkourMovement::RightWallRun) || (Mode == EParkourMovement::VerticalWallRun);
+
+		if (Forces.bStick || !Forces.Impulse.IsZero()) {
+			FParkourAsyncForceAgentInput& Agent = Input->Agents.AddDefaulted_GetRef();
+			Agent.AgentId = Id;
+			Agent.Velocity = Component->CharacterMovementComponent->Velocity;
+			Agent.Forces = Forces;
+		}
+
+		Forces.Impulse = FVector::ZeroVector;
+	}
+}
+
+void UParkourMovementWorldSubsystem::DestroyAsyncForceCallback()
+{
+	if (!AsyncForceCallback) {
+		return;
+	}
+
+	FPhysScene* PhysScene = GetWorld() ? GetWorld()->GetPhysicsScene() : nullptr;
+	if (PhysScene && PhysScene->GetSolver()) {
+		PhysScene->GetSolver()->UnregisterAndFreeSimCallbackObject_External(AsyncForceCallback);
+	}
+	AsyncForceCallback = nullptr;
+}
+
+/************************************************************/
+/*------------------------ Update --------------------------*/
+/************************************************************/
+
+void UParkourMovementWorldSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParkourBatchedUpdate);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	FlushPendingRegistry();
+	GatherViewpoints();
+	bIsUpdating = true;
+
+	// Every agent owns its accumulator, so agents with different fixed steps, or significance buckets that
+	// stretch them, can share the pass. Agents whose character moves run the update are kept registered,
+	// in case they become simulated proxies.
+	int32 MaxSteps = 0;
+	for (int32 Index = 0; Index < Agents.Num(); ++Index) {
+		UParkourMovementComponent* Agent = Agents[Index];
+		if (IsValid(Agent)) {
+			Agent->UpdateSignificance();
+
+			// Simulated proxies follow the server's state instead of running the update
+			if (Agent->IsSimulatedProxy()) {
+				Agent->SimulateProxy(DeltaTime);
+			}
+		}
+
+		StepCounts[Index] = (IsValid(Agent) && !Agent->IsUpdatedByMovement() && !Agent->IsSimulatedProxy()) ? Agent->ConsumeFixedSteps(DeltaTime) : 0;
+		MaxSteps = FMath::Max(MaxSteps, StepCounts[Index]);
+	}
+
+	for (int32 Step = 0; Step < MaxSteps; ++Step) {
+		GatherPhase(Step);
+		PredicatePhase(Step);
+		UpdatePhase(Step);
+	}
+
+	EventPhase();
+
+	bIsUpdating = false;
+	FlushPendingRegistry();
+
+	// Last, so the forces of every update that ran this frame go out together
+	if (AsyncForceCallback) {
+		ApplyAsyncForceOutputs();
+		PushAsyncForceInputs();
+	}
+
+	const double ElapsedMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+	// The probe cache is shared with components that tick on their own, so it is kept up even with no batched agents
+	const double Now = GetWorld()->GetTimeSeconds();
+	if ((Now - LastProbeCacheSweepTime) >= ProbeCacheSweepInterval) {
+		ProbeCache.Sweep(Now);
+		LastProbeCacheSweepTime = Now;
+	}
+
+	uint32 CacheHits = 0;
+	uint32 CacheMisses = 0;
+	uint32 CacheEvictions = 0;
+	ProbeCache.ConsumeFrameCounters(CacheHits, CacheMisses, CacheEvictions);
+
+	SET_DWORD_STAT(STAT_ParkourProbeCacheHits, CacheHits);
+	SET_DWORD_STAT(STAT_ParkourProbeCacheMisses, CacheMisses);
+	SET_DWORD_STAT(STAT_ParkourProbeCacheEvictions, CacheEvictions);
+	SET_DWORD_STAT(STAT_ParkourProbeCacheEntries, ProbeCache.GetNumEntries());
+	SET_FLOAT_STAT(STAT_ParkourProbeCacheHitRate, ProbeCache.GetHitRate());
+	SET_DWORD_STAT(STAT_ParkourBatchedAgents, Agents.Num());
+	SET_FLOAT_STAT(STAT_ParkourBatchedUpdateMs, ElapsedMs);
+
+	// Scaled linearly from this frame's agent count, not measured at 100. Only the predicate phase runs wide, the gather,
+	// update and event phases go agent by agent on the game thread, so the cost doesn't fall with more workers.
+	// Parkour.Benchmark measures fixed agent counts.
+	SET_FLOAT_STAT(STAT_ParkourBatchedUpdateMsPer100, Agents.Num() > 0 ? (ElapsedMs * 100.0 / Agents.Num()) : 0.0);
+}
+
+void UParkourMovementWorldSubsystem::GatherViewpoints()
+{
+	Viewpoints.Reset();
+
+	// Includes remote players' controllers on a server, so characters near any player keep their full update
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It) {
+		if (const APlayerController* PlayerController = It->Get()) {
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+			Viewpoints.Add(Location);
+		}
+	}
+}
+
+void UParkourMovementWorldSubsystem::GatherPhase(int32 Step)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParkourGatherPhase);
+
+	for (int32 Index = 0; Index < Agents.Num(); ++Index) {
+		if (StepCounts[Index] > Step && IsValid(Agents[Index])) {
+			Agents[Index]->GatherHotState(HotStates[Index]);
+		}
+	}
+}
+
+void UParkourMovementWorldSubsystem::PredicatePhase(int32 Step)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParkourPredicatePhase);
+
+	// Pure functions of the gathered copy, safe to run on any worker
+	const EParallelForFlags Flags = (HotStates.Num() < MinAgentsForParallelPredicates) ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+	ParallelFor(HotStates.Num(), [this, Step](int32 Index)
+	{
+		if (StepCounts[Index] > Step) {
+			HotStates[Index].EvaluatePredicates();
+		}
+	}, Flags);
+}
+
+void UParkourMovementWorldSubsystem::UpdatePhase(int32 Step)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParkourUpdatePhase);
+
+	for (int32 Index = 0; Index < Agents.Num(); ++Index) {
+		UParkourMovementComponent* Agent = Agents[Index];
+		if (StepCounts[Index] > Step && IsValid(Agent)) {
+			Agent->ApplyBatchedPredicates(HotStates[Index]);
+			Agent->UpdateEventMethod();
+		}
+	}
+}
+
+void UParkourMovementWorldSubsystem::EventPhase()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ParkourEventPhase);
+
+	// Timers, Blueprint events, animation snapshots and replicated state go out once per frame, after every agent has finished its steps.
+	// Agents left idle unregister themselves here, their slots are compacted once the update is done. Agents whose moves run the
+	// update get all of this from their movement component's tick instead, a second publish would break the snapshot's one per frame.
+	for (UParkourMovementComponent* Agent : Agents) {
+		if (IsValid(Agent) && !Agent->IsUpdatedByMovement()) {
+			Agent->ApplyDeferredLaunch();
+			Agent->RunDueTimers();
+			Agent->FlushEvents();
+			Agent->PublishAnimSnapshot();
+			Agent->UpdateReplicatedState();
+			Agent->TryGoDormant();
+		}
+	}
+}
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourNavLinks.h"
+#include "ParkourMovementSettings.h"
+#include "AI/NavigationSystemBase.h"
+
+/************************************************************/
+/*----------------------- Nav Areas ------------------------*/
+/************************************************************/
+
+bool UParkourNavArea::GetTraversal(TSubclassOf<UNavAreaBase> AreaClass, EParkourTraversal& OutTraversal)
+{
+	const UParkourNavArea* Area = AreaClass ? Cast<UParkourNavArea>(AreaClass->GetDefaultObject()) : nullptr;
+	if (!Area) {
+		return false;
+	}
+
+	OutTraversal = Area->GetTraversal();
+	return true;
+}
+
+TSubclassOf<UParkourNavArea> UParkourNavArea::GetAreaClass(EParkourTraversal Traversal)
+{
+	switch (Traversal) {
+	case EParkourTraversal::WallRun: return UParkourNavArea_WallRun::StaticClass();
+	case EParkourTraversal::Climb: return UParkourNavArea_Climb::StaticClass();
+	default: return UParkourNavArea_Mantle::StaticClass();
+	}
+}
+
+UParkourNavArea_WallRun::UParkourNavArea_WallRun()
+{
+	Traversal = EParkourTraversal::WallRun;
+	DefaultCost = 1.5f;
+	DrawColor = FColor(64, 160, 255);
+}
+
+UParkourNavArea_Climb::UParkourNavArea_Climb()
+{
+	// Slow, and a fall from the wall undoes it
+	Traversal = EParkourTraversal::Climb;
+	DefaultCost = 3.0f;
+	DrawColor = FColor(255, 128, 32);
+}
+
+UParkourNavArea_Mantle::UParkourNavArea_Mantle()
+{
+	Traversal = EParkourTraversal::Mantle;
+	DefaultCost = 2.0f;
+	DrawColor = FColor(255, 220, 64);
+}
+
+/************************************************************/
+/*----------------------- Link Proxy -----------------------*/
+/************************************************************/
+
+AParkourNavLinkProxy::AParkourNavLinkProxy(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	// Only the point links, the smart link is for links that run their own logic
+	bSmartLinkIsRelevant = false;
+	PointLinks.Reset();
+}
+
+void AParkourNavLinkProxy::PostLoad()
+{
+	Super::PostLoad();
+
+	// The point links are derived, so links saved by an older build pick up area changes
+	RebuildPointLinks();
+}
+
+#if WITH_EDITOR
+void AParkourNavLinkProxy::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Moving the proxy must not move the links, they're kept in world space
+	RebuildPointLinks();
+}
+#endif
+
+void AParkourNavLinkProxy::ReplaceLinks(const FBox& Box, const TArray<FParkourNavLink>& NewLinks)
+{
+	Modify();
+
+	ParkourLinks.RemoveAllSwap([&Box](const FParkourNavLink& Link) { return Box.IsInsideOrOn(Link.Start); });
+	ParkourLinks.Append(NewLinks);
+
+	RebuildPointLinks();
+	FNavigationSystem::UpdateActorData(*this);
+}
+
+void AParkourNavLinkProxy::SetLinks(const TArray<FParkourNavLink>& NewLinks)
+{
+	Modify();
+
+	ParkourLinks = NewLinks;
+
+	RebuildPointLinks();
+	FNavigationSystem::UpdateActorData(*this);
+}
+
+const UParkourMovementSettings& AParkourNavLinkProxy::GetMovementSettings() const
+{
+	return MovementSettings ? *MovementSettings : *GetDefault<UParkourMovementSettings>();
+}
+
+void AParkourNavLinkProxy::RebuildPointLinks()
+{
+	const FTransform& Transform = GetActorTransform();
+
+	PointLinks.Reset(ParkourLinks.Num());
+	for (const FParkourNavLink& ParkourLink : ParkourLinks) {
+		FNavigationLink& Link = PointLinks.Emplace_GetRef(Transform.InverseTransformPosition(ParkourLink.Start), Transform.InverseTransformPosition(ParkourLink.End));
+		Link.Direction = ENavLinkDirection::LeftToRight;
+		Link.SetAreaClass(UParkourNavArea::GetAreaClass(ParkourLink.Traversal));
+	}
+}
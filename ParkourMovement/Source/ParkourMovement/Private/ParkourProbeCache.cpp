@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourProbeCache.h"
+#include "Components/PrimitiveComponent.h"
+
+/************************************************************/
+/*------------------------ Cache ---------------------------*/
+/************************************************************/
+
+FParkourProbeCacheKey FParkourProbeCache::MakeKey(EParkourProbe Probe, const FParkourProbeQuery& Query, const FCollisionShape& Shape, const FVector& Start, const FVector& End) const
+{
+	const FVector Delta = End - Start;
+	const double Length = Delta.Size();
+	const FVector Direction = (Length > KINDA_SMALL_NUMBER) ? (Delta / Length) : FVector::ZeroVector;
+
+	FParkourProbeCacheKey Key;
+	Key.Cell = FIntVector(FMath::FloorToInt(Start.X / CellSize), FMath::FloorToInt(Start.Y / CellSize), FMath::FloorToInt(Start.Z / CellSize));
+	Key.Probe = (uint8)Probe;
+
+	// 256 yaw buckets (~1.4 degrees) and 256 pitch buckets over [-90, 90]
+	const double Yaw = FMath::Atan2(Direction.Y, Direction.X);
+	const double Pitch = FMath::Asin(FMath::Clamp(Direction.Z, -1.0, 1.0));
+	Key.Yaw = (uint8)(FMath::FloorToInt(((Yaw + PI) / (2.0 * PI)) * 256.0) & 0xFF);
+	Key.Pitch = (uint8)FMath::Clamp(FMath::FloorToInt(((Pitch + HALF_PI) / PI) * 255.0), 0, 255);
+	Key.Length = (uint16)FMath::Clamp(FMath::FloorToInt(Length / CellSize), 0, 0xFFFF);
+
+	Key.Channel = (uint8)Query.Channel;
+	Key.ShapeType = (uint8)Shape.ShapeType;
+	Key.ShapeExtent = Shape.IsLine() ? FIntVector::ZeroValue : FIntVector(Shape.GetExtent().GetCeilVector());
+	Key.IgnoredClass = Query.IgnoredClass;
+	return Key;
+}
+
+bool FParkourProbeCache::IsEntryValid(const FParkourProbeCacheEntry& Entry) const
+{
+	if (!Entry.bBlockingHit) {
+		return Entry.CachedFrame == GFrameCounter;
+	}
+
+	// Only static and stationary hits are added, and those can't move at runtime
+	const UPrimitiveComponent* Component = Entry.Hit.GetComponent();
+	return IsValid(Component) && Component->IsRegistered() && Component->IsCollisionEnabled();
+}
+
+void FParkourProbeCache::CountMiss(EParkourProbe Probe)
+{
+	++TotalMisses;
+	++FrameMisses;
+	++ProbeLookups[(uint8)Probe];
+}
+
+bool FParkourProbeCache::Find(EParkourProbe Probe, const FParkourProbeQuery& Query, const FCollisionShape& Shape, const FVector& Start, const FVector& End, double Now, FHitResult& OutHit, bool& bOutBlockingHit)
+{
+	const FParkourProbeCacheKey Key = MakeKey(Probe, Query, Shape, Start, End);
+	FParkourProbeCacheEntry* Entry = Entries.Find(Key);
+
+	if (!Entry) {
+		CountMiss(Probe);
+		return false;
+	}
+
+	if (!IsEntryValid(*Entry)) {
+		Entries.Remove(Key);
+		++TotalEvictions;
+		++FrameEvictions;
+		CountMiss(Probe);
+		return false;
+	}
+
+	if (Entry->bBlockingHit) {
+		// Slide the cached hit along the surface it hit to line up with this probe's start. This is exact for
+		// flat faces, and anything that doesn't reach the cached surface goes back to a real trace.
+		const FVector Normal = Entry->Hit.Normal;
+		const FVector Delta = End - Start;
+		const double Denominator = FVector::DotProduct(Delta, Normal);
+		if (FMath::IsNearlyZero(Denominator)) {
+			CountMiss(Probe);
+			return false;
+		}
+
+		const double Time = FVector::DotProduct(Entry->Hit.Location - Start, Normal) / Denominator;
+		if (Time < 0.0 || Time > 1.0) {
+			CountMiss(Probe);
+			return false;
+		}
+
+		const FVector Location = Start + (Delta * Time);
+		OutHit = Entry->Hit;
+		OutHit.ImpactPoint = Entry->Hit.ImpactPoint + (Location - Entry->Hit.Location);
+		OutHit.Location = Location;
+		OutHit.TraceStart = Start;
+		OutHit.TraceEnd = End;
+		OutHit.Time = (float)Time;
+		OutHit.Distance = Delta.Size() * Time;
+	}
+	else {
+		OutHit = FHitResult(Start, End);
+	}
+
+	bOutBlockingHit = Entry->bBlockingHit;
+	Entry->LastUsedTime = Now;
+	++TotalHits;
+	++FrameHits;
+	++ProbeHits[(uint8)Probe];
+	++ProbeLookups[(uint8)Probe];
+	return true;
+}
+
+void FParkourProbeCache::Add(EParkourProbe Probe, const FParkourProbeQuery& Query, const FCollisionShape& Shape, const FVector& Start, const FVector& End, double Now, const FHitResult& Hit, bool bBlockingHit)
+{
+	// Nothing to verify a hit against later, something that can move away from it, or a probe that started inside something
+	const UPrimitiveComponent* Component = Hit.GetComponent();
+	if (bBlockingHit && (!IsValid(Component) || (Component->Mobility == EComponentMobility::Movable) || Hit.bStartPenetrating)) {
+		return;
+	}
+
+	if (Entries.Num() >= MaxEntries) {
+		Sweep(Now);
+		if (Entries.Num() >= MaxEntries) {
+			TotalEvictions += Entries.Num();
+			FrameEvictions += Entries.Num();
+			Entries.Reset();
+		}
+	}
+
+	FParkourProbeCacheEntry& Entry = Entries.FindOrAdd(MakeKey(Probe, Query, Shape, Start, End));
+	Entry.Hit = Hit;
+	Entry.Start = Start;
+	Entry.bBlockingHit = bBlockingHit;
+	Entry.CachedFrame = GFrameCounter;
+	Entry.LastUsedTime = Now;
+}
+
+void FParkourProbeCache::Sweep(double Now)
+{
+	for (auto It = Entries.CreateIterator(); It; ++It) {
+		if (((Now - It.Value().LastUsedTime) > IdleLifetime) || !IsEntryValid(It.Value())) {
+			It.RemoveCurrent();
+			++TotalEvictions;
+			++FrameEvictions;
+		}
+	}
+}
+
+void FParkourProbeCache::Empty()
+{
+	Entries.Empty();
+
+	TotalHits = 0;
+	TotalMisses = 0;
+	TotalEvictions = 0;
+	FMemory::Memzero(ProbeHits);
+	FMemory::Memzero(ProbeLookups);
+}
+
+/************************************************************/
+/*----------------------- Counters -------------------------*/
+/************************************************************/
+
+float FParkourProbeCache::GetHitRate() const
+{
+	const uint64 Lookups = TotalHits + TotalMisses;
+	return (Lookups > 0) ? (float)((double)TotalHits / (double)Lookups) : 0.0f;
+}
+
+float FParkourProbeCache::GetHitRate(EParkourProbe Probe) const
+{
+	const uint64 Lookups = ProbeLookups[(uint8)Probe];
+	return (Lookups > 0) ? (float)((double)ProbeHits[(uint8)Probe] / (double)Lookups) : 0.0f;
+}
+
+void FParkourProbeCache::ConsumeFrameCounters(uint32& OutHits, uint32& OutMisses, uint32& OutEvictions)
+{
+	OutHits = FrameHits;
+	OutMisses = FrameMisses;
+	OutEvictions = FrameEvictions;
+
+	FrameHits = 0;
+	FrameMisses = 0;
+	FrameEvictions = 0;
+}
@@ -0,0 +1,379 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourRecorder.h"
+#include "ParkourMovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectIterator.h"
+
+static FAutoConsoleCommandWithWorldAndArgs ParkourRecordCommand(
+	TEXT("Parkour.Record"),
+	TEXT("Parkour.Record Start|Stop. Starts or stops recording every parkour component in the world to Saved/Profiling/ParkourRecordings."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const bool bStart = (Args.Num() == 0) || (Args[0] != TEXT("Stop"));
+		for (TObjectIterator<UParkourMovementComponent> It; It; ++It) {
+			if (It->GetWorld() == World) {
+				if (bStart) {
+					It->StartRecording();
+				}
+				else {
+					It->StopRecording();
+				}
+			}
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs ParkourPlaybackCommand(
+	TEXT("Parkour.Playback"),
+	TEXT("Parkour.Playback <File>. Plays a parkour recording back through the first locally controlled parkour component in the world."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (Args.Num() == 0) {
+			return;
+		}
+
+		for (TObjectIterator<UParkourMovementComponent> It; It; ++It) {
+			const APawn* Owner = Cast<APawn>(It->GetOwner());
+			if ((It->GetWorld() == World) && Owner && Owner->IsLocallyControlled()) {
+				It->StartPlayback(Args[0]);
+				return;
+			}
+		}
+	}));
+
+/************************************************************/
+/*----------------------- Encoding -------------------------*/
+/************************************************************/
+
+namespace ParkourRecordEncoding
+{
+	// Records are small and bounded, a step is at most 1 + 6 * 5 + 3 bytes
+	typedef TArray<uint8, TInlineAllocator<64>> FRecordBytes;
+
+	void WriteVarInt(FRecordBytes& Bytes, int32 Value)
+	{
+		uint32 ZigZag = ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+		while (ZigZag >= 0x80) {
+			Bytes.Add((uint8)(ZigZag | 0x80));
+			ZigZag >>= 7;
+		}
+		Bytes.Add((uint8)ZigZag);
+	}
+
+	bool ReadVarInt(const TArray<uint8>& Data, int32& Offset, int32& OutValue)
+	{
+		uint32 ZigZag = 0;
+		for (int32 Shift = 0; Shift < 35; Shift += 7) {
+			if (!Data.IsValidIndex(Offset)) {
+				return false;
+			}
+			const uint8 Byte = Data[Offset++];
+			ZigZag |= (uint32)(Byte & 0x7F) << Shift;
+			if (!(Byte & 0x80)) {
+				OutValue = (int32)(ZigZag >> 1) ^ -(int32)(ZigZag & 1);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	FIntVector Quantize(const FVector& Vector)
+	{
+		return FIntVector(FMath::RoundToInt(Vector.X), FMath::RoundToInt(Vector.Y), FMath::RoundToInt(Vector.Z));
+	}
+
+	void WriteDelta(FRecordBytes& Bytes, const FIntVector& Value, const FIntVector& Previous)
+	{
+		WriteVarInt(Bytes, Value.X - Previous.X);
+		WriteVarInt(Bytes, Value.Y - Previous.Y);
+		WriteVarInt(Bytes, Value.Z - Previous.Z);
+	}
+
+	bool ReadDelta(const TArray<uint8>& Data, int32& Offset, FIntVector& InOutValue)
+	{
+		FIntVector Delta;
+		if (!ReadVarInt(Data, Offset, Delta.X) || !ReadVarInt(Data, Offset, Delta.Y) || !ReadVarInt(Data, Offset, Delta.Z)) {
+			return false;
+		}
+		InOutValue += Delta;
+		return true;
+	}
+
+	// Input vectors are unit length or less, 1/127 is plenty
+	int8 QuantizeInput(double Value)
+	{
+		return (int8)FMath::Clamp(FMath::RoundToInt(Value * 127.0), -127, 127);
+	}
+}
+
+/************************************************************/
+/*----------------------- Recorder -------------------------*/
+/************************************************************/
+
+FParkourRecorder::FParkourRecorder()
+	: WritePipe(TEXT("ParkourRecorder"))
+{
+}
+
+FParkourRecorder::~FParkourRecorder()
+{
+	Stop();
+}
+
+FString FParkourRecorder::MakeRecordingPath(const FString& OwnerName)
+{
+	return FPaths::ProfilingDir() / TEXT("ParkourRecordings") / FString::Printf(TEXT("%s-%s.pkrec"), *OwnerName, *FDateTime::Now().ToString());
+}
+
+bool FParkourRecorder::Start(const FString& InPath, float FixedTimeStep, const FParkourRecordingInitialState& InitialState)
+{
+	Stop();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(InPath));
+
+	FileHandle.Reset(PlatformFile.OpenWrite(*InPath));
+	if (!FileHandle) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Recorder_Start: Couldn't open %s."), *InPath);
+		return false;
+	}
+
+	FParkourRecordingHeader Header;
+	Header.FixedTimeStep = FixedTimeStep;
+	FileHandle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	FileHandle->Write(reinterpret_cast<const uint8*>(&InitialState), sizeof(InitialState));
+
+	Path = InPath;
+	Ring.SetNumUninitialized(RingSize);
+	WriteCursor = 0;
+	FlushCursor = 0;
+	ReadCursor = 0;
+	Baseline = FParkourRecordBaseline();
+	NumRecords = 0;
+	NumDroppedRecords = 0;
+	return true;
+}
+
+void FParkourRecorder::Stop()
+{
+	if (!FileHandle) {
+		return;
+	}
+
+	Flush();
+	WritePipe.WaitUntilEmpty();
+
+	FileHandle->Flush();
+	FileHandle.Reset();
+
+	if (NumDroppedRecords > 0) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Recorder_Stop: %s dropped %llu of %llu records, the writer fell behind."), *Path, NumDroppedRecords, NumRecords + NumDroppedRecords);
+	}
+}
+
+void FParkourRecorder::RecordStep(const FVector& Input, const FVector& Location, const FVector& Velocity)
+{
+	using namespace ParkourRecordEncoding;
+
+	const FIntVector QuantizedLocation = Quantize(Location);
+	const FIntVector QuantizedVelocity = Quantize(Velocity);
+
+	FRecordBytes Bytes;
+	Bytes.Add((uint8)EParkourRecordType::Step);
+	Bytes.Add((uint8)QuantizeInput(Input.X));
+	Bytes.Add((uint8)QuantizeInput(Input.Y));
+	Bytes.Add((uint8)QuantizeInput(Input.Z));
+	WriteDelta(Bytes, QuantizedLocation, Baseline.Location);
+	WriteDelta(Bytes, QuantizedVelocity, Baseline.Velocity);
+
+	if (Push(Bytes.GetData(), Bytes.Num())) {
+		Baseline.Location = QuantizedLocation;
+		Baseline.Velocity = QuantizedVelocity;
+	}
+}
+
+void FParkourRecorder::RecordEvent(EParkourRecordedEvent Event)
+{
+	const uint8 Bytes[2] = { (uint8)EParkourRecordType::Event, (uint8)Event };
+	Push(Bytes, 2);
+}
+
+void FParkourRecorder::RecordTransition(uint8 FromMode, uint8 ToMode, const FVector& Location, const FVector& Velocity)
+{
+	using namespace ParkourRecordEncoding;
+
+	const FIntVector QuantizedLocation = Quantize(Location);
+	const FIntVector QuantizedVelocity = Quantize(Velocity);
+
+	FRecordBytes Bytes;
+	Bytes.Add((uint8)EParkourRecordType::Transition);
+	Bytes.Add(FromMode);
+	Bytes.Add(ToMode);
+	WriteDelta(Bytes, QuantizedLocation, Baseline.Location);
+	WriteDelta(Bytes, QuantizedVelocity, Baseline.Velocity);
+
+	if (Push(Bytes.GetData(), Bytes.Num())) {
+		Baseline.Location = QuantizedLocation;
+		Baseline.Velocity = QuantizedVelocity;
+	}
+}
+
+bool FParkourRecorder::Push(const uint8* Bytes, int32 NumBytes)
+{
+	if (!FileHandle) {
+		return false;
+	}
+
+	// Never wait for the writer, drop the record instead
+	if ((WriteCursor + NumBytes) - ReadCursor.load(std::memory_order_acquire) > RingSize) {
+		++NumDroppedRecords;
+		return false;
+	}
+
+	for (int32 Index = 0; Index < NumBytes; ++Index) {
+		Ring[(WriteCursor + Index) & (RingSize - 1)] = Bytes[Index];
+	}
+	WriteCursor += NumBytes;
+	++NumRecords;
+
+	if (WriteCursor - FlushCursor >= FlushSize) {
+		Flush();
+	}
+	return true;
+}
+
+void FParkourRecorder::Flush()
+{
+	if (WriteCursor == FlushCursor) {
+		return;
+	}
+
+	// The span stays put until the writer moves ReadCursor past it
+	const uint64 Begin = FlushCursor;
+	const uint64 End = WriteCursor;
+	FlushCursor = WriteCursor;
+
+	WritePipe.Launch(UE_SOURCE_LOCATION, [this, Begin, End]()
+	{
+		const uint32 First = (uint32)(Begin & (RingSize - 1));
+		const uint32 Length = (uint32)(End - Begin);
+		const uint32 BeforeWrap = FMath::Min(Length, RingSize - First);
+
+		FileHandle->Write(Ring.GetData() + First, BeforeWrap);
+		if (BeforeWrap < Length) {
+			FileHandle->Write(Ring.GetData(), Length - BeforeWrap);
+		}
+
+		ReadCursor.store(End, std::memory_order_release);
+	});
+}
+
+/************************************************************/
+/*------------------------ Player --------------------------*/
+/************************************************************/
+
+bool FParkourRecordingPlayer::Load(const FString& Path)
+{
+	Unload();
+
+	TUniquePtr<IFileHandle> LoadedHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+	FParkourRecordingHeader Header;
+	if (!LoadedHandle || !LoadedHandle->Read(reinterpret_cast<uint8*>(&Header), sizeof(Header))) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Recording Player_Load: Couldn't read %s."), *Path);
+		return false;
+	}
+
+	if ((Header.Magic != ParkourRecordingMagic) || (Header.Version != ParkourRecordingVersion)
+		|| !LoadedHandle->Read(reinterpret_cast<uint8*>(&InitialState), sizeof(InitialState))) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Recording Player_Load: %s is not a version %u parkour recording."), *Path, ParkourRecordingVersion);
+		return false;
+	}
+
+	FixedTimeStep = Header.FixedTimeStep;
+	FileHandle = MoveTemp(LoadedHandle);
+	Buffer.Reserve(BufferSize);
+	Refill();
+	return true;
+}
+
+void FParkourRecordingPlayer::Unload()
+{
+	FileHandle.Reset();
+	Buffer.Empty();
+	Offset = 0;
+	InitialState = FParkourRecordingInitialState();
+	Baseline = FParkourRecordBaseline();
+}
+
+void FParkourRecordingPlayer::Refill()
+{
+	const int32 Remaining = Buffer.Num() - Offset;
+	if ((Remaining >= MaxRecordSize) || !FileHandle) {
+		return;
+	}
+
+	if (Offset > 0) {
+		FMemory::Memmove(Buffer.GetData(), Buffer.GetData() + Offset, Remaining);
+		Offset = 0;
+	}
+
+	const int32 NumToRead = (int32)FMath::Min<int64>(BufferSize - Remaining, FileHandle->Size() - FileHandle->Tell());
+	Buffer.SetNumUninitialized(Remaining + FMath::Max(NumToRead, 0), false);
+	if ((NumToRead > 0) && !FileHandle->Read(Buffer.GetData() + Remaining, NumToRead)) {
+		Buffer.SetNum(Remaining, false);
+	}
+}
+
+bool FParkourRecordingPlayer::Read(FParkourRecord& OutRecord)
+{
+	using namespace ParkourRecordEncoding;
+
+	// The whole record is in the buffer from here on, unless the file ends first
+	Refill();
+
+	if (!Buffer.IsValidIndex(Offset)) {
+		return false;
+	}
+
+	OutRecord = FParkourRecord();
+	OutRecord.Type = (EParkourRecordType)Buffer[Offset++];
+
+	// A record cut off by the end of the file ends the stream
+	switch (OutRecord.Type) {
+	case EParkourRecordType::Step:
+		if (!Buffer.IsValidIndex(Offset + 2)) {
+			return false;
+		}
+		OutRecord.Input = FVector((int8)Buffer[Offset], (int8)Buffer[Offset + 1], (int8)Buffer[Offset + 2]) / 127.0;
+		Offset += 3;
+		break;
+	case EParkourRecordType::Event:
+		if (!Buffer.IsValidIndex(Offset)) {
+			return false;
+		}
+		OutRecord.Event = (EParkourRecordedEvent)Buffer[Offset++];
+		return true;
+	case EParkourRecordType::Transition:
+		if (!Buffer.IsValidIndex(Offset + 1)) {
+			return false;
+		}
+		OutRecord.FromMode = Buffer[Offset];
+		OutRecord.ToMode = Buffer[Offset + 1];
+		Offset += 2;
+		break;
+	default:
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Recording Player_Read: Unknown record type %d, stopping."), (int32)OutRecord.Type);
+		return false;
+	}
+
+	if (!ReadDelta(Buffer, Offset, Baseline.Location) || !ReadDelta(Buffer, Offset, Baseline.Velocity)) {
+		return false;
+	}
+
+	OutRecord.Location = FVector(Baseline.Location);
+	OutRecord.Velocity = FVector(Baseline.Velocity);
+	return true;
+}
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourReplication.h"
+#include "UObject/CoreNet.h"
+
+static constexpr uint16 ParkourNormalMax = (1 << ParkourNormalBits) - 1;
+
+// Sign that treats zero as positive, so a fold along an axis never collapses onto it
+static FORCEINLINE double SignNotZero(double Value)
+{
+	return (Value >= 0.0) ? 1.0 : -1.0;
+}
+
+/************************************************************/
+/*--------------------- Quantization -----------------------*/
+/************************************************************/
+
+uint16 ParkourQuantize::EncodeNormal(const FVector& Normal)
+{
+	const double Length = FMath::Abs(Normal.X) + FMath::Abs(Normal.Y) + FMath::Abs(Normal.Z);
+	if (Length <= UE_KINDA_SMALL_NUMBER) {
+		return 0;
+	}
+
+	double X = Normal.X / Length;
+	double Y = Normal.Y / Length;
+
+	// The lower half folds over the upper half's corners
+	if (Normal.Z < 0.0) {
+		const double FoldedX = (1.0 - FMath::Abs(Y)) * SignNotZero(X);
+		Y = (1.0 - FMath::Abs(X)) * SignNotZero(Y);
+		X = FoldedX;
+	}
+
+	const uint16 U = (uint16)FMath::Clamp(FMath::RoundToInt((X * 0.5 + 0.5) * ParkourNormalMax), 0, (int32)ParkourNormalMax);
+	const uint16 V = (uint16)FMath::Clamp(FMath::RoundToInt((Y * 0.5 + 0.5) * ParkourNormalMax), 0, (int32)ParkourNormalMax);
+	return (uint16)(U | (V << ParkourNormalBits));
+}
+
+FVector ParkourQuantize::DecodeNormal(uint16 Packed)
+{
+	double X = ((Packed & ParkourNormalMax) / (double)ParkourNormalMax) * 2.0 - 1.0;
+	double Y = (((Packed >> ParkourNormalBits) & ParkourNormalMax) / (double)ParkourNormalMax) * 2.0 - 1.0;
+	const double Z = 1.0 - FMath::Abs(X) - FMath::Abs(Y);
+
+	if (Z < 0.0) {
+		const double UnfoldedX = (1.0 - FMath::Abs(Y)) * SignNotZero(X);
+		Y = (1.0 - FMath::Abs(X)) * SignNotZero(Y);
+		X = UnfoldedX;
+	}
+
+	return FVector(X, Y, Z).GetSafeNormal();
+}
+
+/************************************************************/
+/*------------------- Replicated State ---------------------*/
+/************************************************************/
+
+void FParkourReplicatedState::Quantize()
+{
+	if (HasWall()) {
+		WallNormal = ParkourQuantize::DecodeNormal(ParkourQuantize::EncodeNormal(WallNormal));
+		Target = FVector(FMath::RoundToDouble(Target.X), FMath::RoundToDouble(Target.Y), FMath::RoundToDouble(Target.Z));
+	}
+	else {
+		WallNormal = FVector::ZeroVector;
+		Target = FVector::ZeroVector;
+	}
+}
+
+int32 FParkourReplicatedState::CountBits() const
+{
+	FParkourReplicatedState Copy = *this;
+	FNetBitWriter Writer(256);
+	bool bSuccess = false;
+	Copy.NetSerialize(Writer, nullptr, bSuccess);
+	return (int32)Writer.GetNumBits();
+}
+
+bool FParkourReplicatedState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// Mode, 4 bits
+	uint8 ModeBits = (uint8)Mode;
+	Ar.SerializeBits(&ModeBits, 4);
+	if (Ar.IsLoading()) {
+		Mode = (ModeBits < NumParkourModes) ? (EParkourMovement)ModeBits : EParkourMovement::None;
+	}
+
+	bOutSuccess = true;
+
+	// Wall normal, 16 bits, and target, packed to whole units
+	if (HasWall()) {
+		uint16 PackedNormal = Ar.IsSaving() ? ParkourQuantize::EncodeNormal(WallNormal) : 0;
+		Ar.SerializeBits(&PackedNormal, ParkourNormalBits * 2);
+		if (Ar.IsLoading()) {
+			WallNormal = ParkourQuantize::DecodeNormal(PackedNormal);
+		}
+
+		Target.NetSerialize(Ar, Map, bOutSuccess);
+	}
+	else if (Ar.IsLoading()) {
+		WallNormal = FVector::ZeroVector;
+		Target = FVector::ZeroVector;
+	}
+
+	bOutSuccess &= !Ar.IsError();
+	return true;
+}
@@ -0,0 +1,333 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourReplicationGraph.h"
+#include "ParkourMovementComponent.h"
+#include "Engine/ChildConnection.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/UObjectIterator.h"
+#include "ParkourMovement/ParkourMovement.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rep Graph Near Replications"), STAT_ParkourRepGraphNear, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rep Graph Far Replications"), STAT_ParkourRepGraphFar, STATGROUP_ParkourMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rep Graph Culled Characters"), STAT_ParkourRepGraphCulled, STATGROUP_ParkourMovement);
+
+// Moving through the level on a wall, a ledge or the ground close by every frame, idle characters rarely
+static FParkourModeReplication DefaultModeReplication(EParkourMovement Mode)
+{
+	FParkourModeReplication Result;
+
+	switch (Mode) {
+	case EParkourMovement::LeftWallRun:
+	case EParkourMovement::RightWallRun:
+	case EParkourMovement::VerticalWallRun:
+	case EParkourMovement::LedgeGrab:
+	case EParkourMovement::Mantle:
+	case EParkourMovement::Slide:
+		Result.NearDistance = 5000.0f;
+		Result.NearPeriod = 1;
+		Result.FarPeriod = 3;
+		Result.CullDistance = 25000.0f;
+		break;
+	case EParkourMovement::Sprint:
+		Result.NearDistance = 4000.0f;
+		Result.NearPeriod = 1;
+		Result.FarPeriod = 6;
+		Result.CullDistance = 20000.0f;
+		break;
+	case EParkourMovement::None:
+	case EParkourMovement::Crouch:
+	default:
+		Result.NearDistance = 3000.0f;
+		Result.NearPeriod = 2;
+		Result.FarPeriod = 15;
+		Result.CullDistance = 15000.0f;
+		break;
+	}
+
+	return Result;
+}
+
+/************************************************************/
+/*---------------------- Graph Node ------------------------*/
+/************************************************************/
+
+UParkourReplicationGraphNode::UParkourReplicationGraphNode()
+{
+	for (int32 Mode = 0; Mode < NumParkourModes; ++Mode) {
+		ModeReplication[Mode] = DefaultModeReplication((EParkourMovement)Mode);
+	}
+}
+
+void UParkourReplicationGraphNode::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	const UParkourMovementComponent* Parkour = ActorInfo.Actor->FindComponentByClass<UParkourMovementComponent>();
+	if (!Parkour) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Replication Graph Node_NotifyAddNetworkActor: %s has no parkour component."), *GetNameSafe(ActorInfo.Actor));
+		return;
+	}
+
+	Characters.Add({ ActorInfo.Actor, Parkour });
+}
+
+bool UParkourReplicationGraphNode::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	const int32 Index = Characters.IndexOfByPredicate([&ActorInfo](const FParkourCharacterEntry& Entry) { return Entry.Actor == ActorInfo.Actor; });
+	if (Index == INDEX_NONE) {
+		if (bWarnIfNotFound) {
+			UE_LOG(LogTemp, Warning, TEXT("Parkour Replication Graph Node_NotifyRemoveNetworkActor: %s was never added."), *GetNameSafe(ActorInfo.Actor));
+		}
+		return false;
+	}
+
+	Characters.RemoveAtSwap(Index);
+	return true;
+}
+
+void UParkourReplicationGraphNode::NotifyResetAllNetworkActors()
+{
+	Characters.Reset();
+	GatheredActors.Reset();
+}
+
+void UParkourReplicationGraphNode::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	GatheredActors.Reset();
+
+	uint32 NumPerBucket[(uint8)EParkourReplicationBucket::Count] = {};
+
+	for (const FParkourCharacterEntry& Entry : Characters) {
+		AActor* Actor = Entry.Actor;
+		const FParkourModeReplication& Tuning = ModeReplication[FMath::Min((int32)Entry.Parkour->GetCurrentParkourMode(), NumParkourModes - 1)];
+		const FVector Location = Actor->GetActorLocation();
+
+		bool bIsViewTarget = false;
+		double ClosestDistanceSquared = TNumericLimits<double>::Max();
+		for (const FNetViewer& Viewer : Params.Viewers) {
+			bIsViewTarget |= (Viewer.ViewTarget == Actor);
+			ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(Location, Viewer.ViewLocation));
+		}
+
+		EParkourReplicationBucket Bucket = EParkourReplicationBucket::Near;
+		uint16 Period = 1;
+		if (!bIsViewTarget) {
+			if ((Tuning.CullDistance > 0.0f) && (ClosestDistanceSquared > FMath::Square(Tuning.CullDistance))) {
+				Bucket = EParkourReplicationBucket::Culled;
+			}
+			else if (ClosestDistanceSquared > FMath::Square(Tuning.NearDistance)) {
+				Bucket = EParkourReplicationBucket::Far;
+				Period = (uint16)FMath::Clamp(Tuning.FarPeriod, 1, (int32)MAX_uint16);
+			}
+			else {
+				Period = (uint16)FMath::Clamp(Tuning.NearPeriod, 1, (int32)MAX_uint16);
+			}
+		}
+
+		if (Bucket == EParkourReplicationBucket::Culled) {
+			++NumPerBucket[(uint8)Bucket];
+			continue;
+		}
+
+		// The graph replicates it once its period has passed since the last time, staggered by when that was
+		FConnectionReplicationActorInfo& ConnectionInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(Actor);
+		if (ConnectionInfo.ReplicationPeriodFrame != Period) {
+			ConnectionInfo.ReplicationPeriodFrame = Period;
+			ConnectionInfo.NextReplicationFrameNum = FMath::Min(ConnectionInfo.NextReplicationFrameNum, ConnectionInfo.LastRepFrameNum + Period);
+		}
+		ConnectionInfo.SetCullDistanceSquared((Tuning.CullDistance > 0.0f) && !bIsViewTarget ? FMath::Square(Tuning.CullDistance) : 0.0f);
+
+		if (ConnectionInfo.NextReplicationFrameNum <= Params.ReplicationFrameNum) {
+			++NumPerBucket[(uint8)Bucket];
+		}
+
+		GatheredActors.Add(Actor);
+	}
+
+	INC_DWORD_STAT_BY(STAT_ParkourRepGraphNear, NumPerBucket[(uint8)EParkourReplicationBucket::Near]);
+	INC_DWORD_STAT_BY(STAT_ParkourRepGraphFar, NumPerBucket[(uint8)EParkourReplicationBucket::Far]);
+	INC_DWORD_STAT_BY(STAT_ParkourRepGraphCulled, NumPerBucket[(uint8)EParkourReplicationBucket::Culled]);
+
+	if (GatheredActors.Num() > 0) {
+		Params.OutGatheredReplicationLists.AddReplicationActorList(GatheredActors);
+	}
+}
+
+void UParkourReplicationGraphNode::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+	for (const FParkourCharacterEntry& Entry : Characters) {
+		DebugInfo.Log(FString::Printf(TEXT("%s %s"), *GetNameSafe(Entry.Actor), *UEnum::GetValueAsString(Entry.Parkour->GetCurrentParkourMode())));
+	}
+	DebugInfo.PopIndent();
+}
+
+/************************************************************/
+/*--------------------- Sample Graph -----------------------*/
+/************************************************************/
+
+UParkourReplicationGraph::UParkourReplicationGraph()
+{
+	for (int32 Mode = 0; Mode < NumParkourModes; ++Mode) {
+		ModeReplication.Add((EParkourMovement)Mode, DefaultModeReplication((EParkourMovement)Mode));
+	}
+}
+
+bool UParkourReplicationGraph::IsParkourCharacter(const AActor* Actor)
+{
+	return Actor->IsA<ACharacter>() && Actor->FindComponentByClass<UParkourMovementComponent>();
+}
+
+UNetConnection* UParkourReplicationGraph::FindOwnerConnection(const AActor* Actor)
+{
+	UNetConnection* Connection = Actor->GetNetConnection();
+	if (const UChildConnection* ChildConnection = Cast<UChildConnection>(Connection)) {
+		Connection = ChildConnection->Parent;
+	}
+	return Connection;
+}
+
+void UParkourReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// Every replicated class starts from its own defaults, the parkour node then sets the rate per connection
+	for (TObjectIterator<UClass> It; It; ++It) {
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+		if (!ActorCDO || !ActorCDO->GetIsReplicated() || Class->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists)) {
+			continue;
+		}
+
+		// Blueprint skeleton and reinstanced classes never spawn
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_"))) {
+			continue;
+		}
+
+		FClassReplicationInfo ClassInfo;
+		ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+		if (!ActorCDO->bAlwaysRelevant && !ActorCDO->bOnlyRelevantToOwner && !ActorCDO->IsA<ALevelScriptActor>()) {
+			ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+		}
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UParkourReplicationGraph::InitGlobalGraphNodes()
+{
+	ParkourNode = CreateNewNode<UParkourReplicationGraphNode>();
+	for (const TPair<EParkourMovement, FParkourModeReplication>& Pair : ModeReplication) {
+		if ((int32)Pair.Key < NumParkourModes) {
+			ParkourNode->ModeReplication[(int32)Pair.Key] = Pair.Value;
+		}
+	}
+	AddGlobalGraphNode(ParkourNode);
+
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = GridSpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UParkourReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* ConnectionManager)
+{
+	Super::InitConnectionGraphNodes(ConnectionManager);
+
+	// The connection's player controller and view target
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* ConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(ConnectionNode, ConnectionManager);
+
+	// Its other owner only actors. Kept apart from the node above, which drops a viewer's last view target from its
+	// list once the view target changes.
+	UReplicationGraphNode_ActorList* OwnerNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddConnectionGraphNode(OwnerNode, ConnectionManager);
+	OwnerNodes.Add(ConnectionManager->NetConnection, OwnerNode);
+}
+
+void UParkourReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection)
+{
+	Super::RemoveClientConnection(NetConnection);
+
+	OwnerNodes.Remove(NetConnection);
+}
+
+void UParkourReplicationGraph::AddOwnerOnlyActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	// Owners set after the actor starts replicating aren't followed, spawn owner only actors with their owner
+	UNetConnection* Connection = FindOwnerConnection(ActorInfo.Actor);
+	UReplicationGraphNode_ActorList* OwnerNode = Connection ? OwnerNodes.FindRef(Connection) : nullptr;
+	if (!OwnerNode) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Replication Graph_AddOwnerOnlyActor: %s is only relevant to its owner but isn't owned by a client connection."), *GetNameSafe(ActorInfo.Actor));
+		return;
+	}
+
+	OwnerNode->NotifyAddNetworkActor(ActorInfo);
+}
+
+void UParkourReplicationGraph::RemoveOwnerOnlyActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	UNetConnection* Connection = FindOwnerConnection(ActorInfo.Actor);
+	UReplicationGraphNode_ActorList* OwnerNode = Connection ? OwnerNodes.FindRef(Connection) : nullptr;
+	if (OwnerNode && OwnerNode->NotifyRemoveNetworkActor(ActorInfo, false)) {
+		return;
+	}
+
+	// Its owner changed or left since it was added
+	for (const TPair<TObjectPtr<UNetConnection>, TObjectPtr<UReplicationGraphNode_ActorList>>& Pair : OwnerNodes) {
+		if (Pair.Value->NotifyRemoveNetworkActor(ActorInfo, false)) {
+			return;
+		}
+	}
+}
+
+void UParkourReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	const AActor* Actor = ActorInfo.Actor;
+
+	if (Actor->bAlwaysRelevant) {
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+	}
+	else if (Actor->bOnlyRelevantToOwner) {
+		// Player controllers are gathered by their own connection's node as that connection's viewer
+		if (!Actor->IsA<APlayerController>()) {
+			AddOwnerOnlyActor(ActorInfo);
+		}
+	}
+	else if (IsParkourCharacter(Actor)) {
+		ParkourNode->NotifyAddNetworkActor(ActorInfo);
+	}
+	else if (Actor->IsRootComponentMovable()) {
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+	}
+	else {
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+	}
+}
+
+void UParkourReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	const AActor* Actor = ActorInfo.Actor;
+
+	if (Actor->bAlwaysRelevant) {
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+	else if (Actor->bOnlyRelevantToOwner) {
+		if (!Actor->IsA<APlayerController>()) {
+			RemoveOwnerOnlyActor(ActorInfo);
+		}
+	}
+	else if (IsParkourCharacter(Actor)) {
+		ParkourNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+	else if (Actor->IsRootComponentMovable()) {
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+	}
+	else {
+		GridNode->RemoveActor_Static(ActorInfo);
+	}
+}
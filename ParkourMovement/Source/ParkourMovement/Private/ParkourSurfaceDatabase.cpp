@@ -0,0 +1,250 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourSurfaceDatabase.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+/************************************************************/
+/*----------------------- Loading --------------------------*/
+/************************************************************/
+
+FParkourSurfaceDatabase::FParkourSurfaceDatabase()
+{
+}
+
+FParkourSurfaceDatabase::~FParkourSurfaceDatabase()
+{
+	Unload();
+}
+
+FString FParkourSurfaceDatabase::GetDatabasePath(const FString& MapName)
+{
+	return FPaths::ProjectContentDir() / TEXT("ParkourSurfaces") / (MapName + TEXT(".pksurf"));
+}
+
+bool FParkourSurfaceDatabase::Load(const FString& Path)
+{
+	Unload();
+
+	const double StartTime = FPlatformTime::Seconds();
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	if (!PlatformFile.FileExists(*Path)) {
+		return false;
+	}
+
+	MappedHandle.Reset(PlatformFile.OpenMapped(*Path));
+	if (MappedHandle) {
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	}
+
+	if (MappedRegion) {
+		Data = MappedRegion->GetMappedPtr();
+		DataSize = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(LoadedData, *Path)) {
+		Data = LoadedData.GetData();
+		DataSize = LoadedData.Num();
+	}
+	else {
+		Unload();
+		return false;
+	}
+
+	// Validate everything up front so lookups never have to
+	const FParkourSurfaceFileHeader* FileHeader = (DataSize >= (int64)sizeof(FParkourSurfaceFileHeader)) ? reinterpret_cast<const FParkourSurfaceFileHeader*>(Data) : nullptr;
+	if (!FileHeader || (FileHeader->Magic != ParkourSurfaceMagic) || (FileHeader->Version != ParkourSurfaceVersion)) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Surface Database_Load: %s is not a version %u parkour surface file."), *Path, ParkourSurfaceVersion);
+		Unload();
+		return false;
+	}
+
+	const uint64 CellsEnd = FileHeader->CellsOffset + ((uint64)FileHeader->NumCells * sizeof(FParkourSurfaceCell));
+	const uint64 PatchesEnd = FileHeader->PatchesOffset + ((uint64)FileHeader->NumPatches * sizeof(FParkourSurfacePatch));
+	if ((CellsEnd > (uint64)DataSize) || (PatchesEnd > (uint64)DataSize) || (FileHeader->CellSize <= 0.0f)) {
+		UE_LOG(LogTemp, Warning, TEXT("Parkour Surface Database_Load: %s is truncated."), *Path);
+		Unload();
+		return false;
+	}
+
+	Header = FileHeader;
+	Cells = reinterpret_cast<const FParkourSurfaceCell*>(Data + Header->CellsOffset);
+	Patches = reinterpret_cast<const FParkourSurfacePatch*>(Data + Header->PatchesOffset);
+	LoadTimeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	UE_LOG(LogTemp, Log, TEXT("Parkour Surface Database_Load: %s, %u cells, %u patches, %.2f ms, %.1f KB resident (%s, %.1f KB per km2)."),
+		*Path, Header->NumCells, Header->NumPatches, LoadTimeMs, DataSize / 1024.0, MappedRegion ? TEXT("mapped") : TEXT("loaded"), GetBytesPerSquareKm() / 1024.0);
+
+	return true;
+}
+
+void FParkourSurfaceDatabase::Unload()
+{
+	Header = nullptr;
+	Cells = nullptr;
+	Patches = nullptr;
+	Data = nullptr;
+	DataSize = 0;
+
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	LoadedData.Empty();
+}
+
+/************************************************************/
+/*----------------------- Lookups --------------------------*/
+/************************************************************/
+
+uint64 FParkourSurfaceDatabase::MakeCellKey(const FIntVector& Cell)
+{
+	// 21 bits per axis, offset so negative cells sort before positive ones
+	const uint64 X = (uint64)(Cell.X + (1 << 20)) & 0x1FFFFF;
+	const uint64 Y = (uint64)(Cell.Y + (1 << 20)) & 0x1FFFFF;
+	const uint64 Z = (uint64)(Cell.Z + (1 << 20)) & 0x1FFFFF;
+	return (X << 42) | (Y << 21) | Z;
+}
+
+FIntVector FParkourSurfaceDatabase::GetCell(const FVector& Location, double CellSize)
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+FIntVector FParkourSurfaceDatabase::GetCell(const FVector& Location) const
+{
+	return GetCell(Location, Header ? Header->CellSize : 1.0);
+}
+
+bool FParkourSurfaceDatabase::Contains(const FVector& Start, const FVector& End) const
+{
+	if (!Header) {
+		return false;
+	}
+
+	// The bounds are a box, so the segment is inside when both its ends are
+	const FBox Bounds(FVector(Header->BoundsMin), FVector(Header->BoundsMax));
+	return Bounds.IsInsideOrOn(Start) && Bounds.IsInsideOrOn(End);
+}
+
+bool FParkourSurfaceDatabase::GetProbeFlags(EParkourProbe Probe, EParkourSurfaceFlags& OutFlags)
+{
+	switch (Probe) {
+	case EParkourProbe::WallRunRight:
+	case EParkourProbe::WallRunLeft: OutFlags = EParkourSurfaceFlags::WallRunnable;
+		return true;
+	case EParkourProbe::LedgeWall: OutFlags = EParkourSurfaceFlags::Climbable;
+		return true;
+	case EParkourProbe::LedgeFloor: OutFlags = EParkourSurfaceFlags::Ledge;
+		return true;
+	default: OutFlags = EParkourSurfaceFlags::None;
+		return false;
+	}
+}
+
+int32 FParkourSurfaceDatabase::LowerBound(uint64 Key) const
+{
+	int32 Low = 0;
+	int32 High = (int32)Header->NumCells;
+
+	while (Low < High) {
+		const int32 Middle = Low + ((High - Low) / 2);
+		if (Cells[Middle].Key < Key) {
+			Low = Middle + 1;
+		}
+		else {
+			High = Middle;
+		}
+	}
+	return Low;
+}
+
+bool FParkourSurfaceDatabase::Sweep(const FVector& Start, const FVector& End, float Radius, EParkourSurfaceFlags RequiredFlags, FHitResult& OutHit) const
+{
+	if (!Header) {
+		return false;
+	}
+
+	// A patch is trusted this far from where the bake actually hit it, so any patch the sweep can touch has its point
+	// in a cell within that much, and the sweep's radius, of the segment
+	const double PatchExtent = GetPatchExtent();
+	const FVector Delta = End - Start;
+
+	FBox SearchBounds(Start, Start);
+	SearchBounds += End;
+	SearchBounds = SearchBounds.ExpandBy(PatchExtent + Radius);
+	const FIntVector MinCell = GetCell(SearchBounds.Min);
+	const FIntVector MaxCell = GetCell(SearchBounds.Max);
+
+	double BestTime = 2.0;
+	const FParkourSurfacePatch* BestPatch = nullptr;
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X) {
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y) {
+			// The column's cells along Z are one run of keys
+			const uint64 LastKey = MakeCellKey(FIntVector(X, Y, MaxCell.Z));
+			for (int32 CellIndex = LowerBound(MakeCellKey(FIntVector(X, Y, MinCell.Z))); (CellIndex < (int32)Header->NumCells) && (Cells[CellIndex].Key <= LastKey); ++CellIndex) {
+				const FParkourSurfaceCell& Cell = Cells[CellIndex];
+
+				for (uint32 Index = Cell.FirstPatch; Index < Cell.FirstPatch + Cell.NumPatches; ++Index) {
+					const FParkourSurfacePatch& Patch = Patches[Index];
+					if (((EParkourSurfaceFlags)Patch.Flags & RequiredFlags) == EParkourSurfaceFlags::None) {
+						continue;
+					}
+
+					// The center of the sphere touches the face when it reaches the plane pushed out by Radius
+					const FVector Normal(Patch.Normal);
+					const double Denominator = FVector::DotProduct(Delta, Normal);
+					if (Denominator >= 0.0) {
+						continue;
+					}
+
+					const FVector Point = FVector(Patch.Point) + (Normal * Radius);
+					const double Time = FVector::DotProduct(Point - Start, Normal) / Denominator;
+					if (Time < 0.0 || Time > 1.0 || Time >= BestTime) {
+						continue;
+					}
+
+					const FVector ImpactPoint = Start + (Delta * Time) - (Normal * Radius);
+					if (FVector::DistSquared(ImpactPoint, FVector(Patch.Point)) > FMath::Square(PatchExtent)) {
+						continue;
+					}
+
+					BestTime = Time;
+					BestPatch = &Patch;
+				}
+			}
+		}
+	}
+
+	if (!BestPatch) {
+		return false;
+	}
+
+	const FVector Normal(BestPatch->Normal);
+	OutHit = FHitResult(Start, End);
+	OutHit.bBlockingHit = true;
+	OutHit.Time = (float)BestTime;
+	OutHit.Distance = Delta.Size() * BestTime;
+	OutHit.Location = Start + (Delta * BestTime);
+	OutHit.ImpactPoint = OutHit.Location - (Normal * Radius);
+	OutHit.Normal = Normal;
+	OutHit.ImpactNormal = Normal;
+	return true;
+}
+
+/************************************************************/
+/*---------------------- Reporting -------------------------*/
+/************************************************************/
+
+double FParkourSurfaceDatabase::GetBytesPerSquareKm() const
+{
+	if (!Header) {
+		return 0.0;
+	}
+
+	// Unreal units are centimeters, 1 km2 is 1e10 cm2
+	const double AreaSquareKm = ((double)(Header->BoundsMax.X - Header->BoundsMin.X) * (double)(Header->BoundsMax.Y - Header->BoundsMin.Y)) / 1.0e10;
+	return (AreaSquareKm > 0.0) ? (DataSize / AreaSquareKm) : 0.0;
+}
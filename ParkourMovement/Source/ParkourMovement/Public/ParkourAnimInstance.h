@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "ParkourMovementComponent.h"
+#include "ParkourAnimInstance.generated.h"
+
+// Copies the owner's parkour snapshot on the animation worker thread. The buffer is found on the game thread in
+// PreUpdate, the copy is made in Update without locking.
+USTRUCT()
+struct PARKOURMOVEMENT_API FParkourAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FParkourAnimInstanceProxy() = default;
+	FParkourAnimInstanceProxy(UAnimInstance* Instance) : FAnimInstanceProxy(Instance) {}
+
+	const FParkourAnimSnapshot& GetSnapshot() const { return Snapshot; }
+
+protected:
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	// Owned by the parkour component, which outlives its character's animation
+	const FParkourAnimSnapshotBuffer* SnapshotBuffer = nullptr;
+
+	FParkourAnimSnapshot Snapshot;
+};
+
+/**
+ * Base for parkour characters' anim blueprints. Parkour holds the component's snapshot for the frame, read it
+ * with property access or from thread safe functions instead of calling the component, so the blueprint keeps
+ * to the fast path and updates on worker threads.
+ */
+UCLASS(Transient, Blueprintable)
+class PARKOURMOVEMENT_API UParkourAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement", meta = (BlueprintThreadSafe))
+		const FParkourAnimSnapshot& GetParkourSnapshot() const { return Parkour; }
+
+protected:
+	virtual void NativeInitializeAnimation() override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
+
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "ParkourMovement")
+		FParkourAnimSnapshot Parkour;
+
+	// Found when the animation initializes, read by the proxy on the game thread only
+	UPROPERTY(Transient)
+		TObjectPtr<UParkourMovementComponent> ParkourComponent;
+
+	friend struct FParkourAnimInstanceProxy;
+};
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Chaos/SimCallbackInput.h"
+#include "Chaos/SimCallbackObject.h"
+
+/* Game Thread */
+// The forces one component's parkour update asked for since they were last sent to the physics thread. The stick holds
+// until the wall run ends, the impulse is sent once.
+struct FParkourAsyncForces
+{
+	// Velocity change to add, the slide impulse
+	FVector Impulse = FVector::ZeroVector;
+
+	// Velocity the wall run and vertical wall run hold the character at along the wall, and up it when bStickZ
+	FVector StickVelocity = FVector::ZeroVector;
+	bool bStick = false;
+	bool bStickZ = false;
+};
+
+/* Physics Thread */
+struct FParkourAsyncForceAgentInput
+{
+	int32 AgentId = INDEX_NONE;
+
+	// The character's velocity when the input was sent, the stick works towards its target from there
+	FVector Velocity = FVector::ZeroVector;
+	FParkourAsyncForces Forces;
+};
+
+struct FParkourAsyncForceInput : public Chaos::FSimCallbackInput
+{
+	// Counts up with every input sent, inputs are pooled so the physics thread can't tell them apart by address
+	uint32 Sequence = 0;
+	TArray<FParkourAsyncForceAgentInput> Agents;
+
+	void Reset() { Agents.Reset(); }
+};
+
+struct FParkourAsyncForceAgentOutput
+{
+	int32 AgentId = INDEX_NONE;
+	FVector VelocityDelta = FVector::ZeroVector;
+};
+
+// One physics step's velocity changes, for the agents that got one
+struct FParkourAsyncForceOutput : public Chaos::FSimCallbackOutput
+{
+	TArray<FParkourAsyncForceAgentOutput> Agents;
+
+	void Reset() { Agents.Reset(); }
+};
+
+/**
+ * Integrates the parkour forces on the physics thread, once per physics step at its delta time, so with Tick Physics
+ * Async on they run at the fixed physics rate whatever the frame rate. The character is still moved by its
+ * CharacterMovementComponent on the game thread: each step outputs the velocity change it made, and the game thread
+ * adds up every step's change and applies the sum once, before the character's next move.
+ *
+ * The stick pulls the velocity towards its target at StickRate per second instead of setting it outright the way
+ * LaunchCharacter does, so how far it gets depends on the number of physics steps and not on the frames between them.
+ */
+class PARKOURMOVEMENT_API FParkourAsyncForceCallback : public Chaos::TSimCallbackObject<FParkourAsyncForceInput, FParkourAsyncForceOutput>
+{
+public:
+	// How quickly the stick closes the gap to its target velocity, per second
+	float StickRate = 60.0f;
+
+private:
+	virtual void OnPreSimulate_Internal() override;
+
+	// Physics thread only. What each agent's last input asked for and the velocity the steps since have given it.
+	struct FAgentState
+	{
+		FVector Velocity = FVector::ZeroVector;
+		FParkourAsyncForces Forces;
+
+		// The input's impulse, until a step has output it
+		bool bImpulsePending = false;
+	};
+
+	TMap<int32, FAgentState> AgentStates;
+	uint32 LastSequence = 0;
+};
@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ParkourBenchmarkSubsystem.generated.h"
+
+class ACharacter;
+class AActor;
+class UParkourMovementComponent;
+
+// Which of the parkour update's paths the agents run
+enum class EParkourBenchmarkPath : uint8 {
+	Component,	// The component's own update, batched by the world subsystem, with significance and dormancy
+	Movement	// Stepped from the character's moves by UParkourCharacterMovementComponent, as for networked players
+};
+
+// Where a benchmark runner is on its lane. Each stage is started by reaching a point on the course.
+enum class EParkourBenchmarkStage : uint8 {
+	RunUp,		// Sprint down the run up
+	Slide,		// Slide out of the sprint
+	WallRun,	// Jump onto the side wall
+	Climb,		// Jump at the block, vertical wall run, ledge grab and mantle
+	Finish		// Walk off the block and start the lane again
+};
+
+// One scripted runner and the lane it runs down
+USTRUCT()
+struct FParkourBenchmarkAgent
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+		TObjectPtr<ACharacter> Character = nullptr;
+
+	UPROPERTY(Transient)
+		TObjectPtr<UParkourMovementComponent> Parkour = nullptr;
+
+	FVector LaneStart = FVector::ZeroVector;
+	EParkourBenchmarkStage Stage = EParkourBenchmarkStage::RunUp;
+	float StageTime = 0.0f;
+	bool bWasFalling = false;
+
+	// Start the lane again at the finish. A runner that doesn't repeat stops there, or where it got stuck.
+	bool bRepeat = true;
+	bool bFinished = false;
+};
+
+// The measurements of one agent count
+struct FParkourBenchmarkResult
+{
+	EParkourBenchmarkPath Path = EParkourBenchmarkPath::Component;
+	int32 NumAgents = 0;
+	int32 NumFrames = 0;
+	double MeanGameThreadMs = 0.0;
+	double P99GameThreadMs = 0.0;
+	double MeanParkourMs = 0.0;
+	double P99ParkourMs = 0.0;
+	double QueriesPerFrame = 0.0;
+	double TransitionsPerSecond = 0.0;
+
+	// Heap allocations per update step that stayed in its mode, expected to be zero
+	double SteadyAllocationsPerUpdate = 0.0;
+};
+
+/**
+ * Headless benchmark for the parkour update. Builds a course of lanes out of engine cubes, spawns one
+ * AParkourMovementCharacter per lane and drives it with scripted input through sprint, slide, wall run,
+ * vertical wall run, ledge grab and mantle, then measures a fixed number of frames after a short warm up.
+ *
+ * The agents are AI controlled in a standalone game, so they run the component's update unless the Movement path is
+ * asked for, which steps them from their moves the way networked players are.
+ *
+ * Each agent count is written as JSON to Saved/Profiling/ParkourBenchmark and compared against
+ * Benchmarks/ParkourBenchmark_<N>.json (ParkourBenchmark_Movement_<N>.json for the move path) in the project directory
+ * when that baseline exists. A run fails when one of its costs grows past its baseline by more than BaselineTolerance,
+ * and quits with exit code 1 if it was asked to quit. To run every size and quit:
+ *     UnrealEditor ParkourMovement.uproject /Engine/Maps/Entry -game -nullrhi -unattended
+ *         -ExecCmds="Parkour.Benchmark 1,64,512,2048 600 Component" -ParkourBenchmarkQuit
+ *
+ * The ParkourMovement.Performance.Benchmark automation test runs the same sizes in PIE and fails with the runs.
+ */
+UCLASS()
+class PARKOURMOVEMENT_API UParkourBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/* Subsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	/* Tickable */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Benchmark */
+	// Runs every agent count in turn on InPath, measuring NumFrames frames of each
+	void StartBenchmark(const TArray<int32>& InAgentCounts, int32 InNumFrames, EParkourBenchmarkPath InPath);
+	void StopBenchmark();
+
+	bool IsRunning() const { return AgentCounts.IsValidIndex(CurrentRun); }
+
+	// The last benchmark's results, one per agent count run so far
+	const TArray<FParkourBenchmarkResult>& GetResults() const { return Results; }
+
+	// Every cost of the last benchmark that went past its baseline's tolerance, and the agent counts without a baseline
+	const TArray<FString>& GetBaselineFailures() const { return BaselineFailures; }
+	const TArray<int32>& GetMissingBaselines() const { return MissingBaselines; }
+
+	// Fraction a cost can grow over its baseline before the run fails
+	double BaselineTolerance = 0.1;
+
+	// Frames run before measuring, while the agents get onto their lanes
+	int32 NumWarmUpFrames = 60;
+
+	// Agents per row of lanes, rows are laid out along X
+	int32 LanesPerRow = 64;
+
+	/* Course */
+	// Spawns one lane's side wall and climb block into World, and a floor under the lane when bWithFloor. For running
+	// the script outside the benchmark, whose rows share one floor.
+	static void SpawnLaneBlocks(UWorld* World, const FVector& LaneStart, bool bWithFloor, TArray<TObjectPtr<AActor>>& OutActors);
+
+	/* Script */
+	// Drives Agent one frame down its lane with the benchmark's input
+	static void DriveAgent(FParkourBenchmarkAgent& Agent, float DeltaTime);
+
+private:
+	/* Runs */
+	void BeginRun();
+	void EndRun();
+
+	/* Course */
+	void SpawnRow(const FVector& RowStart, int32 NumLanes);
+	void SpawnAgent(const FVector& LaneStart);
+	void DestroyCourse();
+
+	static void SpawnBlock(UWorld* World, const FVector& Center, const FVector& Size, TArray<TObjectPtr<AActor>>& OutActors);
+
+	/* Script */
+	static void RestartLane(FParkourBenchmarkAgent& Agent);
+
+	/* Report */
+	FParkourBenchmarkResult MakeResult() const;
+	void WriteResult(const FParkourBenchmarkResult& Result) const;
+	void CompareWithBaseline(const FParkourBenchmarkResult& Result);
+
+	UPROPERTY(Transient)
+		TArray<FParkourBenchmarkAgent> Agents;
+
+	UPROPERTY(Transient)
+		TArray<TObjectPtr<AActor>> CourseActors;
+
+	TArray<int32> AgentCounts;
+	EParkourBenchmarkPath Path = EParkourBenchmarkPath::Component;
+	int32 CurrentRun = INDEX_NONE;
+	int32 NumFrames = 0;
+	int32 FrameIndex = 0;
+
+	// Per measured frame
+	TArray<double> GameThreadMs;
+	TArray<double> ParkourMs;
+
+	double MeasuredSeconds = 0.0;
+	uint64 StartSceneQueries = 0;
+	uint64 StartModeTransitions = 0;
+	uint64 StartSteadyUpdates = 0;
+	uint64 StartSteadyUpdateAllocations = 0;
+	uint64 LastUpdateCycles = 0;
+
+	TArray<FParkourBenchmarkResult> Results;
+	TArray<FString> BaselineFailures;
+	TArray<int32> MissingBaselines;
+};
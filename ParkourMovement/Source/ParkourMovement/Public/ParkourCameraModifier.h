@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/CameraModifier.h"
+#include "ParkourCameraModifier.generated.h"
+
+class APlayerController;
+class UCameraShakeBase;
+class UParkourMovementComponent;
+
+/**
+ * The parkour camera effects of a local player: the roll while wall running, the turn to look over the ledge while
+ * mantling, and the parkour camera shakes. Only the view is changed, the control rotation is left to the player.
+ *
+ * Added to a local player controller's camera manager by its character's parkour component, never on a dedicated
+ * server. Reads the view target's parkour snapshot each frame and does nothing for view targets that aren't the
+ * player's own character.
+ */
+UCLASS(Transient)
+class PARKOURMOVEMENT_API UParkourCameraModifier : public UCameraModifier
+{
+	GENERATED_BODY()
+
+public:
+	// Adds the modifier to PlayerController's camera manager unless it already has one. Returns the camera manager's
+	// modifier, null for controllers that aren't local.
+	static UParkourCameraModifier* AddTo(APlayerController* PlayerController);
+
+	// The modifier on PlayerController's camera manager, null if none was added
+	static UParkourCameraModifier* FindOn(const APlayerController* PlayerController);
+
+	// Starts ShakeClass on this camera only. The camera manager's shake modifier keeps finished shakes and hands
+	// them back out, so a shake played on every landing doesn't allocate after the first.
+	void PlayShake(TSubclassOf<UCameraShakeBase> ShakeClass, float Scale = 1.0f);
+
+	/* Camera Modifier */
+	virtual bool ModifyCamera(float DeltaTime, FMinimalViewInfo& InOutPOV) override;
+
+private:
+	// The view target's parkour component, null when the view target isn't a locally controlled parkour character
+	const UParkourMovementComponent* FindParkour();
+
+	TWeakObjectPtr<AActor> CachedViewTarget;
+	TWeakObjectPtr<const UParkourMovementComponent> CachedParkour;
+
+	// Blended toward their targets each frame, and back to nothing once the view target has no parkour
+	float CurrentRoll = 0.0f;
+	float MantleLookAlpha = 0.0f;
+
+	// World yaw into the ledge of the last mantle, held while the look blends back out
+	float MantleYaw = 0.0f;
+};
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/CharacterMovementReplication.h"
+#include "ParkourMovementComponent.h"
+#include "ParkourCharacterMovementComponent.generated.h"
+
+/* Saved Move */
+// Parkour state a move started from. Only the inputs go to the server, the parkour Jump, Sprint and CrouchSlide
+// presses in the custom compressed flags next to the jump and crouch. The mode, gates and timers stay on the client to
+// replay from.
+class FSavedMove_Parkour : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	enum ParkourCompressedFlags {
+		FLAG_JumpPress = FLAG_Custom_0,
+		FLAG_SprintPress = FLAG_Custom_1,
+		FLAG_CrouchSlidePress = FLAG_Custom_2
+	};
+
+	FParkourPredictedState SavedState;
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+};
+
+class FNetworkPredictionData_Client_Parkour : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_Parkour(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
+
+/* Move Response */
+// The server's parkour state, sent with a correction only: mode (4 bits), gate mask (6 bits), queued slide and sprint
+// (a bit each), armed timers (a bit each) and the milliseconds left on each armed timer (16 bits). Good moves send
+// nothing extra.
+struct FParkourMoveResponseDataContainer : public FCharacterMoveResponseDataContainer
+{
+	typedef FCharacterMoveResponseDataContainer Super;
+
+	FParkourPredictedState ParkourState;
+
+	virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+};
+
+/**
+ * CharacterMovementComponent that runs the parkour update inside PerformMovement, so every wall run, ledge grab and
+ * mantle is part of the saved move and is replayed when the client corrects. The parkour presses are held for the next
+ * move and run at its start, on the client and on the server, which runs each move from its own parkour state and the
+ * client's presses, never from a mode the client claims. A correction carries the server's parkour state back for the
+ * client to replay from.
+ *
+ * Corrections and the bits of parkour state they carry are counted in 'stat ParkourMovement' and by Parkour.NetReport.
+ * The ParkourMovement.Network.Prediction automation test runs the benchmark course on a lagged listen server client
+ * with and without prediction and compares them. Parkour.NetReport also logs what the replicated parkour state costs
+ * each character, to compare NetUpdateFrequency settings with.
+ */
+UCLASS(config = Game)
+class PARKOURMOVEMENT_API UParkourCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	UParkourCharacterMovementComponent();
+
+	// Run the parkour update from the character's moves instead of from the parkour component's own tick. Set from DefaultGame.ini.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "ParkourMovement | Network")
+		bool bPredictParkour = true;
+
+	// Set by UParkourMovementComponent::Initialize
+	void SetParkourComponent(UParkourMovementComponent* InParkourComponent);
+	UParkourMovementComponent* GetParkourComponent() const { return ParkourComponent; }
+
+	// Run the parkour update from moves for AI and standalone characters too. Off except for the benchmark's move path,
+	// those characters have no client to predict for and keep to the batched, significance and dormancy aware update.
+	bool bUpdateAllCharacters = false;
+
+	// True when moves drive the parkour update for this character: player controlled characters in a networked game,
+	// or every character with bUpdateAllCharacters. Simulated proxies don't run moves.
+	bool IsUpdatingParkour() const;
+
+	/* Counters */
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Network")
+		int32 GetNumCorrections() const { return NumCorrections; }
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Network")
+		int64 GetParkourCorrectionBits() const { return ParkourCorrectionBits; }
+
+	void AddParkourCorrectionBits(int32 Bits) { ParkourCorrectionBits += Bits; }
+
+	/* Prediction */
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+	virtual void ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations) override;
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+	virtual void OnClientCorrectionReceived(FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
+
+private:
+	UPROPERTY(Transient)
+		TObjectPtr<UParkourMovementComponent> ParkourComponent;
+
+	FParkourMoveResponseDataContainer ParkourMoveResponseContainer;
+
+	int32 NumCorrections = 0;
+	int64 ParkourCorrectionBits = 0;
+};
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "ParkourMovementComponent.h"
+#include "ParkourMassFragments.generated.h"
+
+/* Parkour State */
+// The parts of FParkourRuntimeState and the component's timers a crowd runner needs. Modes, gates and timers
+// mean the same as they do on UParkourMovementComponent, so an entity can be handed to a full actor and back.
+USTRUCT()
+struct PARKOURMOVEMENT_API FParkourMassStateFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	EParkourMovement Mode = EParkourMovement::None;
+
+	// EParkourGate bits. The wall run gates open on leaving the ground, the timers below open them again after a run.
+	uint8 GateMask = 0;
+
+	bool bFalling = false;
+	bool bSprintQueued = false;
+	bool bWallRunGravity = false;
+
+	float GravityScale = 1.0f;
+
+	// Wall the runner is on, for wall runs and vertical wall runs
+	FVector WallNormal = FVector::ZeroVector;
+	FVector WallLocation = FVector::ZeroVector;
+
+	// Where a ledge grab hangs from and where its mantle ends
+	FVector LedgeFloorPosition = FVector::ZeroVector;
+	FVector MantlePosition = FVector::ZeroVector;
+	float MantleTraceDistance = 0.0f;
+
+	// Seconds until each armed timer fires, zero when it isn't armed
+	float Timers[(uint8)EParkourTimer::Count] = {};
+
+	bool IsGateOpen(EParkourGate Gate) const { return EnumHasAnyFlags((EParkourGate)GateMask, Gate); }
+	void SetGateOpen(EParkourGate Gate, bool bOpen) { GateMask = bOpen ? (GateMask | (uint8)Gate) : (GateMask & ~(uint8)Gate); }
+};
+
+/* Input */
+// Written by whatever steers the crowd, a StateTree task or a game processor. The presses are consumed by
+// UParkourMassMovementProcessor the same way Jump, CrouchSlide and Sprint are on the component.
+USTRUCT()
+struct PARKOURMOVEMENT_API FParkourMassInputFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	// World space, at most unit length
+	FVector MoveInput = FVector::ZeroVector;
+
+	bool bJumpPressed = false;
+	bool bCrouchPressed = false;
+	bool bSprintPressed = false;
+};
+
+/* Probes */
+// Results of the probes UParkourMassProbeProcessor ran for the entity this frame, indexed by EParkourProbe.
+// LedgeGround is not used, the SlideFloor probe doubles as the floor check.
+USTRUCT()
+struct PARKOURMOVEMENT_API FParkourMassProbeFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	// Bit per EParkourProbe that was run, and bit per probe that hit
+	uint8 ProbedMask = 0;
+	uint8 HitMask = 0;
+
+	FVector Points[(uint8)EParkourProbe::Count];
+	FVector Normals[(uint8)EParkourProbe::Count];
+	float Distances[(uint8)EParkourProbe::Count] = {};
+
+	bool HasHit(EParkourProbe Probe) const { return (HitMask & (1 << (uint8)Probe)) != 0; }
+	bool WasProbed(EParkourProbe Probe) const { return (ProbedMask & (1 << (uint8)Probe)) != 0; }
+};
+
+/* Settings */
+// Shared by every entity built from the same trait. The tuning is the same asset the full characters use,
+// the capsule and walking values stand in for the ACharacter and UCharacterMovementComponent defaults.
+USTRUCT()
+struct PARKOURMOVEMENT_API FParkourMassSettingsFragment : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement")
+		TObjectPtr<UParkourMovementSettings> Settings;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement", meta = (ClampMin = "1"))
+		float CapsuleRadius = 42.0f;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement", meta = (ClampMin = "1"))
+		float CapsuleHalfHeight = 96.0f;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement")
+		float BaseEyeHeight = 64.0f;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement")
+		float MaxWalkSpeed = 500.0f;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement")
+		float MaxWalkSpeedCrouched = 300.0f;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement")
+		float MaxAcceleration = 1500.0f;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement")
+		float BrakingDecelerationWalking = 2000.0f;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement")
+		float JumpZVelocity = 700.0f;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement", meta = (ClampMin = "0", ClampMax = "1"))
+		float AirControl = 0.35f;
+
+	const UParkourMovementSettings& GetSettings() const { return Settings ? *Settings : *GetDefault<UParkourMovementSettings>(); }
+};
+
+/* Tags */
+USTRUCT()
+struct PARKOURMOVEMENT_API FParkourMassAgentTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+// Set while the entity is represented by a spawned parkour character, whose component runs the full update.
+// The crowd processors leave these entities alone and UParkourMassActorHandoffProcessor copies the actor back.
+USTRUCT()
+struct PARKOURMOVEMENT_API FParkourMassActorDrivenTag : public FMassTag
+{
+	GENERATED_BODY()
+};
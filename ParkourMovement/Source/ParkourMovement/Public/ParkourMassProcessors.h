@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "ParkourMassFragments.h"
+#include "ParkourMassProcessors.generated.h"
+
+class UParkourMovementWorldSubsystem;
+
+// One probe an entity needs this frame. Points into the entity's probe fragment, which stays put until the
+// processor's deferred commands run.
+struct FParkourMassProbeRequest
+{
+	FParkourMassProbeFragment* Result = nullptr;
+	EParkourProbe Probe = EParkourProbe::Count;
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	// Zero for a line
+	float Radius = 0.0f;
+	float HalfHeight = 0.0f;
+	ECollisionChannel Channel = ECC_Visibility;
+
+	// Answered by the surface database instead of a scene query
+	bool bFromDatabase = false;
+	bool bHit = false;
+	FHitResult Hit;
+};
+
+/**
+ * Crowd parkour runners, thousands of entities moved by the same rules as UParkourMovementComponent without
+ * a character, movement component or parkour component each. See UParkourMassTrait for setting them up.
+ *
+ * The work is split in three processors, each walking the runners' chunks:
+ *   Probe     gathers the probes each runner's mode needs into one batch and answers it in parallel, from the
+ *             baked surface database where the level has one and with scene queries elsewhere
+ *   Movement  applies the gates, transitions and movement of UParkourMovementComponent to the probe results
+ *   Handoff   hands runners represented by a spawned parkour character to its component, and back again
+ *
+ * Probe and Movement skip chunks the Simulation LOD isn't ticking this frame, and runners at Off LOD.
+ * Parkour.Mass.MaxSceneQueries caps the scene queries a frame may issue, runners over the cap keep last
+ * frame's results.
+ */
+UCLASS()
+class PARKOURMOVEMENT_API UParkourMassProbeProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UParkourMassProbeProcessor();
+
+protected:
+	virtual void Initialize(UObject& Owner) override;
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	// Adds the probes the runner's mode needs to Requests
+	void GatherRequests(const FTransform& Transform, const FParkourMassStateFragment& State, const FParkourMassInputFragment& Input,
+		const FParkourMassSettingsFragment& Settings, FParkourMassProbeFragment& Result);
+	void AddRequest(FParkourMassProbeFragment& Result, EParkourProbe Probe, const FVector& Start, const FVector& End, float Radius, float HalfHeight, ECollisionChannel Channel);
+
+	// Runs on any thread
+	void RunRequest(FParkourMassProbeRequest& Request) const;
+
+	FMassEntityQuery EntityQuery;
+
+	UPROPERTY(Transient)
+		TObjectPtr<UParkourMovementWorldSubsystem> ParkourSubsystem;
+
+	// Reused every frame, so a steady crowd doesn't allocate
+	TArray<FParkourMassProbeRequest> Requests;
+
+	// Rotates which runners get scene queries when the crowd is over the frame's cap
+	uint32 FrameCounter = 0;
+};
+
+UCLASS()
+class PARKOURMOVEMENT_API UParkourMassMovementProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UParkourMassMovementProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+};
+
+UCLASS()
+class PARKOURMOVEMENT_API UParkourMassActorHandoffProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UParkourMassActorHandoffProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	// Starts the spawned character's component from where the entity was, mode, gates and timers included
+	static void HandToActor(UParkourMovementComponent& Parkour, const FParkourMassStateFragment& State, const FVector& Velocity);
+
+	// Copies the component back every frame the actor drives the entity, so the entity carries on from there
+	static void TakeFromActor(const UParkourMovementComponent& Parkour, FParkourMassStateFragment& State, FTransform& Transform, FVector& Velocity);
+
+	FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTraitBase.h"
+#include "ParkourMassFragments.h"
+#include "ParkourMassTrait.generated.h"
+
+/**
+ * Makes an entity a crowd parkour runner, moved by the parkour processors instead of a character and its
+ * movement components. Use it in place of the Movement trait.
+ *
+ * For the handoff to full actors, add the Simulation LOD trait and a visualization trait that spawns the
+ * parkour character as its high resolution actor. Entities close enough to be represented by that actor are
+ * updated by its UParkourMovementComponent, the rest by the processors.
+ */
+UCLASS(meta = (DisplayName = "Parkour Runner"))
+class PARKOURMOVEMENT_API UParkourMassTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement")
+		FParkourMassSettingsFragment Settings;
+};
@@ -12,38 +12,337 @@
 #include "Kismet/KismetSystemLibrary.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Math/Vector.h"
+#include "HAL/PlatformProcess.h"
+#include <atomic>
 //#include "LegacyCameraShake.h"
-#include "TimerManager.h"
+#include "ParkourRecorder.h"
+#include "ParkourReplication.h"
+#include "ParkourCoreTypes.h"
+#include "ParkourRules.h"
+#include "ParkourWorldQuery.h"
+#include "ParkourTransitions.h"
+#include "ParkourAsyncForces.h"
+#include "ParkourMovementSettings.h"
 #include "ParkourMovementComponent.generated.h"
 
-// Macro Definitions
-#define ForwardInput(MyVector1, MyVector2) (FVector::DotProduct(MyVector1, MyVector2));
-#define WallRunning(CParkourMode) ((CParkourMode == EParkourMovement(1)) || (CParkourMode == EParkourMovement(2)))
-#define CanWallRun(MyFloat, CParkourMode, MyBool) ((MyFloat > 0) && ((CParkourMode == EParkourMovement(0)) || MyBool == true));
-#define WallRunEndRight(ActorLocation, ActorRightVector, ActorForwardVector) (ActorLocation + (ActorRightVector * 75.f) + (ActorForwardVector * -35.f));
-#define WallRunEndLeft(ActorLocation, ActorRightVector, ActorForwardVector) (ActorLocation + (ActorRightVector * -75.f) + (ActorForwardVector * -35.f));
-#define ValidWallRunVector(MyVector) (MyVector.Z < 0.52 && MyVector.Z > -0.52)
-#define CanVerticalWallRun(MyFloat, CParkourMode, MyBool, MySecondBool) ((MyFloat > 0) && (MyBool) && ((CParkourMode == EParkourMovement::None) || (CParkourMode == EParkourMovement::VerticalWallRun) || (MySecondBool)))
-#define MantleVectorEyes(MyEyesVector, MyForwardVector) ((MyEyesVector + FVector(0, 0, 50)) + (MyForwardVector * 50))
-#define MantleVectorFeet(MyLocationVector, MyFloat, MySecondFloat, MyForwardVector) ((MyLocationVector - FVector(0, 0, (MyFloat - MySecondFloat))) + (MyForwardVector * 50))
-#define CanMantle(MyFloat, CParkourMode, MyBool) ((MyFloat > 0) && ((CParkourMode == EParkourMovement::LedgeGrab) || MyBool))
-#define QuickMantle(MyFloat, MySecondFloat, MyBool) ((MyFloat > MySecondFloat) || MyBool)
-#define CanSlide(MyFloat, CParkourMode, MyBool) ((MyFloat > 0) && ((CParkourMode == EParkourMovement::Sprint) || MyBool))
-#define CanSprint(MyBool, CParkourMode) (MyBool && (CParkourMode == EParkourMovement::None))
+class UParkourMovementWorldSubsystem;
+class UParkourCharacterMovementComponent;
+class UParkourMovementComponent;
 
+/* Scene Queries */
+// Last async query submitted for a probe and the result consumed from the one before it.
+struct FParkourProbeSlot
+{
+	FTraceHandle PendingHandle;
+	uint64 SubmitFrame = 0;
+
+	// The newest result, async or from the sync fallback, and the frame it was traced on
+	FHitResult Result;
+	bool bResultBlockingHit = false;
+	bool bHasResult = false;
+	uint64 ResultFrame = 0;
+
+	// Consecutive frames the async result disagreed with the sync trace, when comparing both paths.
+	int32 MismatchFrames = 0;
+};
+
+// Everything about a probe that doesn't change from one trace to the next, built once per component by
+// BuildProbeQueries so a trace makes no query params, shapes or channel conversions of its own.
+struct FParkourProbeQuery
+{
+	ECollisionChannel Channel = ECC_Visibility;
+	FCollisionShape Shape;
+
+	// Simple collision, ignoring the character doing the probing
+	FCollisionQueryParams Params;
+
+	// The same, for movables only, where the surface database answers for static geometry
+	FCollisionQueryParams DynamicParams;
+
+	// Class of the character the params ignore, so probe cache entries are only shared between the same kind of character
+	const UClass* IgnoredClass = nullptr;
+};
+
+// The component's probes, as the world the parkour core's probe decisions are made against
+struct FParkourComponentWorldQuery final : public IParkourWorldQuery
+{
+	explicit FParkourComponentWorldQuery(UParkourMovementComponent& InComponent) : Component(InComponent) {}
+
+	virtual bool Trace(EParkourProbe Probe, const FVector& Start, const FVector& End, FParkourQueryHit& OutHit) override;
+
+	// The full result of the last trace, for callers that hand a hit result on
+	const FHitResult& GetLastHit() const { return LastHit; }
+
+private:
+	UParkourMovementComponent& Component;
+	FHitResult LastHit;
+};
+
+// The component's handlers, as the target the transition table's actions run on
+struct FParkourComponentTransitionTarget final : public IParkourTransitionTarget
+{
+	explicit FParkourComponentTransitionTarget(UParkourMovementComponent& InComponent) : Component(InComponent) {}
+
+	virtual void OpenGates() override;
+	virtual void CrouchStart() override;
+	virtual void CrouchEnd() override;
+	virtual void WallRunJump() override;
+	virtual void WallRunEnd(float ResetTime) override;
+	virtual void VerticalWallRunEnd(float ResetTime) override;
+	virtual void LedgeGrabJump() override;
+	virtual void SlideJump() override;
+	virtual void SlideEnd(bool bIsCrouched) override;
+	virtual void CrouchJump() override;
+	virtual void SprintJump() override;
+	virtual void SprintEnd() override;
+	virtual void ResetMovement() override;
+	virtual void WallRunExit() override;
+	virtual void LedgeGrabEnter() override;
+	virtual void SprintEnter() override;
+
+private:
+	UParkourMovementComponent& Component;
+};
+
+/* Batched Update */
+// Per agent state gathered by UParkourMovementWorldSubsystem on the game thread and then evaluated in parallel.
+// Only plain data lives here so the predicate phase can go wide without touching any UObject.
+struct FParkourAgentHotState
+{
+	// Inputs
+	FVector ForwardVector = FVector::ZeroVector;
+	FVector LastInputVector = FVector::ZeroVector;
+	EParkourMovement CurrentParkourMode = EParkourMovement::None;
+	bool bIsFalling = false;
+	bool bIsWalking = false;
+	bool bSprintQueued = false;
+
+	// Predicates
+	float ForwardInputValue = 0.0f;
+	bool bCanWallRun = false;
+	bool bCanVerticalWallRun = false;
+	bool bCanSlide = false;
+	bool bCanSprint = false;
+
+	void EvaluatePredicates();
+};
+
+/* Timers */
+// The component's cooldowns and delayed gate openings. Each has a single deadline, arming it again moves the deadline.
+enum class EParkourTimer : uint8 {
+	WallRunOpenGate,		// OpenWallRunGate once a wall run has ended
+	WallRunEnableGravity,	// WallRunEnableGravity a second into a wall run
+	MantleCheck,			// OpenMantleCheckGate once a ledge grab has settled
+	VerticalRunEndGate,		// OpenVerticalWallRunGate once a vertical wall run has ended
+	CheckQueues,			// CheckQueues just after a vertical wall run has ended
+	OpenSprintGate,			// OpenSprintGate once a sprint has ended
+	VerticalWallRunEnd,		// VerticalWallRunEndEvent once VerticalWallRunTime is up
+	Count
+};
+
+/* Prediction */
+// Jump, Sprint and CrouchSlide calls made since the character's last move. While moves run the parkour update the
+// calls are held here and run at the start of the next move, on the client and on the server, which gets them in the
+// move's compressed flags.
+enum class EParkourPress : uint8 {
+	None = 0,
+	Jump = 1 << 0,
+	Sprint = 1 << 1,
+	CrouchSlide = 1 << 2
+};
+ENUM_CLASS_FLAGS(EParkourPress);
+
+// Parkour state a character move starts from. The client saves it with every move and sends only the presses made for
+// the move, for the server to run the move from its own state. The server sends the rest back with a correction and
+// the client takes it on before replaying.
+struct FParkourPredictedState
+{
+	// The move's input
+	EParkourPress Presses = EParkourPress::None;
+
+	EParkourMovement Mode = EParkourMovement::None;
+	uint8 GateMask = 0;
+
+	// Timers as the seconds left on each as of the move, so they keep their deadlines when the state is taken on later
+	uint8 ArmedTimers = 0;
+	float TimerRemaining[(uint8)EParkourTimer::Count] = {};
+
+	bool bSlideQueued = false;
+	bool bSprintQueued = false;
+
+	// Client only, so a replayed move runs the same number of fixed steps it did the first time
+	float UpdateAccumulator = 0.0f;
+};
+
+/* Runtime State */
+// Everything the update carries from one step to the next, kept together and apart from the tuning, which is
+// shared between components in UParkourMovementSettings.
+struct FParkourRuntimeState
+{
+	// Surfaces found by the probes
+	FVector WallRunNormal = FVector::ZeroVector;
+	FVector WallRunLocation = FVector::ZeroVector;
+	FVector VerticalWallRunNormal = FVector::ZeroVector;
+	FVector VerticalWallRunLocation = FVector::ZeroVector;
+	FVector LedgeFloorPosition = FVector::ZeroVector;
+	FVector LedgeClimbWallPosition = FVector::ZeroVector;
+	FVector LedgeClimbWallNormal = FVector::ZeroVector;
+	FVector MantlePosition = FVector::ZeroVector;
+	float MantleTraceDistance = 0.0f;
+
+	// Current parkour mode in the low nibble, previous in the high nibble
+	uint8 ParkourModes = 0;
+	TEnumAsByte<EMovementMode> PreviousMovementMode = MOVE_None;
+	TEnumAsByte<EMovementMode> CurrentMovementMode = MOVE_None;
+
+	// EParkourGate bits
+	uint8 GateMask = 0;
+
+	uint8 bSlideQueued : 1;
+	uint8 bSprintQueued : 1;
+	uint8 bLedgeCloseToGround : 1;
+	uint8 bIsWallRunGravity : 1;
+
+	FParkourRuntimeState()
+		: bSlideQueued(false), bSprintQueued(false), bLedgeCloseToGround(false), bIsWallRunGravity(false)
+	{
+	}
+
+	EParkourMovement GetCurrentMode() const { return (EParkourMovement)(ParkourModes & 0x0F); }
+	EParkourMovement GetPreviousMode() const { return (EParkourMovement)(ParkourModes >> 4); }
+	void SetModes(EParkourMovement PreviousMode, EParkourMovement CurrentMode) { ParkourModes = (uint8)(((uint8)PreviousMode << 4) | (uint8)CurrentMode); }
+
+	bool IsGateOpen(EParkourGate Gate) const { return EnumHasAnyFlags((EParkourGate)GateMask, Gate); }
+	void SetGateOpen(EParkourGate Gate, bool bOpen) { GateMask = bOpen ? (GateMask | (uint8)Gate) : (GateMask & ~(uint8)Gate); }
+};
+
+static_assert(NumParkourModes <= 16, "Both parkour modes share a byte");
+
+/* Deferred Events */
+// Blueprint dispatchers that take no parameters, raised at most once per flush
+enum class EParkourEventFlags : uint8 {
+	None = 0,
+	Update = 1 << 0,
+	Jump = 1 << 1,
+	Land = 1 << 2,
+	Sprint = 1 << 3,
+	CrouchSlide = 1 << 4,
+	QueuesCheck = 1 << 5
+};
+ENUM_CLASS_FLAGS(EParkourEventFlags);
+
+// Blueprint events raised since the last flush. Mode changes are coalesced from the first previous mode to the
+// last new one, so a mode that bounces inside one frame fires a single event, or none if it ends where it started.
+struct FParkourPendingEvents
+{
+	EParkourEventFlags Flags = EParkourEventFlags::None;
+
+	bool bParkourChanged = false;
+	EParkourMovement ParkourChangedFrom = EParkourMovement::None;
+	EParkourMovement ParkourChangedTo = EParkourMovement::None;
+
+	bool bMovementChanged = false;
+	TEnumAsByte<EMovementMode> MovementChangedFrom = MOVE_None;
+	TEnumAsByte<EMovementMode> MovementChangedTo = MOVE_None;
+
+	bool bWallRunEnd = false;
+	float WallRunEndResetTime = 0.0f;
+
+	bool IsEmpty() const { return (Flags == EParkourEventFlags::None) && !bParkourChanged && !bMovementChanged && !bWallRunEnd; }
+};
+
+/* Animation Snapshot */
 UENUM(BlueprintType)
-enum class EParkourMovement : uint8 {
-	None = 0 UMETA(DisplayName = "None"),
-	LeftWallRun = 1 UMETA(DisplayName = "LeftWallRun"),
-	RightWallRun = 2 UMETA(DisplayName = "RightWallRun"),
-	VerticalWallRun = 3 UMETA(DisplayName = "VerticalWallRun"),
-	LedgeGrab = 4 UMETA(DisplayName = "LedgeGrab"),
-	Mantle = 5 UMETA(DisplayName = "Mantle"),
-	Slide = 6 UMETA(DisplayName = "Slide"),
-	Crouch = 7 UMETA(DisplayName = "Crouch"),
-	Sprint = 8 UMETA(DisplayName = "Sprint")
+enum class EParkourWallSide : uint8 {
+	None,
+	Left,
+	Right,
+	// Vertical wall run, ledge grab and mantle face the wall
+	Front
+};
+
+// What the animation needs from the parkour component, published once at the end of every frame's update so
+// animation worker threads never read the component itself. See UParkourAnimInstance.
+USTRUCT(BlueprintType)
+struct PARKOURMOVEMENT_API FParkourAnimSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "ParkourMovement")
+		EParkourMovement Mode = EParkourMovement::None;
+
+	UPROPERTY(BlueprintReadOnly, Category = "ParkourMovement")
+		EParkourWallSide Side = EParkourWallSide::None;
+
+	// Normal of the wall the character is on in actor space, zero off the wall
+	UPROPERTY(BlueprintReadOnly, Category = "ParkourMovement")
+		FVector WallNormal = FVector::ZeroVector;
+
+	// Height of the ledge above the character's feet while grabbing or mantling it
+	UPROPERTY(BlueprintReadOnly, Category = "ParkourMovement")
+		float LedgeHeight = 0.0f;
+
+	// 0 to 1 through the mantle's move, 0 outside a mantle
+	UPROPERTY(BlueprintReadOnly, Category = "ParkourMovement")
+		float MantleProgress = 0.0f;
+
+	// Degrees the floor falls away along the character's velocity, negative uphill. Zero off the ground.
+	UPROPERTY(BlueprintReadOnly, Category = "ParkourMovement")
+		float SlideSlope = 0.0f;
+
+	// Seconds since the current mode was entered, as of the frame it was published
+	UPROPERTY(BlueprintReadOnly, Category = "ParkourMovement")
+		float TimeInMode = 0.0f;
+
+	// GFrameCounter when it was published
+	uint64 FrameNumber = 0;
+};
+
+// One snapshot behind a sequence count the game thread makes odd while it writes and even again after. A reader copies
+// the snapshot between two loads of the count and copies again if a publish started or ran in between, so it never
+// keeps a torn copy however often the game thread publishes. The game thread never waits on readers.
+struct FParkourAnimSnapshotBuffer
+{
+	// Game thread only, a single writer
+	void Publish(const FParkourAnimSnapshot& Snapshot)
+	{
+		const uint32 Start = Sequence.load(std::memory_order_relaxed);
+		Sequence.store(Start + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Data = Snapshot;
+
+		Sequence.store(Start + 2, std::memory_order_release);
+	}
+
+	// Any number of readers on any thread. Retries while a publish overlaps the copy, which is rare and short.
+	FParkourAnimSnapshot Read() const
+	{
+		FParkourAnimSnapshot Result;
+		while (true) {
+			const uint32 Before = Sequence.load(std::memory_order_acquire);
+			if (Before & 1) {
+				FPlatformProcess::YieldThread();
+				continue;
+			}
+
+			Result = Data;
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Sequence.load(std::memory_order_relaxed) == Before) {
+				return Result;
+			}
+		}
+	}
+
+private:
+	FParkourAnimSnapshot Data;
+	std::atomic<uint32> Sequence { 0 };
 };
 
+// Native Delegates
+DECLARE_MULTICAST_DELEGATE_TwoParams(FParkourModeChangedNativeDelegate, EParkourMovement /*PrevParkourMode*/, EParkourMovement /*NewParkourMode*/);
+
 // Event Dispatchers
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FMovementChangedDelegate, EMovementMode, PrevMovementMode, EMovementMode, NewMovementMode);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FParkourMovementChangedDelegate, EParkourMovement, PrevParkourMode, EParkourMovement, NewParkourMode);
@@ -57,68 +356,293 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FQueuesEventDelegate);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FLandEventDelegate);
 
 
-UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+UCLASS(ClassGroup = (Custom), config = Game, meta = (BlueprintSpawnableComponent))
 class PARKOURMOVEMENT_API UParkourMovementComponent : public UActorComponent
 {
 	GENERATED_BODY()
 
+	friend class UParkourMovementWorldSubsystem;
+	friend class UParkourCharacterMovementComponent;
+	friend struct FParkourComponentTransitionTarget;
+	friend class UParkourMassActorHandoffProcessor;
+	friend struct FParkourComponentWorldQuery;
+
 public:
 	// Sets default values for this component's properties
 	UParkourMovementComponent();
 
-	/* Check Queues Timer */
-	FTimerHandle CheckQueuesEventHandle;
-
-	/* Update Event Timer */
-	float InitializeTime = 0.0167f;
-	FTimerHandle UpdateEventHandle;
-
+	/* Fixed Step Update */
+	// Simulation step used by the parkour update and every interpolation inside it.
+	// The tick accumulates frame time and runs as many fixed steps as fit, so the
+	// wall run and mantle trajectories are the same at 30, 60 or 144 Hz.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Update", meta = (ClampMin = "0.001"))
+		float FixedTimeStep = 1.0f / 60.0f;
+
+	// Upper bound on the steps run in a single frame. Any remaining time is dropped
+	// so a long hitch cannot snowball into ever longer frames.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Update", meta = (ClampMin = "1"))
+		int32 MaxSubSteps = 8;
+
+	// Submit the wall run, ledge and slide probes as async scene queries and consume the results on the next frame,
+	// so the physics scene can run them alongside the rest of the frame. Set from DefaultGame.ini.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "ParkourMovement | Update")
+		bool bUseAsyncSceneQueries = false;
+
+	// Oldest async probe result still answered from, in frames. Older results fall back to a sync trace.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ParkourMovement | Update", meta = (ClampMin = "1"))
+		int32 MaxAsyncProbeAge = 2;
+
+	// Answer probes from the world's shared cache of wall and ledge hits when one has been traced close by.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "ParkourMovement | Update")
+		bool bUseProbeCache = true;
+
+	// Hand the wall run stick, the vertical wall run launch and the slide impulse to the world's physics thread callback,
+	// which integrates them at the fixed physics step, see FParkourAsyncForceCallback. Needs Tick Physics Async in the
+	// project's physics settings and is ignored for characters whose moves run the update. Set from DefaultGame.ini.
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "ParkourMovement | Update")
+		bool bUseAsyncPhysicsForces = false;
+
+	// Let the world's UParkourMovementWorldSubsystem update this component together with every other
+	// parkour component in phases, instead of ticking on its own.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ParkourMovement | Update")
+		bool bUseBatchedUpdate = true;
+
+	// Stop updating altogether while the character stands idle: no parkour mode, walking, every gate closed and
+	// no timer pending. Input, a movement mode change, a mode set from outside or a timer being armed wakes it.
+	// OnUpdateEvent is not raised while the component is dormant.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Update")
+		bool bAllowDormancy = true;
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Update")
+		bool IsDormant() const { return bDormant; }
+
+	// Runs a single fixed step of the parkour update.
 	UFUNCTION(BlueprintCallable)
 		void UpdateEventMethod();
 
-	/* Wall Run Enable Gravity Event Timer */
-	FTimerHandle WallRunEnableGravityEventHandle;
-
-	/* Wall Run End Open Gate Event Timer */
-	FTimerHandle WallRunOpenGateEventHandle;
-
-	/* Vertical Run End Gate Event Timer */
-	FTimerHandle VerticalWallRunEndEventHandle;
-
-	/* Mantle Check Gate Event Timer */
-	FTimerHandle MantleCheckEventHandle;
-
-	/* Open Mantle Check Gate Event Timer */
-	FTimerHandle OpenMantleCheckGateEventHandle;
+	/* Settings */
+	// Tuning shared with every other component of the same archetype. The class defaults are used when none is set.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement")
+		TObjectPtr<UParkourMovementSettings> Settings;
 
-	/* Vertical Run End Open Gate Event Timer */
-	FTimerHandle VerticalRunEndGateEventHandle;
+	const UParkourMovementSettings& GetSettings() const { return Settings ? *Settings : *GetDefault<UParkourMovementSettings>(); }
 
-	/* Open Sprint Gate Event Timer */
-	FTimerHandle OpenSprintGateEventHandle;
+	/* Significance */
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Significance")
+		EParkourSignificance GetSignificance() const { return Significance; }
 
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	// Called when the game ends or the component is destroyed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	// What the engine counts for the object, plus the recorder's ring and the playback buffer, which it can't see
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
 	ACharacter* Character;
 	UCharacterMovementComponent* CharacterMovementComponent;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Parkour")
-		EParkourMovement PreviousParkourMode;
+	/* Fixed Step Update */
+	// Time carried over between frames that has not yet been consumed by a fixed step.
+	float UpdateAccumulator = 0.0f;
+
+	// Adds frame time to the accumulator and returns how many fixed steps should run now.
+	int32 ConsumeFixedSteps(float DeltaTime);
+
+	// Length of one update, FixedTimeStep stretched by the significance bucket's StepMultiplier
+	float GetStepTime() const;
+
+	// Starts or stops the fixed step update, on the world subsystem or on the component's own tick
+	void SetUpdateEnabled(bool bEnabled);
+
+	/* Launches */
+	// LaunchCharacter overwrites the character's pending launch, so a frame running several steps would keep whichever came
+	// last while treating each as applied. Launches made inside a step are held here and the last one is applied once after them.
+	struct FParkourDeferredLaunch
+	{
+		FVector Velocity = FVector::ZeroVector;
+		bool bXYOverride = false;
+		bool bZOverride = false;
+		bool bPending = false;
+	};
+
+	FParkourDeferredLaunch DeferredLaunch;
+	bool bDeferLaunches = false;
+
+	// Launches the character now, or after the steps when called from inside one
+	void LaunchCharacter(const FVector& Velocity, bool bXYOverride, bool bZOverride);
+
+	// Applies the last launch made by this frame's steps, called by whatever ran them
+	void ApplyDeferredLaunch();
+
+	/* Dormancy */
+	bool bDormant = false;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Parkour")
-		EParkourMovement CurrentParkourMode;
+	// True when nothing the update does can change the character until something from outside wakes it
+	bool CanGoDormant() const;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Parkour")
-		TEnumAsByte<EMovementMode> PreviousMovementMode;
+	// Checked at the end of every frame's update
+	void TryGoDormant();
+	void WakeUp();
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Parkour")
-		TEnumAsByte<EMovementMode> CurrentMovementMode;
+	/* Significance */
+	EParkourSignificance Significance = EParkourSignificance::High;
+	double NextSignificanceTime = 0.0;
+
+	const FParkourSignificanceBucket& GetSignificanceBucket() const;
+
+	// Rescores the character once SignificanceInterval has passed, and counts it in its bucket's stat. Called every frame.
+	void UpdateSignificance();
+	EParkourSignificance ScoreSignificance() const;
+
+	// World subsystem found in Initialize, null outside game worlds
+	UPROPERTY(Transient)
+		TObjectPtr<UParkourMovementWorldSubsystem> ParkourSubsystem;
+
+	/* Batched Update */
+	// Slot in the world subsystem's registry, INDEX_NONE while the component ticks on its own.
+	int32 BatchedUpdateIndex = INDEX_NONE;
+
+	/* Async Physics Forces */
+	// Id in the world subsystem's async force registry, INDEX_NONE unless bUseAsyncPhysicsForces registered it
+	int32 AsyncForceId = INDEX_NONE;
+
+	// What the update asked for since the subsystem last sent it to the physics thread
+	FParkourAsyncForces AsyncForces;
+
+	// The launches and impulses go to AsyncForces instead of the character. Predicted and replayed moves, and
+	// recordings, need them applied inside the step that made them, so they keep the game thread path.
+	bool UsesAsyncPhysicsForces() const;
+
+	// Predicates handed back by the subsystem for the current step.
+	FParkourAgentHotState BatchedPredicates;
+	bool bHasBatchedPredicates = false;
+
+	/* Deferred Events */
+	FParkourPendingEvents PendingEvents;
+
+	// A corrected move being replayed already raised its events the first time
+	bool IsReplayingMove() const;
+
+	void QueueEvent(EParkourEventFlags Event);
+	void QueueParkourChanged(EParkourMovement PrevMode, EParkourMovement NewMode);
+	void QueueMovementChanged(EMovementMode PrevMode, EMovementMode NewMode);
+	void QueueWallRunEnd(float ResetTime);
+
+	// Broadcasts and clears everything queued since the last flush
+	void FlushEvents();
+
+	void GatherHotState(FParkourAgentHotState& OutState) const;
+	void ApplyBatchedPredicates(const FParkourAgentHotState& State);
+
+	/* Prediction */
+	// Set when the character's movement component is a UParkourCharacterMovementComponent
+	UPROPERTY(Transient)
+		TObjectPtr<UParkourCharacterMovementComponent> ParkourCharacterMovement;
+
+	// True when the character's moves run the parkour update, so neither the tick nor the subsystem should.
+	bool IsUpdatedByMovement() const;
+
+	uint8 GetGateMask() const;
+	void SetGateMask(uint8 GateMask);
+
+	void GatherPredictedState(FParkourPredictedState& OutState) const;
+
+	// Client side, before a saved move is replayed. Only the move's inputs, the rest carries on from the correction
+	// and the moves replayed before it.
+	void RestorePredictedInputs(const FParkourPredictedState& State);
+
+	// Presses waiting for the next move, and set while that move runs them
+	EParkourPress PendingPresses = EParkourPress::None;
+	bool bRunningPresses = false;
+
+	// Holds Press for the next move when moves run the update. Returns false when the press should run now.
+	bool DeferPress(EParkourPress Press);
+
+	// Runs and clears the presses held for the move about to run, before its steps
+	void RunPendingPresses();
+
+	// Client side, takes on the server's state from a correction made SecondsAgo, without running the transition.
+	void ApplyServerPredictedState(const FParkourPredictedState& State, float SecondsAgo);
+
+	// Seconds a replayed move was first made before the present, 0 outside replays. Set before each replayed move.
+	void SetReplayTimeOffset(double Seconds) { ReplayTimeOffset = Seconds; }
+
+	/* Replication */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// True on a client for a character another machine moves. Its mode comes from the server through ReplicatedState
+	// and SimulateProxy moves it between updates, the parkour update doesn't run for it.
+	bool IsSimulatedProxy() const;
+
+	// Server, pushes the mode, wall and target to simulated proxies when they've changed. Called with the events at
+	// the end of every frame's update.
+	void UpdateReplicatedState();
+
+	// Simulated proxy, holds the character on the wall line, ledge or mantle the server sent and turns it to match,
+	// with the wall run's gravity, so the movement between updates extrapolates the way the server moves it
+	void SimulateProxy(float DeltaTime);
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Network")
+		int32 GetNumReplicatedStateChanges() const { return ReplicatedStateChanges; }
+
+	// Replicated state sent by the server or received by a proxy, per second since the component was initialized.
+	// Counts the state's own bits once per change; the server sends it once per simulated proxy's connection.
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Network")
+		double GetReplicatedStateBytesPerSecond() const;
+
+	// Times the component has gone from one parkour mode to the other
+	uint32 GetTransitionCount(EParkourMovement From, EParkourMovement To) const { return TransitionCounts[(uint8)From][(uint8)To]; }
+
+	/* Recorder */
+	// Streams every step's input, the Jump, CrouchSlide and Sprint calls and every transition to
+	// Saved/Profiling/ParkourRecordings, so a session can be played back later under the profiler.
+	UFUNCTION(BlueprintCallable, Category = "ParkourMovement | Recorder")
+		void StartRecording();
+
+	UFUNCTION(BlueprintCallable, Category = "ParkourMovement | Recorder")
+		void StopRecording();
+
+	// Puts the character back where the recording started, then feeds the recording's inputs back through Jump,
+	// CrouchSlide and Sprint, one recorded step per fixed step. Live calls to those are ignored until the recording ends.
+	UFUNCTION(BlueprintCallable, Category = "ParkourMovement | Recorder")
+		void StartPlayback(const FString& Path);
+
+	UFUNCTION(BlueprintCallable, Category = "ParkourMovement | Recorder")
+		void StopPlayback();
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Recorder")
+		bool IsRecording() const { return Recorder.IsRecording(); }
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Recorder")
+		bool IsPlayingBack() const { return Player.IsPlaying(); }
+
+	/* Modes */
+	// Parkour modes change through SetParkourMovementMode, movement modes through MovementChanged
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Parkour")
+		EParkourMovement GetPreviousParkourMode() const { return Runtime.GetPreviousMode(); }
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Parkour")
+		EParkourMovement GetCurrentParkourMode() const { return Runtime.GetCurrentMode(); }
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Parkour")
+		TEnumAsByte<EMovementMode> GetPreviousMovementMode() const { return Runtime.PreviousMovementMode; }
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement | Parkour")
+		TEnumAsByte<EMovementMode> GetCurrentMovementMode() const { return Runtime.CurrentMovementMode; }
+
+	/* Animation Snapshot */
+	// Safe to read from animation worker threads, unlike the getters above
+	const FParkourAnimSnapshotBuffer& GetAnimSnapshot() const { return AnimSnapshot; }
+
+	// Fills in and publishes this frame's snapshot. Called with the events at the end of every frame's update.
+	void PublishAnimSnapshot();
 
 	/* Main Events */
 	/* Character Defaults */
@@ -131,6 +655,8 @@ public:
 	UFUNCTION(BlueprintCallable)
 		void Jump();
 
+	// Plays Camera on the owning player's view. Does nothing for characters another machine or an AI controls,
+	// and never on a dedicated server.
 	UFUNCTION(BlueprintCallable)
 		void PlayCameraShake(TSubclassOf<UCameraShakeBase> Camera);
 
@@ -163,6 +689,11 @@ public:
 
 
 	/* Delegates */
+	// Raised immediately on every mode change, for C++ listeners that can't wait for the deferred Blueprint event.
+	FParkourModeChangedNativeDelegate OnParkourModeChangedNative;
+
+	// The Blueprint dispatchers below are notifications only. They are queued while the update runs and broadcast
+	// once by FlushEvents, at the end of the frame's update.
 	UPROPERTY(BlueprintAssignable, Category = "EventDispatcher")
 		FMovementChangedDelegate OnMovementChanged;
 
@@ -194,9 +725,6 @@ public:
 		FQueuesEventDelegate OnQueuesCheckEvent;
 
 protected:
-	/* C++ Specific Variables */
-	const TArray<AActor*> ActorsToIgnore;
-
 	/* Default Variables */
 	//Defaults
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Default Variables")
@@ -211,91 +739,35 @@ protected:
 		float DefaultBrakingDeceleration = 0.0f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Default Variables")
 		bool DefaultUseControllerRotationYaw = false;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Default Variables")
-		bool CameraShake = false;
 
-	/* Gates */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Gates")
-		bool IsWallrunGateOpen = false;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Gates")
-		bool IsSprintGateOpen = false;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Gates")
-		bool IsSlideGateOpen = false;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Gates")
-		bool IsVerticalWallrunGateOpen = false;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Gates")
-		bool IsMantleCheckGateOpen = false;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Gates")
-		bool IsMantleGateOpen = false;
-
-	/* Variables */
-	//Wall Run Variables
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		FVector WallRunNormal = FVector(0, 0, 0);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		float WallRunTargetGravity = 0.25f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		float WallRunStartSpeed = 10.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		float WallRunJumpHeight = 400.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		float WallRunJumpOffForce = 300.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		float WallRunSpeed = 850.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		float WallRunSprintSpeed = 1100.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		bool bIsWallRunGravity = false;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		float VerticalWallRunSpeed = 300.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		FVector VerticalWallRunNormal = FVector(0, 0, 0);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		FVector VerticalWallRunLocation = FVector(0, 0, 0);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		FVector WallRunLocation = FVector(0, 0, 0);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | WallRun")
-		float VerticalWallRunTime = 0.0f;
-
-	//LedgeGrab Variables
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		float LedgeGrabJumpOffForce = 300.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		float LedgeGrabJumpHeight = 400.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		FVector LedgeFloorPosition = FVector(0, 0, 0);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		bool LedgeCloseToGround = false;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		FVector LedgeClimbWallPosition = FVector(0, 0, 0);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		FVector LedgeClimbWallNormal = FVector(0, 0, 0);
-
-	//Mantle Variables
-	FVector MantlePosition = FVector(0, 0, 0);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		float MantleSpeed = 10.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		float MantleTraceDistance = 0.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		float QuickMantleSpeed = 20.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | LedgeGrab")
-		float MantleHeight = 44.0f;
-
-
-	//Slide Variables
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Slide")
-		FVector SlideVector = FVector(0, 0, 0);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Slide")
-		float SlideImpulseAmount = 600.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Slide")
-		bool SlideQueued = false;
-
-	//Sprint Variables
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Sprint")
-		float SprintSpeed = 1000.0f;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Sprint")
-		bool SprintQueued = false;
+	/* Runtime State */
+	FParkourRuntimeState Runtime;
+
+	/* Animation Snapshot */
+	FParkourAnimSnapshotBuffer AnimSnapshot;
+
+	/* Replication */
+	// Simulated proxies only, autonomous proxies predict their own. Push model, marked dirty by UpdateReplicatedState.
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedState)
+		FParkourReplicatedState ReplicatedState;
+
+	UFUNCTION()
+		void OnRep_ReplicatedState();
+
+	/* Camera */
+	UFUNCTION()
+		void OnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
+
+	// Takes on the mode, wall and target in ReplicatedState without running the transition, its side effects
+	// reach the proxy through the replicated movement
+	void ApplyReplicatedState();
+
+	int32 ReplicatedStateChanges = 0;
+	int64 ReplicatedStateBits = 0;
+	double ReplicationStartTime = 0.0;
+
+	// World time the current parkour mode was entered
+	double ModeEnterTime = 0.0;
 
 	//Legacy Camera Variables
 	//UParkourCameraShake JumpLandCamera;
@@ -304,16 +776,97 @@ protected:
 	//UParkourCameraShake LedgeGrabCamera;
 
 private:
+	/* Recorder */
+	FParkourRecorder Recorder;
+	FParkourRecordingPlayer Player;
+
+	// Set while playback is calling the input events, so live input can be told apart
+	bool bFeedingPlayback = false;
+
+	// The recorded input vector of the step being played back, used by ForwardInput
+	bool bHasPlaybackInput = false;
+	FVector PlaybackInput = FVector::ZeroVector;
+	FVector PlaybackLocation = FVector::ZeroVector;
+
+	// How far the playback has strayed from the recording, logged when it ends
+	uint32 PlaybackTransitions = 0;
+	uint32 RecordedTransitions = 0;
+	double MaxPlaybackDrift = 0.0;
+
+	bool IsIgnoringLiveInput() const { return Player.IsPlaying() && !bFeedingPlayback && !bRunningPresses; }
+	void RecordEvent(EParkourRecordedEvent Event);
+
+	// Replays recorded records up to and including the next step. Returns false at the end of the recording.
+	bool FeedPlayback();
+
+	// The character's transform, velocity and movement mode, and the parkour mode, gates, timers and queues
+	FParkourRecordingInitialState MakeRecordingInitialState() const;
+	void ApplyRecordingInitialState(const FParkourRecordingInitialState& State);
+
+	/* Scene Queries */
+	FParkourProbeSlot ProbeSlots[(uint8)EParkourProbe::Count];
+	FParkourProbeQuery ProbeQueries[(uint8)EParkourProbe::Count];
+
+	// Fills in ProbeQueries for the character, from Initialize. Each probe's params are tagged with its own
+	// scene query stat, so every trace is attributed in Insights.
+	void BuildProbeQueries();
+
+	// Traces the probe with its own channel and shape, capsules falling back to a line at low significance
+	bool TraceProbe(EParkourProbe Probe, const FVector& Start, const FVector& End, FHitResult& OutHit);
+	bool RunProbe(EParkourProbe Probe, const FVector& Start, const FVector& End, const FCollisionShape& Shape, FHitResult& OutHit, bool bAddToCache = true);
+	bool RunSyncProbe(EParkourProbe Probe, const FVector& Start, const FVector& End, const FCollisionShape& Shape, FHitResult& OutHit, bool bDynamicOnly = false);
+	bool RunAsyncProbe(EParkourProbe Probe, const FVector& Start, const FVector& End, const FCollisionShape& Shape, FHitResult& OutHit);
+
+	// Where the probes are placed from this step
+	FParkourProbeOrigin MakeProbeOrigin() const;
+
+	/* Timers */
+	// World time each timer is due at, for the timers whose bit is set in ArmedTimers. Checked by RunDueTimers
+	// at the end of every frame's update, so re-arming a cooldown never touches the world's timer manager.
+	double TimerDeadlines[(uint8)EParkourTimer::Count] = {};
+	uint8 ArmedTimers = 0;
+
+	// World time of the step being run. A replayed move arms its timers from when it was first made, not from now.
+	double GetStepWorldTime() const;
+	double ReplayTimeOffset = 0.0;
+
+	void ArmTimer(EParkourTimer Timer, float Delay);
+	void ClearTimer(EParkourTimer Timer);
+
+	// Runs every timer that has come due, earliest first
+	void RunDueTimers();
+
+	/* Root Motion */
+	// Snaps, wall corrections and the mantle are root motion sources on the CharacterMovementComponent, so they move
+	// through its sweeps and are saved and replayed with the character's moves. They are looked up by name, since a
+	// replayed move applies its source again under a new ID.
+
+	// Closes the gap to a wall along its normal, on top of the wall run's own velocity
+	void StartWallCorrection(const FVector& TargetLocation, const FVector& WallNormal, const FRotator& TargetRotation);
+
+	// Moves the character onto TargetLocation over Duration, overriding its velocity, and stops it there
+	void StartSnapMove(FName Name, const FVector& TargetLocation, float Duration);
+	void StartMantleMove();
+
+	// Set while a snap switches the movement mode so root motion can move a hanging character, and back again.
+	// MovementChanged ignores those switches, the character hasn't left the ledge.
+	bool bSnapChangingMovementMode = false;
+
+	void ApplyRootMotionMove(const TSharedPtr<FRootMotionSource>& Move);
+	bool IsRootMotionMoveActive(FName Name) const;
+	void StopRootMotionMoves();
+
+	// Only the yaw changes, which the capsule doesn't need a sweep for
+	void SnapRotation(const FRotator& TargetRotation);
+
 	/* Wall Run */
 	void WallRunUpdate();
+	void WallRunEnd(float ResetTime);
 
-	// Delegate
-	UFUNCTION()
-		void WallRunEnd(float ResetTime);
-
-	bool WallRunMovement(FVector Start, FVector End, float WallRunDirection);
+	bool WallRunMovement(float WallRunDirection);
 	void WallRunGravity();
 	void WallRunEnableGravity();
+	void WallRunExit();
 	void CorrectWallRunLocation();
 	FVector WallRunTargetVector();
 	FRotator WallRunTargetRotation();
@@ -332,10 +885,8 @@ private:
 	FRotator LedgeTargetRotation();
 
 	float MantleZOffset();
-	float CapsuleZOffset();
 
-	UFUNCTION()
-		void VerticalWallRunEndEvent();
+	void VerticalWallRunEndEvent();
 
 	/* Jump */
 	void WallRunJump();
@@ -346,11 +897,14 @@ private:
 
 	/* Ledge Grab */
 	void LedgeGrab();
+	void LedgeGrabEnter();
+	void LedgeGrabHang();
 
 	/* Sprint */
 	void SprintUpdate();
 	void SprintEnd();
 	void SprintStart();
+	void SprintEnter();
 
 	/* Crouch */
 	void CrouchStart();
@@ -370,12 +924,17 @@ private:
 
 	/* Camera */
 	void UpdateCameraProperties();
-	void CameraTilt(float TargetXRoll);
-	void CameraTick();
 
-	/* Events */
-	void EndEvents(); //End WallRun -> Verti WallRun -> Slide -> Sprint
-	void JumpEvent(); ////Jump WallRun -> LedgeGrab -> Slide -> Crouch -> Sprint (Needs to be changed to JumpSequence)
+	// Adds UParkourCameraModifier to the camera of the local player controlling the character, if there is one.
+	// The tilt and mantle look are applied there, to the view only.
+	void AddCameraModifier();
+
+	/* Transitions */
+	// Looks up the current mode's cell for Trigger and runs it if its guard passes. Returns false if nothing ran.
+	bool FireTrigger(EParkourTrigger Trigger);
+
+	// Mode changes made so far, by previous and new mode. Dumped by Parkour.DumpTransitions.
+	uint32 TransitionCounts[NumParkourModes][NumParkourModes] = {};
 
 	/* Gates */
 	void OpenGates(); //Open WallRun -> Verti WallRun -> Slide -> Sprint
@@ -413,28 +972,20 @@ private:
 	void CloseMantleGate();
 
 	/* Gate Sequences */
-
-	//Delegates
-	UFUNCTION()
 	void UpdateSequence();
 
-	/* Macros */
-	bool MacroCanWallRun();
-	bool MacroWallRunning();
-	bool MacroCanVerticalWallRun();
-	bool MacroValidWallRunVector(FVector);
-	FVector MacroOutValidWallRunVector = { 0, 0, 0 };
-	FVector MacroWallRunEndVectorsLeft();
-	FVector MacroWallRunEndVectorsRight();
+	/* Predicates */
+	bool CanWallRun();
+	bool IsWallRunning();
+	bool CanVerticalWallRun();
+	bool IsValidWallRunNormal(FVector);
 
-	float MacroForwardInput();
+	float ForwardInput();
 
-	FVector MacroMantleVectorsEyes();
-	FVector MacroMantleVectorsFeet();
-	bool MacroCanMantle();
-	bool MacroQuickMantle();
+	bool CanMantle();
+	bool IsQuickMantle();
 
-	bool MacroCanSlide();
+	bool CanSlide();
 
-	bool MacroCanSprint();
+	bool CanSprint();
 };
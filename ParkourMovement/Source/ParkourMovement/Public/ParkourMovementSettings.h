@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ParkourMovementSettings.generated.h"
+
+/* Significance */
+// How much a character's parkour update matters to the players watching it
+UENUM(BlueprintType)
+enum class EParkourSignificance : uint8 {
+	High = 0 UMETA(DisplayName = "High"),
+	Medium = 1 UMETA(DisplayName = "Medium"),
+	Low = 2 UMETA(DisplayName = "Low")
+};
+
+// What a character's update is allowed to spend while it sits in one significance bucket
+USTRUCT(BlueprintType)
+struct FParkourSignificanceBucket
+{
+	GENERATED_BODY()
+
+	// Characters further than this from every player's view drop to the next bucket. Not used by Low.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Significance", meta = (ClampMin = "0"))
+		float MaxDistance = 2000.0f;
+
+	// Fixed steps merged into each update, so the update runs this many times less often with a longer step
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Significance", meta = (ClampMin = "1", ClampMax = "8"))
+		int32 StepMultiplier = 1;
+
+	// Trace the ledge probes along their center line instead of sweeping a capsule
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Significance")
+		bool bLineTraceProbes = false;
+
+	// Camera tilt and camera shakes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ParkourMovement | Significance")
+		bool bCosmetics = true;
+};
+
+/**
+ * Tuning shared by every parkour component that references it. Set on the component's archetype, usually the
+ * character Blueprint, so thousands of agents read the same values instead of each carrying its own copy.
+ * A component without one uses the class defaults.
+ */
+UCLASS(BlueprintType)
+class PARKOURMOVEMENT_API UParkourMovementSettings : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UParkourMovementSettings();
+
+	/* Wall Run */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | WallRun")
+		float WallRunTargetGravity = 0.25f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | WallRun")
+		float WallRunStartSpeed = 10.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | WallRun")
+		float WallRunJumpHeight = 400.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | WallRun")
+		float WallRunJumpOffForce = 300.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | WallRun")
+		float WallRunSpeed = 850.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | WallRun")
+		float WallRunSprintSpeed = 1100.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | WallRun")
+		float VerticalWallRunSpeed = 300.0f;
+
+	// Seconds a vertical wall run lasts, 0 for no limit
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | WallRun", meta = (ClampMin = "0"))
+		float VerticalWallRunTime = 0.0f;
+
+	/* Ledge Grab */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | LedgeGrab")
+		float LedgeGrabJumpOffForce = 300.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | LedgeGrab")
+		float LedgeGrabJumpHeight = 400.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | LedgeGrab")
+		float MantleSpeed = 10.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | LedgeGrab")
+		float QuickMantleSpeed = 20.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | LedgeGrab")
+		float MantleHeight = 44.0f;
+
+	/* Slide */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Slide")
+		float SlideImpulseAmount = 600.0f;
+
+	/* Sprint */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Sprint")
+		float SprintSpeed = 1000.0f;
+
+	/* Camera */
+	// Applied by UParkourCameraModifier to the local player's own view only
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Camera")
+		bool bCameraShake = false;
+	// Off by default, the roll while wall running was never applied before the camera modifier
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Camera")
+		bool bCameraTilt = false;
+
+	// Degrees the view rolls away from the wall while wall running
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Camera")
+		float WallRunCameraRoll = 15.0f;
+
+	// How fast the roll, and the turn to look over a ledge while mantling, blend in and back out
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Camera", meta = (ClampMin = "0"))
+		float CameraTiltSpeed = 10.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Camera", meta = (ClampMin = "0"))
+		float MantleLookSpeed = 7.0f;
+
+	/* Network */
+	// How fast simulated proxies close in on the wall line or ledge the server sent, per second. Mantles close in
+	// at MantleSpeed, the same as the server's move.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Network", meta = (ClampMin = "0"))
+		float ProxyLocationSmoothing = 12.0f;
+
+	// How fast simulated proxies turn to face along or into the wall, per second
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Network", meta = (ClampMin = "0"))
+		float ProxyRotationSmoothing = 10.0f;
+
+	/* Significance */
+	// Tuning for each bucket. The local player's own character and characters whose moves are predicted
+	// are always High, everything else is scored by distance to the closest player view and dropped a
+	// bucket when it hasn't been rendered recently.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Significance")
+		FParkourSignificanceBucket HighSignificance;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Significance")
+		FParkourSignificanceBucket MediumSignificance;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Significance")
+		FParkourSignificanceBucket LowSignificance;
+
+	// Seconds between rescoring a character
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ParkourMovement | Significance", meta = (ClampMin = "0"))
+		float SignificanceInterval = 0.25f;
+};
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ParkourMovementComponent.h"
+#include "ParkourProbeCache.h"
+#include "ParkourAsyncForces.h"
+#include "ParkourSurfaceDatabase.h"
+#include "ParkourMovementWorldSubsystem.generated.h"
+
+/**
+ * Owns every batched UParkourMovementComponent in a world and updates them together, one phase at a time:
+ * gather the per agent inputs on the game thread, evaluate the movement predicates wide with ParallelFor,
+ * then run each agent's gates, which issue the scene queries, resolve transitions and apply them to the
+ * CharacterMovementComponent. Each agent's queued Blueprint events are flushed once all of that is done.
+ * Only the predicate phase is parallel, every other phase runs on the game thread.
+ *
+ * It also owns the world's probe cache and baked surface database, shared by every parkour component whether
+ * it is batched or not.
+ */
+UCLASS()
+class PARKOURMOVEMENT_API UParkourMovementWorldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/* Subsystem */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/* Tickable */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Registry */
+	void RegisterComponent(UParkourMovementComponent* Component);
+	void UnregisterComponent(UParkourMovementComponent* Component);
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement")
+		int32 GetNumAgents() const { return Agents.Num(); }
+
+	/* Probe Cache */
+	FParkourProbeCache& GetProbeCache() { return ProbeCache; }
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement")
+		float GetProbeCacheHitRate() const { return ProbeCache.GetHitRate(); }
+
+	UFUNCTION(BlueprintPure, Category = "ParkourMovement")
+		int64 GetProbeCacheEvictions() const { return (int64)ProbeCache.GetTotalEvictions(); }
+
+	/* Async Physics Forces */
+	// Components with bUseAsyncPhysicsForces. Their forces are sent to the physics thread at the end of every tick and
+	// the velocity changes it made are applied to their characters once, before their next move.
+	void RegisterAsyncForces(UParkourMovementComponent* Component);
+	void UnregisterAsyncForces(UParkourMovementComponent* Component);
+
+	/* Significance */
+	// Where every player controller in the world is viewing from, gathered at the start of each batched update.
+	// Components that tick on their own score against the previous frame's.
+	const TArray<FVector>& GetViewpoints() const { return Viewpoints; }
+
+	/* Surface Database */
+	// Baked static surfaces for this level, not loaded if the level was never baked
+	const FParkourSurfaceDatabase& GetSurfaceDatabase() const { return SurfaceDatabase; }
+
+	// How often idle and invalid probe cache entries are swept out
+	float ProbeCacheSweepInterval = 1.0f;
+
+	// Below this many agents the predicate phase runs on the game thread, where a task dispatch would cost more than the work.
+	int32 MinAgentsForParallelPredicates = 64;
+
+private:
+	/* Phases */
+	void GatherPhase(int32 Step);
+	void PredicatePhase(int32 Step);
+	void UpdatePhase(int32 Step);
+	void EventPhase();
+
+	void GatherViewpoints();
+	TArray<FVector> Viewpoints;
+
+	// Registered components, kept parallel to HotStates and StepCounts so every phase walks contiguous memory.
+	UPROPERTY(Transient)
+		TArray<TObjectPtr<UParkourMovementComponent>> Agents;
+
+	TArray<FParkourAgentHotState> HotStates;
+
+	// Fixed steps each agent takes this frame, from its own accumulator.
+	TArray<int32> StepCounts;
+
+	FParkourProbeCache ProbeCache;
+	FParkourSurfaceDatabase SurfaceDatabase;
+	double LastProbeCacheSweepTime = 0.0;
+
+	// Registry changes made while the phases are running are applied once the frame's update is done.
+	bool bIsUpdating = false;
+	TArray<TWeakObjectPtr<UParkourMovementComponent>> PendingRegistrations;
+
+	// Created with the first async force registration, on the world's physics solver
+	FParkourAsyncForceCallback* AsyncForceCallback = nullptr;
+
+	// Indexed by AsyncForceId, slots of unregistered components are reused
+	TArray<TWeakObjectPtr<UParkourMovementComponent>> AsyncForceAgents;
+	uint32 AsyncForceSequence = 0;
+
+	void ApplyAsyncForceOutputs();
+	void PushAsyncForceInputs();
+	void DestroyAsyncForceCallback();
+
+	void AddAgent(UParkourMovementComponent* Component);
+	void RemoveAgent(int32 Index);
+	void FlushPendingRegistry();
+};
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavAreas/NavArea.h"
+#include "Navigation/NavLinkProxy.h"
+#include "ParkourNavLinks.generated.h"
+
+class UParkourMovementSettings;
+
+/* Traversals */
+// The parkour move an AI has to make to follow a generated link
+UENUM(BlueprintType)
+enum class EParkourTraversal : uint8 {
+	WallRun = 0 UMETA(DisplayName = "WallRun"),		// Jump onto a side wall, run along it and drop off the end
+	Climb = 1 UMETA(DisplayName = "Climb"),			// Vertical wall run up to a ledge, grab it and mantle
+	Mantle = 2 UMETA(DisplayName = "Mantle")		// Quick mantle onto a ledge within reach from the ground
+};
+
+// One generated link, in world space. Start is on the ground the move begins from, End where it lands.
+USTRUCT()
+struct PARKOURMOVEMENT_API FParkourNavLink
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "ParkourMovement")
+		EParkourTraversal Traversal = EParkourTraversal::Mantle;
+
+	UPROPERTY(VisibleAnywhere, Category = "ParkourMovement")
+		FVector Start = FVector::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, Category = "ParkourMovement")
+		FVector End = FVector::ZeroVector;
+};
+
+/* Nav Areas */
+// Area of a parkour link. The path cost of a link is its length times the area's DefaultCost, so Blueprint
+// subclasses can retune how much the planner avoids each kind of move.
+UCLASS(Abstract)
+class PARKOURMOVEMENT_API UParkourNavArea : public UNavArea
+{
+	GENERATED_BODY()
+
+public:
+	EParkourTraversal GetTraversal() const { return Traversal; }
+
+	// The traversal a path segment through AreaClass needs, false for areas that aren't parkour links
+	static bool GetTraversal(TSubclassOf<UNavAreaBase> AreaClass, EParkourTraversal& OutTraversal);
+
+	static TSubclassOf<UParkourNavArea> GetAreaClass(EParkourTraversal Traversal);
+
+protected:
+	EParkourTraversal Traversal = EParkourTraversal::Mantle;
+};
+
+UCLASS()
+class PARKOURMOVEMENT_API UParkourNavArea_WallRun : public UParkourNavArea
+{
+	GENERATED_BODY()
+
+public:
+	UParkourNavArea_WallRun();
+};
+
+UCLASS()
+class PARKOURMOVEMENT_API UParkourNavArea_Climb : public UParkourNavArea
+{
+	GENERATED_BODY()
+
+public:
+	UParkourNavArea_Climb();
+};
+
+UCLASS()
+class PARKOURMOVEMENT_API UParkourNavArea_Mantle : public UParkourNavArea
+{
+	GENERATED_BODY()
+
+public:
+	UParkourNavArea_Mantle();
+};
+
+/**
+ * Holds every parkour link generated for a level, one per level. Filled in by the ParkourNavLinkBake commandlet
+ * and kept up to date in the editor as static geometry is edited, see UParkourNavLinkEditorSubsystem.
+ *
+ * Each link is a one way point link in the area of its traversal, so the path planner decides where a wall run,
+ * climb or mantle is worth it and the AI's parkour component only has to make the move.
+ */
+UCLASS()
+class PARKOURMOVEMENT_API AParkourNavLinkProxy : public ANavLinkProxy
+{
+	GENERATED_BODY()
+
+public:
+	AParkourNavLinkProxy(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	const TArray<FParkourNavLink>& GetParkourLinks() const { return ParkourLinks; }
+
+	// Drops the links starting inside Box and adds NewLinks in their place, then updates the navigation
+	void ReplaceLinks(const FBox& Box, const TArray<FParkourNavLink>& NewLinks);
+
+	void SetLinks(const TArray<FParkourNavLink>& NewLinks);
+
+	const UParkourMovementSettings& GetMovementSettings() const;
+
+	// Tuning the links are generated for, the class defaults if unset. Should match the level's parkour characters.
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement")
+		TObjectPtr<UParkourMovementSettings> MovementSettings;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+	virtual void PostLoad() override;
+
+	// Rebuilds the point links the navigation gathers from ParkourLinks
+	void RebuildPointLinks();
+
+	UPROPERTY(VisibleAnywhere, Category = "ParkourMovement")
+		TArray<FParkourNavLink> ParkourLinks;
+};
@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParkourMovementComponent.h"
+
+/* Probe Cache Key */
+// A probe is identified by its type, the cell its start falls in, and its quantized direction and length, along with
+// everything that decides what the trace can hit: its channel, its shape and the class of the actor it ignores.
+struct FParkourProbeCacheKey
+{
+	FIntVector Cell = FIntVector::ZeroValue;
+	uint8 Probe = 0;
+	uint8 Yaw = 0;
+	uint8 Pitch = 0;
+	uint16 Length = 0;
+
+	uint8 Channel = 0;
+	uint8 ShapeType = 0;
+	FIntVector ShapeExtent = FIntVector::ZeroValue;
+	const UClass* IgnoredClass = nullptr;
+
+	bool operator==(const FParkourProbeCacheKey& Other) const
+	{
+		return (Cell == Other.Cell) && (Probe == Other.Probe) && (Yaw == Other.Yaw) && (Pitch == Other.Pitch) && (Length == Other.Length)
+			&& (Channel == Other.Channel) && (ShapeType == Other.ShapeType) && (ShapeExtent == Other.ShapeExtent) && (IgnoredClass == Other.IgnoredClass);
+	}
+
+	friend uint32 GetTypeHash(const FParkourProbeCacheKey& Key)
+	{
+		const uint32 Packed = ((uint32)Key.Probe << 24) | ((uint32)Key.Yaw << 16) | ((uint32)Key.Pitch << 8) | (uint32)(Key.Length & 0xFF);
+		const uint32 Query = ((uint32)Key.Channel << 8) | (uint32)Key.ShapeType;
+		return HashCombine(HashCombine(GetTypeHash(Key.Cell), Packed), HashCombine(HashCombine(GetTypeHash(Key.ShapeExtent), Query), PointerHash(Key.IgnoredClass)));
+	}
+};
+
+/* Probe Cache Entry */
+struct FParkourProbeCacheEntry
+{
+	// The hit as it was traced, and where that trace started
+	FHitResult Hit;
+	FVector Start = FVector::ZeroVector;
+	bool bBlockingHit = false;
+
+	// Misses are only trusted on the frame they were traced
+	uint64 CachedFrame = 0;
+
+	double LastUsedTime = 0.0;
+};
+
+/**
+ * Per world cache of parkour probe results, owned by UParkourMovementWorldSubsystem.
+ *
+ * Hits are re-projected onto the cached surface from the new start, so a wall or ledge only needs to be traced
+ * once per cell. Only hits on static and stationary components are cached, and they are thrown away as soon as their
+ * component is destroyed, unregistered or stops colliding. A miss can't be verified that way, anything may have moved
+ * into its path since, so it only answers other probes made on the same frame.
+ */
+class PARKOURMOVEMENT_API FParkourProbeCache
+{
+public:
+	/* Tuning */
+	// Size of the cells probe starts are snapped to
+	float CellSize = 10.0f;
+
+	// Entries nobody has read for this long are swept out
+	double IdleLifetime = 10.0;
+
+	int32 MaxEntries = 65536;
+
+	/* Cache */
+	// The query supplies the channel and ignored actor, Shape is the one actually traced
+	bool Find(EParkourProbe Probe, const FParkourProbeQuery& Query, const FCollisionShape& Shape, const FVector& Start, const FVector& End, double Now, FHitResult& OutHit, bool& bOutBlockingHit);
+	void Add(EParkourProbe Probe, const FParkourProbeQuery& Query, const FCollisionShape& Shape, const FVector& Start, const FVector& End, double Now, const FHitResult& Hit, bool bBlockingHit);
+
+	// Evicts idle, expired and invalid entries
+	void Sweep(double Now);
+	void Empty();
+
+	/* Counters */
+	uint32 GetNumEntries() const { return Entries.Num(); }
+	uint64 GetTotalHits() const { return TotalHits; }
+	uint64 GetTotalMisses() const { return TotalMisses; }
+	uint64 GetTotalEvictions() const { return TotalEvictions; }
+	float GetHitRate() const;
+
+	// Lookups answered from the cache over all lookups, for one probe type
+	float GetHitRate(EParkourProbe Probe) const;
+	uint64 GetTotalLookups(EParkourProbe Probe) const { return ProbeLookups[(uint8)Probe]; }
+
+	// Counters since the last call, for per frame stats
+	void ConsumeFrameCounters(uint32& OutHits, uint32& OutMisses, uint32& OutEvictions);
+
+private:
+	FParkourProbeCacheKey MakeKey(EParkourProbe Probe, const FParkourProbeQuery& Query, const FCollisionShape& Shape, const FVector& Start, const FVector& End) const;
+	bool IsEntryValid(const FParkourProbeCacheEntry& Entry) const;
+
+	// Counts a lookup that had to go to a real trace
+	void CountMiss(EParkourProbe Probe);
+
+	TMap<FParkourProbeCacheKey, FParkourProbeCacheEntry> Entries;
+
+	uint64 TotalHits = 0;
+	uint64 TotalMisses = 0;
+	uint64 TotalEvictions = 0;
+
+	uint32 FrameHits = 0;
+	uint32 FrameMisses = 0;
+	uint32 FrameEvictions = 0;
+
+	uint64 ProbeHits[(uint8)EParkourProbe::Count] = {};
+	uint64 ProbeLookups[(uint8)EParkourProbe::Count] = {};
+};
@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformFileManager.h"
+#include "Tasks/Pipe.h"
+#include <atomic>
+
+/* File Layout */
+// A header and the state the recording starts from, followed by a stream of records. Positions and velocities are
+// quantized to whole units and stored as zigzag varint deltas from the previous record that carried them, so a step
+// that barely moves costs a few bytes.
+// Bump ParkourRecordingVersion whenever the header or the record encoding changes; older files are rejected on load.
+static constexpr uint32 ParkourRecordingMagic = 0x43524B50; // 'PKRC'
+static constexpr uint32 ParkourRecordingVersion = 2;
+
+struct FParkourRecordingHeader
+{
+	uint32 Magic = ParkourRecordingMagic;
+	uint32 Version = ParkourRecordingVersion;
+	float FixedTimeStep = 0.0f;
+	uint32 Padding = 0;
+};
+
+// The character and component as the recording started, applied before the first recorded step is played back.
+// Written as is, so the fields are laid out without implicit padding.
+struct FParkourRecordingInitialState
+{
+	static constexpr int32 MaxTimers = 8;
+
+	FQuat Rotation = FQuat::Identity;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+
+	// Seconds left on each armed timer, and the part of a fixed step already accumulated
+	float TimerRemaining[MaxTimers] = {};
+	float UpdateAccumulator = 0.0f;
+
+	uint8 Mode = 0;
+	uint8 GateMask = 0;
+	uint8 ArmedTimers = 0;
+	uint8 bSlideQueued = 0;
+	uint8 bSprintQueued = 0;
+	uint8 MovementMode = 0;
+	uint8 Padding[6] = {};
+};
+
+static_assert(sizeof(FParkourRecordingInitialState) == 128, "The initial state is written as is, keep it free of padding");
+
+enum class EParkourRecordType : uint8 {
+	Step,		// One fixed update: input vector, then position and velocity after the update
+	Event,		// Jump, CrouchSlide or Sprint called before the next step
+	Transition	// A parkour mode change, with where it happened
+};
+
+enum class EParkourRecordedEvent : uint8 {
+	Jump,
+	CrouchSlide,
+	Sprint
+};
+
+// One decoded record. Only the fields its type carries are set.
+struct FParkourRecord
+{
+	EParkourRecordType Type = EParkourRecordType::Step;
+	EParkourRecordedEvent Event = EParkourRecordedEvent::Jump;
+	uint8 FromMode = 0;
+	uint8 ToMode = 0;
+	FVector Input = FVector::ZeroVector;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+};
+
+// Quantized state the next record's deltas are taken from
+struct FParkourRecordBaseline
+{
+	FIntVector Location = FIntVector::ZeroValue;
+	FIntVector Velocity = FIntVector::ZeroValue;
+};
+
+/**
+ * Streams one parkour component's inputs and transitions to disk.
+ *
+ * Records are encoded on the game thread into a fixed size ring buffer, and a background pipe writes filled
+ * spans out in order. The game thread never waits on the file: a record that doesn't fit in the ring is
+ * dropped and counted, and the next one is encoded against the last record that made it in.
+ */
+class PARKOURMOVEMENT_API FParkourRecorder
+{
+public:
+	FParkourRecorder();
+	~FParkourRecorder();
+
+	static FString MakeRecordingPath(const FString& OwnerName);
+
+	bool Start(const FString& Path, float FixedTimeStep, const FParkourRecordingInitialState& InitialState);
+	// Waits for what has been written so far to reach the file
+	void Stop();
+	bool IsRecording() const { return FileHandle.IsValid(); }
+
+	/* Records */
+	void RecordStep(const FVector& Input, const FVector& Location, const FVector& Velocity);
+	void RecordEvent(EParkourRecordedEvent Event);
+	void RecordTransition(uint8 FromMode, uint8 ToMode, const FVector& Location, const FVector& Velocity);
+
+	/* Counters */
+	uint64 GetNumRecords() const { return NumRecords; }
+	uint64 GetNumDroppedRecords() const { return NumDroppedRecords; }
+	const FString& GetPath() const { return Path; }
+	SIZE_T GetAllocatedSize() const { return Ring.GetAllocatedSize() + Path.GetAllocatedSize(); }
+
+	// Bytes the ring holds, a power of two
+	static constexpr uint32 RingSize = 64 * 1024;
+
+	// Filled bytes handed to the writer at a time
+	static constexpr uint32 FlushSize = 8 * 1024;
+
+private:
+	bool Push(const uint8* Bytes, int32 NumBytes);
+	void Flush();
+
+	TUniquePtr<IFileHandle> FileHandle;
+	FString Path;
+
+	TArray<uint8> Ring;
+
+	// Positions in the stream, never wrapped. The game thread owns WriteCursor and FlushCursor, the writer ReadCursor.
+	uint64 WriteCursor = 0;
+	uint64 FlushCursor = 0;
+	std::atomic<uint64> ReadCursor { 0 };
+
+	UE::Tasks::FPipe WritePipe;
+
+	FParkourRecordBaseline Baseline;
+	uint64 NumRecords = 0;
+	uint64 NumDroppedRecords = 0;
+};
+
+/**
+ * Reads a recording back one record at a time. The file stays open while it plays and is read a buffer at a time,
+ * so a long session costs no more memory than a short one.
+ */
+class PARKOURMOVEMENT_API FParkourRecordingPlayer
+{
+public:
+	bool Load(const FString& Path);
+	void Unload();
+	bool IsPlaying() const { return FileHandle.IsValid(); }
+
+	// Decodes the next record, false at the end of the stream
+	bool Read(FParkourRecord& OutRecord);
+
+	float GetFixedTimeStep() const { return FixedTimeStep; }
+	const FParkourRecordingInitialState& GetInitialState() const { return InitialState; }
+	SIZE_T GetAllocatedSize() const { return Buffer.GetAllocatedSize(); }
+
+	// Bytes read from the file at a time
+	static constexpr int32 BufferSize = 16 * 1024;
+
+	// No record is longer, the buffer is topped up whenever less than this is left in it
+	static constexpr int32 MaxRecordSize = 64;
+
+private:
+	// Moves what's left of the buffer to its front and fills the rest from the file
+	void Refill();
+
+	TUniquePtr<IFileHandle> FileHandle;
+	TArray<uint8> Buffer;
+	int32 Offset = 0;
+	float FixedTimeStep = 0.0f;
+	FParkourRecordingInitialState InitialState;
+
+	FParkourRecordBaseline Baseline;
+};
@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "ParkourCoreTypes.h"
+#include "ParkourRules.h"
+#include "ParkourReplication.generated.h"
+
+/* Quantization */
+// Bits per axis of an octahedral encoded wall normal, the whole normal takes twice this. Worst case error is about a degree.
+static constexpr int32 ParkourNormalBits = 8;
+
+// How far a wall run's target may slide off the wall's plane, in units, before simulated proxies are told about it.
+// Along the plane it slides every step, and the proxies don't need to know.
+static constexpr float ParkourPlaneTolerance = 2.0f;
+
+/* Replicated State */
+// What simulated proxies are told about a character's parkour, pushed only when it changes. The wall run's side
+// rides in the mode. The wall normal and target are only sent for the modes that use them:
+//     Wall runs and vertical wall run - the wall, and a point on the line the capsule is held on
+//     Ledge grab - the wall, and where the capsule hangs
+//     Mantle - the wall, and where the capsule ends up standing on the ledge
+USTRUCT()
+struct PARKOURMOVEMENT_API FParkourReplicatedState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		EParkourMovement Mode = EParkourMovement::None;
+
+	UPROPERTY()
+		FVector WallNormal = FVector::ZeroVector;
+
+	UPROPERTY()
+		FVector_NetQuantize Target = FVector::ZeroVector;
+
+	// Every mode but the ground ones sends a wall and a target
+	bool HasWall() const { return ParkourRules::IsWallRunning(Mode) || ParkourRules::IsOnWall(Mode); }
+
+	// Rounds the normal and target to what NetSerialize sends, so a state compares equal to the one a proxy receives
+	// and only a change the proxies can see marks it dirty
+	void Quantize();
+
+	// Bits NetSerialize writes for this state, without the property's own header
+	int32 CountBits() const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FParkourReplicatedState& Other) const
+	{
+		return (Mode == Other.Mode) && (WallNormal == Other.WallNormal) && (Target == Other.Target);
+	}
+
+	bool operator!=(const FParkourReplicatedState& Other) const { return !(*this == Other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FParkourReplicatedState> : public TStructOpsTypeTraitsBase2<FParkourReplicatedState>
+{
+	enum {
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
+namespace ParkourQuantize
+{
+	// Octahedral encoding, the unit sphere folded onto a square, ParkourNormalBits for each side of it
+	PARKOURMOVEMENT_API uint16 EncodeNormal(const FVector& Normal);
+	PARKOURMOVEMENT_API FVector DecodeNormal(uint16 Packed);
+}
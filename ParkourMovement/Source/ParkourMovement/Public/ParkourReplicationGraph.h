@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "ParkourCoreTypes.h"
+#include "ParkourReplicationGraph.generated.h"
+
+class UNetConnection;
+class UParkourMovementComponent;
+
+/* Tuning */
+// How often a character in one parkour mode replicates to a connection, by distance to the closest of its viewers
+USTRUCT(BlueprintType)
+struct FParkourModeReplication
+{
+	GENERATED_BODY()
+
+	// Inside this the character is in the Near bucket, outside it the Far bucket
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement | Replication", meta = (ClampMin = "0"))
+		float NearDistance = 3000.0f;
+
+	// Replication frames between updates in each bucket, 1 for every frame
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement | Replication", meta = (ClampMin = "1"))
+		int32 NearPeriod = 2;
+
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement | Replication", meta = (ClampMin = "1"))
+		int32 FarPeriod = 10;
+
+	// Not relevant at all past this, the connection's channel closes once the graph's relevancy timeout runs out.
+	// 0 to never cull.
+	UPROPERTY(EditAnywhere, Category = "ParkourMovement | Replication", meta = (ClampMin = "0"))
+		float CullDistance = 15000.0f;
+};
+
+enum class EParkourReplicationBucket : uint8 {
+	Near,
+	Far,
+	Culled,
+	Count
+};
+
+/* Graph Node */
+/**
+ * Holds every character with a UParkourMovementComponent and, for each connection, sets how often each one replicates
+ * from its current parkour mode and its distance to the connection's viewers. Wall running, mantling and sliding
+ * characters close by replicate every frame, idle ones far away every few frames or not at all. A viewer's own view
+ * target always replicates every frame.
+ *
+ * The rate is set as the character's per connection ReplicationPeriodFrame, so the graph staggers the updates itself.
+ * Replications per frame in each bucket are counted in 'stat ParkourMovement'.
+ */
+UCLASS()
+class PARKOURMOVEMENT_API UParkourReplicationGraphNode : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UParkourReplicationGraphNode();
+
+	// Tuning for each parkour mode, set by the graph that creates the node
+	FParkourModeReplication ModeReplication[NumParkourModes];
+
+	/* Replication Graph Node */
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+private:
+	struct FParkourCharacterEntry
+	{
+		AActor* Actor = nullptr;
+		const UParkourMovementComponent* Parkour = nullptr;
+	};
+
+	TArray<FParkourCharacterEntry> Characters;
+
+	// Rebuilt for each connection, the graph replicates a connection's lists before it gathers for the next one
+	FActorRepListRefView GatheredActors;
+};
+
+/* Sample Graph */
+/**
+ * Replication graph for parkour games. Parkour characters go through UParkourReplicationGraphNode, always relevant
+ * actors through a shared list, everything else through a 2D spatial grid, and every connection gets its own always
+ * relevant node for its player controller and view target. Other owner only actors go to a list on their owning
+ * connection, picked by the owner they have when they start replicating.
+ *
+ * Enabled by ReplicationDriverClassName in DefaultEngine.ini. The per mode tuning can be overridden in the
+ * [/Script/ParkourMovement.ParkourReplicationGraph] section there.
+ */
+UCLASS(Transient, config = Engine)
+class PARKOURMOVEMENT_API UParkourReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UParkourReplicationGraph();
+
+	UPROPERTY(Config, EditAnywhere, Category = "ParkourMovement | Replication")
+		TMap<EParkourMovement, FParkourModeReplication> ModeReplication;
+
+	// Side of a spatial grid cell, and how far the grid extends below zero on each axis
+	UPROPERTY(Config, EditAnywhere, Category = "ParkourMovement | Replication")
+		float GridCellSize = 10000.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "ParkourMovement | Replication")
+		FVector2D GridSpatialBias = FVector2D(-150000.0f, -200000.0f);
+
+	/* Replication Graph */
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* ConnectionManager) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+
+private:
+	UPROPERTY()
+		TObjectPtr<UParkourReplicationGraphNode> ParkourNode;
+
+	UPROPERTY()
+		TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+
+	UPROPERTY()
+		TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+	// Each client connection's owner only actors, other than its player controller
+	UPROPERTY()
+		TMap<TObjectPtr<UNetConnection>, TObjectPtr<UReplicationGraphNode_ActorList>> OwnerNodes;
+
+	// True for characters the parkour node handles
+	static bool IsParkourCharacter(const AActor* Actor);
+
+	// The client connection Actor replicates to, the parent connection for split screen players
+	static UNetConnection* FindOwnerConnection(const AActor* Actor);
+
+	void AddOwnerOnlyActor(const FNewReplicatedActorInfo& ActorInfo);
+	void RemoveOwnerOnlyActor(const FNewReplicatedActorInfo& ActorInfo);
+};
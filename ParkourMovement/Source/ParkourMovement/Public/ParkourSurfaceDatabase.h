@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParkourMovementComponent.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/* File Layout */
+// Everything in the file is plain data so it can be used straight out of the mapped region.
+// Bump ParkourSurfaceVersion whenever any of these structs change; older files are rejected on load.
+static constexpr uint32 ParkourSurfaceMagic = 0x444B5050; // 'PPKD'
+static constexpr uint32 ParkourSurfaceVersion = 2;
+
+enum class EParkourSurfaceFlags : uint8 {
+	None = 0,
+	WallRunnable = 1 << 0,	// |Normal.Z| < 0.52, ParkourRules::IsValidWallRunNormal
+	Climbable = 1 << 1,		// Normal.Z >= -0.1, the ForwardTracer rule
+	Ledge = 1 << 2			// Found by the mantle capsule trace, something to stand on at the top of a climb
+};
+ENUM_CLASS_FLAGS(EParkourSurfaceFlags);
+
+struct FParkourSurfaceFileHeader
+{
+	uint32 Magic = ParkourSurfaceMagic;
+	uint32 Version = ParkourSurfaceVersion;
+	float CellSize = 50.0f;
+	uint32 NumCells = 0;
+	uint32 NumPatches = 0;
+	uint32 Padding = 0;
+	FVector3f BoundsMin = FVector3f::ZeroVector;
+	FVector3f BoundsMax = FVector3f::ZeroVector;
+	uint64 CellsOffset = 0;
+	uint64 PatchesOffset = 0;
+};
+
+// One cell of the bake grid. Cells are sorted by Key, so a lookup is a binary search and a column of cells along Z is
+// one run of keys.
+struct FParkourSurfaceCell
+{
+	uint64 Key = 0;
+	uint32 FirstPatch = 0;
+	uint32 NumPatches = 0;
+};
+
+// A flat piece of static collision one of the parkour probes reached, stored in the cell its Point is in.
+struct FParkourSurfacePatch
+{
+	FVector3f Point = FVector3f::ZeroVector;
+	FVector3f Normal = FVector3f::ZeroVector;
+	uint8 Flags = 0;
+	uint8 Padding[3] = { 0, 0, 0 };
+};
+
+static_assert(sizeof(FParkourSurfaceCell) == 16, "FParkourSurfaceCell is part of the baked file layout");
+static_assert(sizeof(FParkourSurfacePatch) == 28, "FParkourSurfacePatch is part of the baked file layout");
+
+/**
+ * Read only view over a baked parkour surface file for one level.
+ *
+ * The file is memory mapped where the platform allows it, so only the pages a lookup touches become resident.
+ * Lookups answer wall run and ledge probes against static geometry; movable geometry still needs a live trace.
+ */
+class PARKOURMOVEMENT_API FParkourSurfaceDatabase
+{
+public:
+	FParkourSurfaceDatabase();
+	~FParkourSurfaceDatabase();
+
+	/* Loading */
+	static FString GetDatabasePath(const FString& MapName);
+
+	bool Load(const FString& Path);
+	void Unload();
+	bool IsLoaded() const { return Header != nullptr; }
+
+	/* Lookups */
+	static uint64 MakeCellKey(const FIntVector& Cell);
+	static FIntVector GetCell(const FVector& Location, double CellSize);
+	FIntVector GetCell(const FVector& Location) const;
+
+	// True if the segment from Start to End is inside the baked bounds, where an empty cell really means there's no
+	// static surface.
+	bool Contains(const FVector& Start, const FVector& End) const;
+
+	// Does the probe handle it, and with which kind of surface
+	static bool GetProbeFlags(EParkourProbe Probe, EParkourSurfaceFlags& OutFlags);
+
+	// Sweeps a sphere of Radius (zero for a line) from Start to End against the patches of every cell the sweep could
+	// touch one of, the cells around the swept segment.
+	bool Sweep(const FVector& Start, const FVector& End, float Radius, EParkourSurfaceFlags RequiredFlags, FHitResult& OutHit) const;
+
+	// How far from its Point a patch is trusted
+	double GetPatchExtent() const { return Header ? (Header->CellSize * 1.5) : 0.0; }
+
+	/* Reporting */
+	int64 GetResidentBytes() const { return DataSize; }
+	double GetLoadTimeMs() const { return LoadTimeMs; }
+	double GetBytesPerSquareKm() const;
+
+private:
+	// The first cell whose key isn't less than Key, NumCells if there is none
+	int32 LowerBound(uint64 Key) const;
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// Used when the file can't be mapped, e.g. from inside a pak
+	TArray64<uint8> LoadedData;
+
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+	double LoadTimeMs = 0.0;
+
+	const FParkourSurfaceFileHeader* Header = nullptr;
+	const FParkourSurfaceCell* Cells = nullptr;
+	const FParkourSurfacePatch* Patches = nullptr;
+};
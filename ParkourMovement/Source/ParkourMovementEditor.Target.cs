@@ -10,6 +10,10 @@ public class ParkourMovementEditorTarget : TargetRules
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_1;
+
+		// UParkourMovementComponent replicates its state through the push model
+		bWithPushModel = true;
 		ExtraModuleNames.Add("ParkourMovement");
+		ExtraModuleNames.Add("ParkourMovementEditor");
 	}
 }
@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class ParkourMovementEditor : ModuleRules
+{
+	public ParkourMovementEditor(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "ParkourMovement" });
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "UnrealEd", "EditorSubsystem" });
+	}
+}
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourNavLinkBakeCommandlet.h"
+#include "ParkourNavLinkGenerator.h"
+#include "ParkourMovementSettings.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+UParkourNavLinkBakeCommandlet::UParkourNavLinkBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParkourNavLinkBakeCommandlet::Main(const FString& Params)
+{
+	FString MapPath;
+	if (!FParse::Value(*Params, TEXT("Map="), MapPath)) {
+		UE_LOG(LogTemp, Error, TEXT("Parkour Nav Link Bake: Missing -Map=/Game/Path/To/Map."));
+		return 1;
+	}
+
+	UParkourMovementSettings* MovementSettings = nullptr;
+	FString SettingsPath;
+	if (FParse::Value(*Params, TEXT("Settings="), SettingsPath)) {
+		MovementSettings = LoadObject<UParkourMovementSettings>(nullptr, *SettingsPath);
+		if (!MovementSettings) {
+			UE_LOG(LogTemp, Error, TEXT("Parkour Nav Link Bake: Could not load settings %s."), *SettingsPath);
+			return 1;
+		}
+	}
+
+	UWorld* World = FParkourSurfaceScanner::LoadWorld(MapPath);
+	if (!World) {
+		UE_LOG(LogTemp, Error, TEXT("Parkour Nav Link Bake: Could not load %s."), *MapPath);
+		return 1;
+	}
+
+	// One proxy per level, kept in the persistent level so it's saved with the map
+	AParkourNavLinkProxy* Proxy = nullptr;
+	for (TActorIterator<AParkourNavLinkProxy> It(World); It; ++It) {
+		if (It->GetLevel() == World->PersistentLevel) {
+			Proxy = *It;
+			break;
+		}
+	}
+
+	if (!Proxy) {
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.OverrideLevel = World->PersistentLevel;
+		Proxy = World->SpawnActor<AParkourNavLinkProxy>(SpawnParams);
+	}
+
+	if (MovementSettings) {
+		Proxy->MovementSettings = MovementSettings;
+	}
+
+	FParkourNavLinkSettings Settings = FParkourNavLinkSettings::FromMovementSettings(Proxy->GetMovementSettings());
+	FParse::Value(*Params, TEXT("CellSize="), Settings.Scan.CellSize);
+	FParse::Value(*Params, TEXT("HalfHeight="), Settings.Scan.CapsuleHalfHeight);
+	FParse::Value(*Params, TEXT("Directions="), Settings.Scan.NumDirections);
+
+	const double StartTime = FPlatformTime::Seconds();
+	FParkourNavLinkGenerator Generator(World, Settings);
+	const FBox Bounds = FParkourSurfaceScanner(World, Settings.Scan).ComputeStaticBounds();
+
+	TArray<FParkourNavLink> Links;
+	if (!Bounds.IsValid || !Generator.Generate(Bounds, Links)) {
+		FParkourSurfaceScanner::ReleaseWorld(World);
+		return 1;
+	}
+
+	Proxy->SetLinks(Links);
+
+	int32 NumLinks[3] = {};
+	for (const FParkourNavLink& Link : Links) {
+		++NumLinks[(int32)Link.Traversal];
+	}
+
+	UPackage* Package = World->GetOutermost();
+	const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetMapPackageExtension());
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Standalone;
+	const bool bSaved = UPackage::SavePackage(Package, World, *Filename, SaveArgs);
+	FParkourSurfaceScanner::ReleaseWorld(World);
+
+	if (!bSaved) {
+		UE_LOG(LogTemp, Error, TEXT("Parkour Nav Link Bake: Could not save %s."), *Filename);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Parkour Nav Link Bake: %s, %d wall runs, %d climbs, %d mantles in %.1f s on %d threads."),
+		*Filename, NumLinks[(int32)EParkourTraversal::WallRun], NumLinks[(int32)EParkourTraversal::Climb], NumLinks[(int32)EParkourTraversal::Mantle],
+		FPlatformTime::Seconds() - StartTime, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+
+	return 0;
+}
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourNavLinkEditorSubsystem.h"
+#include "ParkourNavLinkGenerator.h"
+#include "Components/PrimitiveComponent.h"
+#include "Editor.h"
+#include "EngineUtils.h"
+
+// Seconds after the last edit before regenerating, so dragging an actor doesn't regenerate on every frame
+static constexpr float ParkourNavLinkRegenerateDelay = 0.5f;
+
+void UParkourNavLinkEditorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ActorMovedHandle = GEngine->OnActorMoved().AddUObject(this, &UParkourNavLinkEditorSubsystem::OnActorChanged);
+	ActorAddedHandle = GEngine->OnLevelActorAdded().AddUObject(this, &UParkourNavLinkEditorSubsystem::OnActorChanged);
+	ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddUObject(this, &UParkourNavLinkEditorSubsystem::OnActorChanged);
+	BeginMovementHandle = GEditor->OnBeginObjectMovement().AddUObject(this, &UParkourNavLinkEditorSubsystem::OnBeginObjectMovement);
+}
+
+void UParkourNavLinkEditorSubsystem::Deinitialize()
+{
+	if (GEngine) {
+		GEngine->OnActorMoved().Remove(ActorMovedHandle);
+		GEngine->OnLevelActorAdded().Remove(ActorAddedHandle);
+		GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+	}
+	if (GEditor) {
+		GEditor->OnBeginObjectMovement().Remove(BeginMovementHandle);
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(RegenerateHandle);
+	DirtyAreas.Reset();
+
+	Super::Deinitialize();
+}
+
+void UParkourNavLinkEditorSubsystem::OnActorChanged(AActor* Actor)
+{
+	MarkDirty(Actor);
+}
+
+void UParkourNavLinkEditorSubsystem::OnBeginObjectMovement(UObject& Object)
+{
+	// Where it was, OnActorMoved covers where it ends up
+	MarkDirty(Cast<AActor>(&Object));
+}
+
+void UParkourNavLinkEditorSubsystem::MarkDirty(AActor* Actor)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+	if (!World || (World->WorldType != EWorldType::Editor) || Actor->IsA<AParkourNavLinkProxy>()) {
+		return;
+	}
+
+	FBox Bounds(ForceInit);
+	Actor->ForEachComponent<UPrimitiveComponent>(false, [&Bounds](UPrimitiveComponent* Primitive)
+	{
+		if ((Primitive->Mobility == EComponentMobility::Static) && Primitive->IsCollisionEnabled()) {
+			Bounds += Primitive->Bounds.GetBox();
+		}
+	});
+
+	if (!Bounds.IsValid) {
+		return;
+	}
+
+	AParkourNavLinkProxy* Proxy = nullptr;
+	for (TActorIterator<AParkourNavLinkProxy> It(World); It; ++It) {
+		Proxy = *It;
+		break;
+	}
+
+	if (!Proxy) {
+		return;
+	}
+
+	const float Reach = FParkourNavLinkSettings::FromMovementSettings(Proxy->GetMovementSettings()).GetReach();
+	DirtyAreas.Add({ Proxy, Bounds.ExpandBy(Reach) });
+
+	// Restart the delay, the edit isn't finished yet
+	FTSTicker::GetCoreTicker().RemoveTicker(RegenerateHandle);
+	RegenerateHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UParkourNavLinkEditorSubsystem::Regenerate), ParkourNavLinkRegenerateDelay);
+}
+
+bool UParkourNavLinkEditorSubsystem::Regenerate(float DeltaTime)
+{
+	TArray<FDirtyArea> Areas = MoveTemp(DirtyAreas);
+	DirtyAreas.Reset();
+	RegenerateHandle.Reset();
+
+	// Overlapping areas, the old and new place of a short move, are regenerated as one
+	for (int32 Index = 0; Index < Areas.Num(); ++Index) {
+		for (int32 Other = Areas.Num() - 1; Other > Index; --Other) {
+			if ((Areas[Other].Proxy == Areas[Index].Proxy) && Areas[Other].Bounds.Intersect(Areas[Index].Bounds)) {
+				Areas[Index].Bounds += Areas[Other].Bounds;
+				Areas.RemoveAtSwap(Other);
+				Other = Areas.Num();
+			}
+		}
+	}
+
+	for (const FDirtyArea& Area : Areas) {
+		AParkourNavLinkProxy* Proxy = Area.Proxy.Get();
+		if (!Proxy || !Proxy->GetWorld()) {
+			continue;
+		}
+
+		const FParkourNavLinkSettings Settings = FParkourNavLinkSettings::FromMovementSettings(Proxy->GetMovementSettings());
+		const double StartTime = FPlatformTime::Seconds();
+
+		TArray<FParkourNavLink> Links;
+		if (FParkourNavLinkGenerator(Proxy->GetWorld(), Settings).Generate(Area.Bounds, Links)) {
+			Proxy->ReplaceLinks(Area.Bounds, Links);
+			UE_LOG(LogTemp, Verbose, TEXT("Parkour Nav Link Editor Subsystem_Regenerate: %d links in %.0f ms."), Links.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+	}
+
+	// One shot, MarkDirty adds it again on the next edit
+	return false;
+}
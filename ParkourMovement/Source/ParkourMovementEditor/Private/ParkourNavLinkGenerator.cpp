@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourNavLinkGenerator.h"
+#include "ParkourMovementSettings.h"
+#include "ParkourRules.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+
+/************************************************************/
+/*----------------------- Settings -------------------------*/
+/************************************************************/
+
+FParkourNavLinkSettings FParkourNavLinkSettings::FromMovementSettings(const UParkourMovementSettings& MovementSettings)
+{
+	FParkourNavLinkSettings Settings;
+	Settings.Scan.MantleHeight = MovementSettings.MantleHeight;
+
+	// Without a time limit a vertical wall run lasts as long as the wall, cap it at what a second of climbing reaches
+	const float ClimbTime = (MovementSettings.VerticalWallRunTime > 0.0f) ? MovementSettings.VerticalWallRunTime : 1.0f;
+	Settings.MaxClimbHeight = MovementSettings.VerticalWallRunSpeed * ClimbTime;
+
+	// Wall run gravity starts a second in, past that the character is sliding down the wall
+	Settings.MaxWallRunLength = MovementSettings.WallRunSpeed;
+
+	return Settings;
+}
+
+float FParkourNavLinkSettings::GetReach() const
+{
+	return FMath::Max(MaxWallRunLength, MaxClimbHeight + MaxDropHeight) + (Scan.CapsuleRadius * 2.0f) + LinkSpacing;
+}
+
+/************************************************************/
+/*----------------------- Generate -------------------------*/
+/************************************************************/
+
+FParkourNavLinkGenerator::FParkourNavLinkGenerator(UWorld* InWorld, const FParkourNavLinkSettings& InSettings)
+	: World(InWorld)
+	, Settings(InSettings)
+	, QueryParams(NAME_None, false)
+{
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+}
+
+bool FParkourNavLinkGenerator::Generate(const FBox& Bounds, TArray<FParkourNavLink>& OutLinks) const
+{
+	const float CellSize = Settings.Scan.CellSize;
+	const FIntPoint MinColumn(FMath::FloorToInt(Bounds.Min.X / CellSize), FMath::FloorToInt(Bounds.Min.Y / CellSize));
+	const FIntPoint MaxColumn(FMath::FloorToInt(Bounds.Max.X / CellSize), FMath::FloorToInt(Bounds.Max.Y / CellSize));
+	const FIntPoint Size = (MaxColumn - MinColumn) + FIntPoint(1, 1);
+
+	const int64 NumColumns = (int64)Size.X * (int64)Size.Y;
+	if (NumColumns * Settings.Scan.NumDirections > Settings.Scan.MaxSamples) {
+		UE_LOG(LogTemp, Error, TEXT("Parkour Nav Link Generator_Generate: %lld columns is over the limit, use a larger cell size."), NumColumns);
+		return false;
+	}
+
+	// Each column fills its own slot, so the links come out in the same order on every run and the saved level
+	// only changes where the geometry did
+	TArray<TArray<FParkourNavLink>> ColumnLinks;
+	ColumnLinks.SetNum((int32)NumColumns);
+
+	ParallelFor((int32)NumColumns, [&](int32 Column)
+	{
+		const FVector2D XY = (FVector2D(MinColumn.X + (Column % Size.X), MinColumn.Y + (Column / Size.X)) + FVector2D(0.5)) * CellSize;
+		if (!Bounds.IsInsideOrOnXY(FVector(XY, 0.0))) {
+			return;
+		}
+
+		TArray<FVector, TInlineAllocator<8>> Ground;
+		FindGround(XY, Bounds.Max.Z, Bounds.Min.Z, Ground);
+
+		for (const FVector& GroundPoint : Ground) {
+			for (int32 DirectionIndex = 0; DirectionIndex < Settings.Scan.NumDirections; ++DirectionIndex) {
+				const FRotator Facing(0.0f, (360.0f * DirectionIndex) / Settings.Scan.NumDirections, 0.0f);
+				const FVector Forward = Facing.Vector();
+				const FVector Right = FRotationMatrix(Facing).GetUnitAxis(EAxis::Y);
+
+				FindClimb(GroundPoint, Forward, ColumnLinks[Column]);
+				FindWallRuns(GroundPoint, Forward, Right, ColumnLinks[Column]);
+			}
+		}
+	});
+
+	// Neighbouring columns and facings find the same move, keep the first of each
+	TSet<TTuple<EParkourTraversal, FIntVector, FIntVector>> Seen;
+	auto Quantize = [this](const FVector& Point) { return FIntVector(FMath::FloorToInt(Point.X / Settings.LinkSpacing), FMath::FloorToInt(Point.Y / Settings.LinkSpacing), FMath::FloorToInt(Point.Z / Settings.LinkSpacing)); };
+
+	for (const TArray<FParkourNavLink>& Links : ColumnLinks) {
+		for (const FParkourNavLink& Link : Links) {
+			bool bAlreadySeen = false;
+			Seen.Add(MakeTuple(Link.Traversal, Quantize(Link.Start), Quantize(Link.End)), &bAlreadySeen);
+			if (!bAlreadySeen) {
+				OutLinks.Add(Link);
+			}
+		}
+	}
+
+	return true;
+}
+
+/************************************************************/
+/*------------------------ Ground --------------------------*/
+/************************************************************/
+
+void FParkourNavLinkGenerator::FindGround(const FVector2D& XY, float MaxZ, float MinZ, TArray<FVector, TInlineAllocator<8>>& OutGround) const
+{
+	FVector Start(XY, MaxZ);
+	const FVector End(XY, MinZ);
+	FHitResult Hit;
+
+	// Each trace starts just under the last floor, line traces don't hit the inside of what they start in
+	for (int32 Floor = 0; (Floor < 16) && World->LineTraceSingleByChannel(Hit, Start, End, ECC_Pawn, QueryParams); ++Floor) {
+		if ((Hit.ImpactNormal.Z >= Settings.Scan.WalkableFloorZ) && CharacterFits(Hit.ImpactPoint)) {
+			OutGround.Add(Hit.ImpactPoint);
+		}
+
+		Start = Hit.ImpactPoint - FVector(0.0f, 0.0f, 1.0f);
+	}
+}
+
+bool FParkourNavLinkGenerator::FindLanding(const FVector& Location, float Depth, FVector& OutLanding) const
+{
+	FHitResult Hit;
+	if (!World->LineTraceSingleByChannel(Hit, Location, Location - FVector(0.0f, 0.0f, Depth), ECC_Pawn, QueryParams)) {
+		return false;
+	}
+
+	OutLanding = Hit.ImpactPoint;
+	return (Hit.ImpactNormal.Z >= Settings.Scan.WalkableFloorZ) && CharacterFits(Hit.ImpactPoint);
+}
+
+bool FParkourNavLinkGenerator::CharacterFits(const FVector& Ground) const
+{
+	const FVector Location = Ground + FVector(0.0f, 0.0f, Settings.Scan.CapsuleHalfHeight + 2.0f);
+	return !World->OverlapAnyTestByChannel(Location, FQuat::Identity, ECC_Pawn, FCollisionShape::MakeCapsule(Settings.Scan.CapsuleRadius, Settings.Scan.CapsuleHalfHeight), QueryParams);
+}
+
+/************************************************************/
+/*------------------- Climbs And Mantles -------------------*/
+/************************************************************/
+
+void FParkourNavLinkGenerator::FindClimb(const FVector& Ground, const FVector& Forward, TArray<FParkourNavLink>& OutLinks) const
+{
+	const FParkourSurfaceScanSettings& Scan = Settings.Scan;
+	const ECollisionChannel LedgeWallChannel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery3);
+	const ECollisionChannel LedgeFloorChannel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery4);
+	const FVector Standing = Ground + FVector(0.0f, 0.0f, Scan.CapsuleHalfHeight + 2.0f);
+
+	// Climb the wall a cell at a time, running the ForwardTracer sweeps from each height. A ledge in reach
+	// from the ground is a mantle, anything higher needs a vertical wall run to get to.
+	for (float Height = 0.0f; Height <= Settings.MaxClimbHeight; Height += Scan.CellSize) {
+		const FVector Location = Standing + FVector(0.0f, 0.0f, Height);
+		const FVector Feet = ParkourRules::MantleVectorFeet(Location, Scan.CapsuleHalfHeight, Scan.MantleHeight, Forward);
+
+		FHitResult WallHit;
+		const bool bWallHit = World->SweepSingleByChannel(WallHit, Feet, Feet + (Forward * 50.f), FQuat::Identity, LedgeWallChannel, FCollisionShape::MakeCapsule(10.f, 5.f), QueryParams)
+			&& (WallHit.Normal.Z >= -0.1);
+		if (!bWallHit) {
+			return;
+		}
+
+		// Something overhead stops the climb
+		if ((Height > 0.0f) && World->OverlapAnyTestByChannel(Location, FQuat::Identity, ECC_Pawn, FCollisionShape::MakeCapsule(Scan.CapsuleRadius, Scan.CapsuleHalfHeight), QueryParams)) {
+			return;
+		}
+
+		const FVector Eyes = ParkourRules::MantleVectorEyes(Location + FVector(0.0f, 0.0f, Scan.EyeHeight), Forward);
+		FHitResult LedgeHit;
+		if (World->SweepSingleByChannel(LedgeHit, Eyes, Feet, FQuat::Identity, LedgeFloorChannel, FCollisionShape::MakeCapsule(20.f, 10.f), QueryParams)
+			&& (LedgeHit.ImpactNormal.Z >= Scan.WalkableFloorZ) && !LedgeHit.bStartPenetrating) {
+			// The mantle ends with the capsule fully on top of the ledge
+			const FVector Landing = LedgeHit.ImpactPoint + (Forward * Scan.CapsuleRadius);
+			if (!CharacterFits(Landing)) {
+				return;
+			}
+
+			FParkourNavLink& Link = OutLinks.AddDefaulted_GetRef();
+			Link.Traversal = (Height > 0.0f) ? EParkourTraversal::Climb : EParkourTraversal::Mantle;
+			Link.Start = Ground;
+			Link.End = Landing;
+			return;
+		}
+	}
+}
+
+/************************************************************/
+/*----------------------- Wall Runs ------------------------*/
+/************************************************************/
+
+void FParkourNavLinkGenerator::FindWallRuns(const FVector& Ground, const FVector& Forward, const FVector& Right, TArray<FParkourNavLink>& OutLinks) const
+{
+	const FParkourSurfaceScanSettings& Scan = Settings.Scan;
+	const FVector Location = Ground + FVector(0.0f, 0.0f, Scan.CapsuleHalfHeight + 2.0f + Settings.JumpHeight);
+
+	// Jump, then the WallRunMovement side traces
+	FHitResult StartHit;
+	if (World->LineTraceTestByChannel(Ground + FVector(0.0f, 0.0f, Scan.CapsuleHalfHeight), Location, ECC_Pawn, QueryParams)) {
+		return;
+	}
+
+	const FVector WallRunEnds[] = { ParkourRules::WallRunEndRight(Location, Right, Forward), ParkourRules::WallRunEndLeft(Location, Right, Forward) };
+	for (const FVector& End : WallRunEnds) {
+		if (!World->LineTraceSingleByChannel(StartHit, Location, End, ECC_Visibility, QueryParams) || !ParkourRules::IsValidWallRunNormal(StartHit.Normal)) {
+			continue;
+		}
+
+		// Runs along the wall the way the character faces, a wall run that isn't roughly ahead never starts
+		const FVector WallNormal = FVector(StartHit.Normal.X, StartHit.Normal.Y, 0.0f).GetSafeNormal();
+		FVector RunDirection = FVector::CrossProduct(WallNormal, FVector::UpVector);
+		RunDirection *= FMath::Sign(FVector::DotProduct(RunDirection, Forward));
+		if (FVector::DotProduct(RunDirection, Forward) < 0.7f) {
+			continue;
+		}
+
+		// Follow the wall until it ends or the run would
+		const FVector RunStart = FVector(StartHit.ImpactPoint.X, StartHit.ImpactPoint.Y, Location.Z) + (WallNormal * Scan.CapsuleRadius);
+		float Length = 0.0f;
+		FHitResult WallHit;
+		while (Length < Settings.MaxWallRunLength) {
+			const FVector Next = RunStart + (RunDirection * (Length + Scan.CellSize));
+			if (World->LineTraceTestByChannel(RunStart + (RunDirection * Length), Next, ECC_Pawn, QueryParams)
+				|| !World->LineTraceSingleByChannel(WallHit, Next, Next - (WallNormal * (Scan.CapsuleRadius + 40.0f)), ECC_Visibility, QueryParams)
+				|| !ParkourRules::IsValidWallRunNormal(WallHit.Normal)) {
+				break;
+			}
+
+			Length += Scan.CellSize;
+		}
+
+		if (Length < Settings.MinWallRunLength) {
+			continue;
+		}
+
+		// Drops off the end onto the landing
+		FVector Landing;
+		const FVector RunEnd = RunStart + (RunDirection * (Length + Scan.CapsuleRadius));
+		if (!FindLanding(RunEnd, Scan.CapsuleHalfHeight + Settings.JumpHeight + Settings.MaxDropHeight, Landing)) {
+			continue;
+		}
+
+		// Only worth a link where there is no ground along the wall to walk on instead
+		FVector Middle;
+		if (FindLanding(RunStart + (RunDirection * (Length * 0.5f)), Scan.CapsuleHalfHeight + 2.0f + Settings.JumpHeight + Settings.MaxStepHeight, Middle)) {
+			continue;
+		}
+
+		FParkourNavLink& Link = OutLinks.AddDefaulted_GetRef();
+		Link.Traversal = EParkourTraversal::WallRun;
+		Link.Start = Ground;
+		Link.End = Landing;
+	}
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourSurfaceBakeCommandlet.h"
+#include "ParkourSurfaceScanner.h"
+#include "Misc/PackageName.h"
+
+UParkourSurfaceBakeCommandlet::UParkourSurfaceBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParkourSurfaceBakeCommandlet::Main(const FString& Params)
+{
+	FString MapPath;
+	if (!FParse::Value(*Params, TEXT("Map="), MapPath)) {
+		UE_LOG(LogTemp, Error, TEXT("Parkour Surface Bake: Missing -Map=/Game/Path/To/Map."));
+		return 1;
+	}
+
+	FParkourSurfaceScanSettings Settings;
+	FParse::Value(*Params, TEXT("CellSize="), Settings.CellSize);
+	FParse::Value(*Params, TEXT("HalfHeight="), Settings.CapsuleHalfHeight);
+	FParse::Value(*Params, TEXT("EyeHeight="), Settings.EyeHeight);
+	FParse::Value(*Params, TEXT("MantleHeight="), Settings.MantleHeight);
+	FParse::Value(*Params, TEXT("Directions="), Settings.NumDirections);
+
+	UWorld* World = FParkourSurfaceScanner::LoadWorld(MapPath);
+	if (!World) {
+		UE_LOG(LogTemp, Error, TEXT("Parkour Surface Bake: Could not load %s."), *MapPath);
+		return 1;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	FParkourSurfaceScanner Scanner(World, Settings);
+	const FBox Bounds = Scanner.ComputeStaticBounds();
+
+	TArray<FParkourSurfaceScanHit> Hits;
+	if (!Bounds.IsValid || !Scanner.Scan(Bounds, Hits)) {
+		FParkourSurfaceScanner::ReleaseWorld(World);
+		return 1;
+	}
+
+	TArray<FParkourSurfaceCell> Cells;
+	TArray<FParkourSurfacePatch> Patches;
+	FParkourSurfaceScanner::BuildPatches(Hits, Cells, Patches);
+	FParkourSurfaceScanner::ReleaseWorld(World);
+
+	const FString Path = FParkourSurfaceDatabase::GetDatabasePath(FPackageName::GetShortName(MapPath));
+	const int64 FileSize = FParkourSurfaceScanner::WriteDatabase(Path, Settings.CellSize, Bounds, Cells, Patches);
+	if (FileSize < 0) {
+		UE_LOG(LogTemp, Error, TEXT("Parkour Surface Bake: Could not write %s."), *Path);
+		return 1;
+	}
+
+	const double AreaSquareKm = (Bounds.GetSize().X * Bounds.GetSize().Y) / 1.0e10;
+	UE_LOG(LogTemp, Display, TEXT("Parkour Surface Bake: %s, %d hits, %d cells, %d patches, %.1f KB (%.1f KB per km2) in %.1f s on %d threads."),
+		*Path, Hits.Num(), Cells.Num(), Patches.Num(), FileSize / 1024.0, (AreaSquareKm > 0.0) ? (FileSize / 1024.0 / AreaSquareKm) : 0.0,
+		FPlatformTime::Seconds() - StartTime, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+
+	return 0;
+}
@@ -0,0 +1,260 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourSurfaceScanner.h"
+#include "ParkourRules.h"
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/Package.h"
+
+/************************************************************/
+/*------------------------ World ---------------------------*/
+/************************************************************/
+
+FParkourSurfaceScanner::FParkourSurfaceScanner(UWorld* InWorld, const FParkourSurfaceScanSettings& InSettings)
+	: World(InWorld)
+	, Settings(InSettings)
+{
+}
+
+UWorld* FParkourSurfaceScanner::LoadWorld(const FString& MapPath)
+{
+	UPackage* Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+	UWorld* LoadedWorld = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!LoadedWorld) {
+		return nullptr;
+	}
+
+	LoadedWorld->WorldType = EWorldType::Editor;
+	LoadedWorld->AddToRoot();
+
+	if (!LoadedWorld->bIsWorldInitialized) {
+		UWorld::InitializationValues InitValues;
+		InitValues.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreatePhysicsScene(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false);
+
+		LoadedWorld->InitWorld(InitValues);
+	}
+
+	// Registers every component so its collision is in the physics scene
+	LoadedWorld->PersistentLevel->UpdateModelComponents();
+	LoadedWorld->UpdateWorldComponents(true, false);
+	LoadedWorld->LoadSecondaryLevels();
+	return LoadedWorld;
+}
+
+void FParkourSurfaceScanner::ReleaseWorld(UWorld* LoadedWorld)
+{
+	if (LoadedWorld) {
+		LoadedWorld->DestroyWorld(false);
+		LoadedWorld->RemoveFromRoot();
+	}
+}
+
+FBox FParkourSurfaceScanner::ComputeStaticBounds() const
+{
+	FBox Bounds(ForceInit);
+
+	for (ULevel* Level : World->GetLevels()) {
+		for (AActor* Actor : Level->Actors) {
+			if (!Actor) {
+				continue;
+			}
+
+			Actor->ForEachComponent<UPrimitiveComponent>(false, [&Bounds](UPrimitiveComponent* Primitive)
+			{
+				if ((Primitive->Mobility == EComponentMobility::Static) && Primitive->IsCollisionEnabled()) {
+					Bounds += Primitive->Bounds.GetBox();
+				}
+			});
+		}
+	}
+
+	return Bounds;
+}
+
+/************************************************************/
+/*------------------------- Scan ---------------------------*/
+/************************************************************/
+
+bool FParkourSurfaceScanner::Scan(const FBox& Bounds, TArray<FParkourSurfaceScanHit>& OutHits) const
+{
+	const FIntVector MinCell(FMath::FloorToInt(Bounds.Min.X / Settings.CellSize), FMath::FloorToInt(Bounds.Min.Y / Settings.CellSize), FMath::FloorToInt(Bounds.Min.Z / Settings.CellSize));
+	const FIntVector MaxCell(FMath::FloorToInt(Bounds.Max.X / Settings.CellSize), FMath::FloorToInt(Bounds.Max.Y / Settings.CellSize), FMath::FloorToInt(Bounds.Max.Z / Settings.CellSize));
+	const FIntVector Size = (MaxCell - MinCell) + FIntVector(1, 1, 1);
+
+	const int64 NumSamples = (int64)Size.X * (int64)Size.Y * (int64)Size.Z;
+	if (NumSamples > Settings.MaxSamples) {
+		UE_LOG(LogTemp, Error, TEXT("Parkour Surface Scanner_Scan: %lld samples is over the limit of %lld, use a larger cell size."), NumSamples, Settings.MaxSamples);
+		return false;
+	}
+
+	// Chunks are big enough to keep the lock cold, and small enough to balance across cores
+	const int64 SamplesPerChunk = 4096;
+	const int32 NumChunks = (int32)((NumSamples + SamplesPerChunk - 1) / SamplesPerChunk);
+	FCriticalSection HitsLock;
+
+	ParallelFor(NumChunks, [&](int32 Chunk)
+	{
+		TArray<FParkourSurfaceScanHit> ChunkHits;
+
+		const int64 First = (int64)Chunk * SamplesPerChunk;
+		const int64 Last = FMath::Min(First + SamplesPerChunk, NumSamples);
+		for (int64 Sample = First; Sample < Last; ++Sample) {
+			const int32 X = (int32)(Sample % Size.X);
+			const int32 Y = (int32)((Sample / Size.X) % Size.Y);
+			const int32 Z = (int32)(Sample / ((int64)Size.X * Size.Y));
+			ScanSample(MinCell + FIntVector(X, Y, Z), ChunkHits);
+		}
+
+		if (ChunkHits.Num() > 0) {
+			FScopeLock Lock(&HitsLock);
+			OutHits.Append(MoveTemp(ChunkHits));
+		}
+	});
+
+	return true;
+}
+
+void FParkourSurfaceScanner::ScanSample(const FIntVector& Cell, TArray<FParkourSurfaceScanHit>& OutHits) const
+{
+	const FVector Location = (FVector(Cell) + FVector(0.5)) * Settings.CellSize;
+
+	FCollisionQueryParams QueryParams(NAME_None, false);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	// Skip empty space, nothing any probe can reach from here
+	const float Reach = Settings.CapsuleHalfHeight + Settings.EyeHeight + 150.0f;
+	if (!World->OverlapAnyTestByObjectType(Location, FQuat::Identity, FCollisionObjectQueryParams(ECC_WorldStatic), FCollisionShape::MakeSphere(Reach), QueryParams)) {
+		return;
+	}
+
+	// Skip samples inside geometry. Ones where the capsule wouldn't fit stay, a character against a wall probes from there.
+	if (World->OverlapAnyTestByChannel(Location, FQuat::Identity, ECC_Pawn, FCollisionShape::MakeSphere(1.0f), QueryParams)) {
+		return;
+	}
+
+	const ECollisionChannel LedgeWallChannel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery3);
+	const ECollisionChannel LedgeFloorChannel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery4);
+
+	auto AddHit = [&](EParkourSurfaceFlags Kind, const FVector& Direction, const FHitResult& Hit)
+	{
+		FParkourSurfaceScanHit& ScanHit = OutHits.AddDefaulted_GetRef();
+		ScanHit.Cell = FParkourSurfaceDatabase::GetCell(Hit.ImpactPoint, Settings.CellSize);
+		ScanHit.SampleLocation = Location;
+		ScanHit.Direction = Direction;
+		ScanHit.Kind = Kind;
+		ScanHit.Point = Hit.ImpactPoint;
+		ScanHit.Normal = Hit.Normal;
+	};
+
+	for (int32 DirectionIndex = 0; DirectionIndex < Settings.NumDirections; ++DirectionIndex) {
+		const float Yaw = (360.0f * DirectionIndex) / Settings.NumDirections;
+		const FRotator Facing(0.0f, Yaw, 0.0f);
+		const FVector Forward = Facing.Vector();
+		const FVector Right = FRotationMatrix(Facing).GetUnitAxis(EAxis::Y);
+		FHitResult Hit;
+
+		// Wall runs, WallRunEndRight / WallRunEndLeft and IsValidWallRunNormal
+		const FVector WallRunEnds[] = { ParkourRules::WallRunEndRight(Location, Right, Forward), ParkourRules::WallRunEndLeft(Location, Right, Forward) };
+		for (const FVector& End : WallRunEnds) {
+			if (World->LineTraceSingleByChannel(Hit, Location, End, ECC_Visibility, QueryParams) && !Hit.bStartPenetrating && ParkourRules::IsValidWallRunNormal(Hit.Normal)) {
+				AddHit(EParkourSurfaceFlags::WallRunnable, Forward, Hit);
+			}
+		}
+
+		// Climbable walls, ForwardTracer from MantleVectorFeet
+		const FVector Feet = ParkourRules::MantleVectorFeet(Location, Settings.CapsuleHalfHeight, Settings.MantleHeight, Forward);
+		FHitResult WallHit;
+		const bool bWallHit = World->SweepSingleByChannel(WallHit, Feet, Feet + (Forward * 50.f), FQuat::Identity, LedgeWallChannel, FCollisionShape::MakeCapsule(10.f, 5.f), QueryParams)
+			&& !WallHit.bStartPenetrating && (WallHit.Normal.Z >= -0.1);
+		if (bWallHit) {
+			AddHit(EParkourSurfaceFlags::Climbable, Forward, WallHit);
+		}
+
+		// Ledges, the mantle capsule trace from MantleVectorEyes, onto something walkable with a climbable wall under it
+		const FVector Eyes = ParkourRules::MantleVectorEyes(Location + FVector(0.f, 0.f, Settings.EyeHeight), Forward);
+		if (bWallHit && World->SweepSingleByChannel(Hit, Eyes, Feet, FQuat::Identity, LedgeFloorChannel, FCollisionShape::MakeCapsule(20.f, 10.f), QueryParams)
+			&& (Hit.ImpactNormal.Z >= Settings.WalkableFloorZ) && !Hit.bStartPenetrating) {
+			AddHit(EParkourSurfaceFlags::Ledge, Forward, Hit);
+		}
+	}
+}
+
+/************************************************************/
+/*----------------------- Patches --------------------------*/
+/************************************************************/
+
+void FParkourSurfaceScanner::BuildPatches(const TArray<FParkourSurfaceScanHit>& Hits, TArray<FParkourSurfaceCell>& OutCells, TArray<FParkourSurfacePatch>& OutPatches)
+{
+	TMap<uint64, TArray<FParkourSurfacePatch>> PatchesByCell;
+
+	for (const FParkourSurfaceScanHit& Hit : Hits) {
+		TArray<FParkourSurfacePatch>& CellPatches = PatchesByCell.FindOrAdd(FParkourSurfaceDatabase::MakeCellKey(Hit.Cell));
+		const FVector3f Point(Hit.Point);
+		const FVector3f Normal(Hit.Normal);
+
+		// Hits on the same face from other facings become one patch, with every kind it was found as
+		FParkourSurfacePatch* Existing = CellPatches.FindByPredicate([&Point, &Normal](const FParkourSurfacePatch& Patch)
+		{
+			return (FVector3f::DotProduct(Patch.Normal, Normal) > 0.995f) && (FMath::Abs(FVector3f::DotProduct(Point - Patch.Point, Patch.Normal)) < 2.0f);
+		});
+
+		if (Existing) {
+			Existing->Flags |= (uint8)Hit.Kind;
+		}
+		else {
+			FParkourSurfacePatch& Patch = CellPatches.AddDefaulted_GetRef();
+			Patch.Point = Point;
+			Patch.Normal = Normal;
+			Patch.Flags = (uint8)Hit.Kind;
+		}
+	}
+
+	PatchesByCell.KeySort(TLess<uint64>());
+
+	OutCells.Reset(PatchesByCell.Num());
+	OutPatches.Reset();
+	for (const TPair<uint64, TArray<FParkourSurfacePatch>>& Pair : PatchesByCell) {
+		FParkourSurfaceCell& Cell = OutCells.AddDefaulted_GetRef();
+		Cell.Key = Pair.Key;
+		Cell.FirstPatch = OutPatches.Num();
+		Cell.NumPatches = Pair.Value.Num();
+		OutPatches.Append(Pair.Value);
+	}
+}
+
+int64 FParkourSurfaceScanner::WriteDatabase(const FString& Path, float CellSize, const FBox& Bounds, const TArray<FParkourSurfaceCell>& Cells, const TArray<FParkourSurfacePatch>& Patches)
+{
+	// Header, then the sorted cells, then the patches they index
+	FParkourSurfaceFileHeader Header;
+	Header.CellSize = CellSize;
+	Header.NumCells = Cells.Num();
+	Header.NumPatches = Patches.Num();
+	Header.BoundsMin = FVector3f(Bounds.Min);
+	Header.BoundsMax = FVector3f(Bounds.Max);
+	Header.CellsOffset = sizeof(FParkourSurfaceFileHeader);
+	Header.PatchesOffset = Header.CellsOffset + (Cells.Num() * sizeof(FParkourSurfaceCell));
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Writer) {
+		return -1;
+	}
+
+	Writer->Serialize(&Header, sizeof(Header));
+	Writer->Serialize(const_cast<FParkourSurfaceCell*>(Cells.GetData()), Cells.Num() * sizeof(FParkourSurfaceCell));
+	Writer->Serialize(const_cast<FParkourSurfacePatch*>(Patches.GetData()), Patches.Num() * sizeof(FParkourSurfacePatch));
+	const int64 FileSize = Writer->TotalSize();
+	Writer->Close();
+	return FileSize;
+}
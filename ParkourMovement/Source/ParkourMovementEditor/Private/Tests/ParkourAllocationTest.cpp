@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourBenchmarkSubsystem.h"
+#include "ParkourMovementComponent.h"
+#include "Editor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationCommon.h"
+#include "ParkourMovement/ParkourMovement.h"
+#include "ParkourMovement/ParkourMovementCharacter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Runs the benchmark's lane with a parkour component ticked by the test instead of the world, and counts the heap
+// allocations the game thread makes during each of its ticks after the warm up. A tick that changed no mode has to
+// make none, the way the parkour update runs in steady state.
+namespace ParkourAllocationTest
+{
+	const TCHAR* MapName = TEXT("/Game/ThirdPerson/Maps/ThirdPersonMap");
+
+	// Away from the sample level's geometry, at the benchmark course's height
+	const FVector LaneStart(0, -20000, 5000);
+
+	constexpr double StartTimeout = 30.0;
+	constexpr int32 NumWarmUpFrames = 60;
+	constexpr double RunTimeout = 30.0;
+
+	/**
+	 * Passes every call on to the allocator it replaced, counting the allocations made on the game thread while
+	 * counting. Only ever swapped in, never destroyed: another thread may still be inside it when it's swapped out.
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		FMalloc* Inner = nullptr;
+		bool bCounting = false;
+		int32 NumAllocations = 0;
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override { CountAllocation(); return Inner->Malloc(Count, Alignment); }
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override { CountAllocation(); return Inner->TryMalloc(Count, Alignment); }
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override { CountAllocation(); return Inner->Realloc(Original, Count, Alignment); }
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override { CountAllocation(); return Inner->TryRealloc(Original, Count, Alignment); }
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("ParkourAllocationTest"); }
+
+	private:
+		// Other threads never read bCounting
+		FORCEINLINE void CountAllocation()
+		{
+			if (IsInGameThread() && bCounting) {
+				++NumAllocations;
+			}
+		}
+	};
+
+	// Swaps the counting allocator in for its lifetime and counts the game thread's allocations
+	class FScopedAllocationCounter
+	{
+	public:
+		FScopedAllocationCounter()
+		{
+			static FCountingMalloc CountingMalloc;
+			Malloc = &CountingMalloc;
+			Malloc->Inner = GMalloc;
+			Malloc->NumAllocations = 0;
+			GMalloc = Malloc;
+			Malloc->bCounting = true;
+		}
+
+		~FScopedAllocationCounter()
+		{
+			Malloc->bCounting = false;
+			GMalloc = Malloc->Inner;
+		}
+
+		int32 GetNumAllocations() const { return Malloc->NumAllocations; }
+
+	private:
+		FCountingMalloc* Malloc = nullptr;
+	};
+
+	struct FRun
+	{
+		bool bFailed = false;
+		double WaitStart = 0.0;
+		int32 Frame = 0;
+
+		FParkourBenchmarkAgent Agent;
+		TArray<TObjectPtr<AActor>> Blocks;
+
+		int32 NumSteadyTicks = 0;
+		int32 NumAllocatingTicks = 0;
+
+		// A bit per parkour mode a steady tick was measured in
+		uint32 MeasuredModes = 0;
+	};
+
+	static UWorld* FindPIEWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts()) {
+			if ((Context.WorldType == EWorldType::PIE) && Context.World()) {
+				return Context.World();
+			}
+		}
+		return nullptr;
+	}
+
+	static void StartPlaySession(FRun& Run)
+	{
+		FRequestPlaySessionParams Params;
+		Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+		Params.EditorPlaySettings = NewObject<ULevelEditorPlaySettings>();
+		Params.EditorPlaySettings->SetPlayNetMode(EPlayNetMode::PIE_Standalone);
+		Params.EditorPlaySettings->SetPlayNumberOfClients(1);
+
+		GEditor->RequestPlaySession(Params);
+		Run.WaitStart = FPlatformTime::Seconds();
+	}
+
+	// Puts the player on a parkour character at the start of the lane, its component ticked by the test alone
+	static bool SetUp(FAutomationTestBase* Test, FRun& Run)
+	{
+		UWorld* World = FindPIEWorld();
+		APlayerController* Controller = (World && World->HasBegunPlay()) ? World->GetFirstPlayerController() : nullptr;
+		if (!Controller) {
+			if ((FPlatformTime::Seconds() - Run.WaitStart) >= StartTimeout) {
+				Test->AddError(TEXT("Timed out waiting for the play session."));
+				Run.bFailed = true;
+				return true;
+			}
+			return false;
+		}
+
+		UParkourBenchmarkSubsystem::SpawnLaneBlocks(World, LaneStart, true, Run.Blocks);
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		AParkourMovementCharacter* Character = World->SpawnActor<AParkourMovementCharacter>(AParkourMovementCharacter::StaticClass(), LaneStart + FVector(0, 0, 100), FRotator::ZeroRotator, SpawnParams);
+		Controller->Possess(Character);
+		Controller->SetControlRotation(FRotator::ZeroRotator);
+
+		UParkourMovementComponent* Parkour = NewObject<UParkourMovementComponent>(Character, TEXT("ParkourMovement"));
+		Parkour->bUseBatchedUpdate = false;
+		Parkour->bAllowDormancy = false;
+		Parkour->RegisterComponent();
+		Parkour->Initialize(Character);
+		Parkour->SetComponentTickEnabled(false);
+
+		Run.Agent.Character = Character;
+		Run.Agent.Parkour = Parkour;
+		Run.Agent.LaneStart = LaneStart;
+		Run.Agent.bRepeat = false;
+		Run.WaitStart = FPlatformTime::Seconds();
+		return true;
+	}
+
+	// Every frame until the runner finishes or stops: drives it, then ticks its component, counting after the warm up
+	static bool Drive(FAutomationTestBase* Test, FRun& Run)
+	{
+		UParkourMovementComponent* Parkour = Run.Agent.Parkour;
+		if (!Parkour || !Run.Agent.Character) {
+			Test->AddError(TEXT("Lost the character during the run."));
+			Run.bFailed = true;
+			return true;
+		}
+
+		const float DeltaTime = FApp::GetDeltaTime();
+		UParkourBenchmarkSubsystem::DriveAgent(Run.Agent, DeltaTime);
+
+		if (++Run.Frame <= NumWarmUpFrames) {
+			Parkour->TickComponent(DeltaTime, LEVELTICK_All, &Parkour->PrimaryComponentTick);
+		}
+		else {
+			const uint64 StartTransitions = GParkourCounters.ModeTransitions;
+			int32 NumAllocations = 0;
+			{
+				FScopedAllocationCounter Counter;
+				Parkour->TickComponent(DeltaTime, LEVELTICK_All, &Parkour->PrimaryComponentTick);
+				NumAllocations = Counter.GetNumAllocations();
+			}
+
+			// Entering a mode may start a root motion source, only the ticks that stayed in their mode are held to none
+			if (GParkourCounters.ModeTransitions == StartTransitions) {
+				++Run.NumSteadyTicks;
+				Run.MeasuredModes |= 1u << (uint8)Parkour->GetCurrentParkourMode();
+				if (NumAllocations > 0) {
+					++Run.NumAllocatingTicks;
+					Test->AddInfo(FString::Printf(TEXT("Frame %d made %d game thread allocations in parkour mode %d without changing mode."),
+						Run.Frame, NumAllocations, (int32)Parkour->GetCurrentParkourMode()));
+				}
+			}
+		}
+
+		return Run.Agent.bFinished || ((FPlatformTime::Seconds() - Run.WaitStart) >= RunTimeout);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourAllocationTest, "ParkourMovement.Performance.SteadyStateAllocations",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FParkourAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace ParkourAllocationTest;
+
+	if (!AutomationOpenMap(MapName)) {
+		AddError(FString::Printf(TEXT("Couldn't open %s."), MapName));
+		return false;
+	}
+
+	TSharedRef<FRun> Run = MakeShared<FRun>();
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Run]() { StartPlaySession(*Run); return true; }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]() { return Run->bFailed || SetUp(this, *Run); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]() { return Run->bFailed || Drive(this, *Run); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FEndPlayMapCommand());
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]() { return !GEditor->IsPlaySessionInProgress(); }));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]()
+	{
+		if (Run->bFailed) {
+			return true;
+		}
+
+		AddInfo(FString::Printf(TEXT("%d steady ticks measured, %d allocated."), Run->NumSteadyTicks, Run->NumAllocatingTicks));
+		TestTrue(TEXT("Steady ticks are measured"), Run->NumSteadyTicks > 0);
+		TestTrue(TEXT("Steady ticks are measured while sprinting and wall running"),
+			(Run->MeasuredModes & (1u << (uint8)EParkourMovement::Sprint)) && (Run->MeasuredModes & ((1u << (uint8)EParkourMovement::RightWallRun) | (1u << (uint8)EParkourMovement::LeftWallRun))));
+		TestEqual(TEXT("Steady ticks allocate nothing on the game thread"), Run->NumAllocatingTicks, 0);
+		return true;
+	}));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourBenchmarkSubsystem.h"
+#include "Editor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Runs the Parkour.Benchmark course in PIE for every agent count that has a baseline in the project's Benchmarks
+// folder, and fails when a count's costs grow past their baseline's tolerance. The results are written to
+// Saved/Profiling/ParkourBenchmark as they are by the console command, copy them over the baselines to accept them.
+namespace ParkourBenchmarkTest
+{
+	const TCHAR* MapName = TEXT("/Game/ThirdPerson/Maps/ThirdPersonMap");
+
+	const int32 AgentCounts[] = { 1, 64, 512, 2048 };
+	constexpr int32 NumFrames = 600;
+
+	constexpr double StartTimeout = 30.0;
+	constexpr double RunTimeout = 900.0;
+
+	struct FRun
+	{
+		bool bFailed = false;
+		double WaitStart = 0.0;
+		TWeakObjectPtr<UParkourBenchmarkSubsystem> Benchmark;
+	};
+
+	static UWorld* FindPIEWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts()) {
+			if ((Context.WorldType == EWorldType::PIE) && Context.World()) {
+				return Context.World();
+			}
+		}
+		return nullptr;
+	}
+
+	static bool TimedOut(FAutomationTestBase* Test, FRun& Run, double Timeout, const TCHAR* What)
+	{
+		if ((FPlatformTime::Seconds() - Run.WaitStart) < Timeout) {
+			return false;
+		}
+
+		Test->AddError(FString::Printf(TEXT("Timed out waiting for %s."), What));
+		Run.bFailed = true;
+		return true;
+	}
+
+	static void StartPlaySession(FRun& Run)
+	{
+		FRequestPlaySessionParams Params;
+		Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+		Params.EditorPlaySettings = NewObject<ULevelEditorPlaySettings>();
+		Params.EditorPlaySettings->SetPlayNetMode(EPlayNetMode::PIE_Standalone);
+		Params.EditorPlaySettings->SetPlayNumberOfClients(1);
+
+		GEditor->RequestPlaySession(Params);
+		Run.WaitStart = FPlatformTime::Seconds();
+	}
+
+	static bool StartBenchmark(FAutomationTestBase* Test, FRun& Run)
+	{
+		UWorld* World = FindPIEWorld();
+		UParkourBenchmarkSubsystem* Benchmark = (World && World->HasBegunPlay()) ? World->GetSubsystem<UParkourBenchmarkSubsystem>() : nullptr;
+		if (!Benchmark) {
+			return TimedOut(Test, Run, StartTimeout, TEXT("the play session"));
+		}
+
+		Benchmark->StartBenchmark(TArray<int32>(AgentCounts, UE_ARRAY_COUNT(AgentCounts)), NumFrames, EParkourBenchmarkPath::Component);
+		Run.Benchmark = Benchmark;
+		Run.WaitStart = FPlatformTime::Seconds();
+		return true;
+	}
+
+	static bool WaitForBenchmark(FAutomationTestBase* Test, FRun& Run)
+	{
+		if (!Run.Benchmark.IsValid()) {
+			Test->AddError(TEXT("Lost the benchmark's world during the run."));
+			Run.bFailed = true;
+			return true;
+		}
+
+		if (Run.Benchmark->IsRunning()) {
+			return TimedOut(Test, Run, RunTimeout, TEXT("the benchmark"));
+		}
+
+		for (const FParkourBenchmarkResult& Result : Run.Benchmark->GetResults()) {
+			Test->AddInfo(FString::Printf(TEXT("%d agents: game thread %.2f ms (p99 %.2f), parkour %.3f ms (p99 %.3f), %.1f queries per frame, %.1f transitions per second."),
+				Result.NumAgents, Result.MeanGameThreadMs, Result.P99GameThreadMs, Result.MeanParkourMs, Result.P99ParkourMs, Result.QueriesPerFrame, Result.TransitionsPerSecond));
+		}
+
+		Test->TestEqual(TEXT("Every agent count is measured"), Run.Benchmark->GetResults().Num(), (int32)UE_ARRAY_COUNT(AgentCounts));
+		for (const int32 NumAgents : Run.Benchmark->GetMissingBaselines()) {
+			Test->AddError(FString::Printf(TEXT("No baseline Benchmarks/ParkourBenchmark_%d.json to compare %d agents against."), NumAgents, NumAgents));
+		}
+		for (const FString& Failure : Run.Benchmark->GetBaselineFailures()) {
+			Test->AddError(FString::Printf(TEXT("Over baseline, %s"), *Failure));
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourBenchmarkTest, "ParkourMovement.Performance.Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FParkourBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace ParkourBenchmarkTest;
+
+	if (!AutomationOpenMap(MapName)) {
+		AddError(FString::Printf(TEXT("Couldn't open %s."), MapName));
+		return false;
+	}
+
+	TSharedRef<FRun> Run = MakeShared<FRun>();
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Run]() { StartPlaySession(*Run); return true; }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]() { return Run->bFailed || StartBenchmark(this, *Run); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]() { return Run->bFailed || WaitForBenchmark(this, *Run); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FEndPlayMapCommand());
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]() { return !GEditor->IsPlaySessionInProgress(); }));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,241 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourBenchmarkSubsystem.h"
+#include "ParkourCharacterMovementComponent.h"
+#include "ParkourMovementComponent.h"
+#include "Editor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationCommon.h"
+#include "ParkourMovement/ParkourMovementCharacter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Runs the benchmark's lane once on a listen server's client, over a lagged connection, without and then with
+// bPredictParkour. Predicted, the client's presses have to reach the server and take it through the same modes, and
+// the run can't take more corrections than the unpredicted one, whose server never sees a parkour press.
+namespace ParkourNetPredictionTest
+{
+	const TCHAR* MapName = TEXT("/Game/ThirdPerson/Maps/ThirdPersonMap");
+
+	// Away from the sample level's geometry, at the benchmark course's height
+	const FVector LaneStart(0, -20000, 5000);
+
+	// Each way, on the client and the server
+	constexpr int32 LatencyMs = 50;
+
+	constexpr double StartTimeout = 30.0;
+	constexpr double SettleSeconds = 1.0;
+	constexpr double RunTimeout = 30.0;
+
+	struct FRun
+	{
+		bool bPredict = false;
+		bool bFailed = false;
+		double WaitStart = 0.0;
+
+		TWeakObjectPtr<UParkourMovementComponent> ServerParkour;
+		FParkourBenchmarkAgent Agent;
+		TArray<TObjectPtr<AActor>> Blocks;
+
+		int32 StartCorrections = 0;
+		int64 StartCorrectionBits = 0;
+		int32 Corrections = 0;
+		int64 CorrectionBits = 0;
+
+		// A bit per parkour mode each side was in during the run
+		uint32 ServerModes = 0;
+		uint32 ClientModes = 0;
+	};
+
+	static UWorld* FindPIEWorld(ENetMode NetMode)
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts()) {
+			UWorld* World = Context.World();
+			if ((Context.WorldType == EWorldType::PIE) && World && (World->GetNetMode() == NetMode)) {
+				return World;
+			}
+		}
+		return nullptr;
+	}
+
+	static UParkourMovementComponent* AddParkour(ACharacter* Character, bool bPredict)
+	{
+		if (UParkourCharacterMovementComponent* Movement = Cast<UParkourCharacterMovementComponent>(Character->GetCharacterMovement())) {
+			Movement->bPredictParkour = bPredict;
+		}
+
+		// Each side adds its own, as the benchmark does, and nothing of it replicates
+		UParkourMovementComponent* Parkour = NewObject<UParkourMovementComponent>(Character, TEXT("ParkourMovement"));
+		Parkour->SetIsReplicated(false);
+		Parkour->RegisterComponent();
+		Parkour->Initialize(Character);
+		return Parkour;
+	}
+
+	static bool TimedOut(FAutomationTestBase* Test, FRun& Run, double Timeout, const TCHAR* What)
+	{
+		if ((FPlatformTime::Seconds() - Run.WaitStart) < Timeout) {
+			return false;
+		}
+
+		Test->AddError(FString::Printf(TEXT("Timed out waiting for %s (bPredictParkour %d)."), What, Run.bPredict ? 1 : 0));
+		Run.bFailed = true;
+		return true;
+	}
+
+	static void StartPlaySession(FRun& Run)
+	{
+		FRequestPlaySessionParams Params;
+		Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+		Params.EditorPlaySettings = NewObject<ULevelEditorPlaySettings>();
+		Params.EditorPlaySettings->SetPlayNetMode(EPlayNetMode::PIE_ListenServer);
+		Params.EditorPlaySettings->SetPlayNumberOfClients(2);
+		Params.EditorPlaySettings->bLaunchSeparateServer = false;
+		Params.EditorPlaySettings->SetRunUnderOneProcess(true);
+
+		FLevelEditorPlayNetworkEmulationSettings& Emulation = Params.EditorPlaySettings->NetworkEmulationSettings;
+		Emulation.bIsNetworkEmulationEnabled = true;
+		Emulation.EmulationTarget = NetworkEmulationTarget::Any;
+		Emulation.OutPackets.MinLatency = LatencyMs;
+		Emulation.OutPackets.MaxLatency = LatencyMs;
+		Emulation.InPackets.MinLatency = LatencyMs;
+		Emulation.InPackets.MaxLatency = LatencyMs;
+
+		GEditor->RequestPlaySession(Params);
+		Run.WaitStart = FPlatformTime::Seconds();
+	}
+
+	// Server side, once the client has joined: puts its player on a parkour character at the start of the lane
+	static bool SetUpServer(FAutomationTestBase* Test, FRun& Run)
+	{
+		UWorld* World = FindPIEWorld(NM_ListenServer);
+		APlayerController* RemoteController = nullptr;
+		if (World) {
+			for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It) {
+				if (It->IsValid() && !(*It)->IsLocalController()) {
+					RemoteController = It->Get();
+				}
+			}
+		}
+
+		if (!RemoteController) {
+			return TimedOut(Test, Run, StartTimeout, TEXT("the client to join"));
+		}
+
+		UParkourBenchmarkSubsystem::SpawnLaneBlocks(World, LaneStart, true, Run.Blocks);
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		AParkourMovementCharacter* Character = World->SpawnActor<AParkourMovementCharacter>(AParkourMovementCharacter::StaticClass(), LaneStart + FVector(0, 0, 100), FRotator::ZeroRotator, SpawnParams);
+		RemoteController->Possess(Character);
+		RemoteController->ClientSetRotation(FRotator::ZeroRotator);
+
+		Run.ServerParkour = AddParkour(Character, Run.bPredict);
+		Run.WaitStart = FPlatformTime::Seconds();
+		return true;
+	}
+
+	// Client side, once the character has arrived: builds the same lane and gets the script ready
+	static bool SetUpClient(FAutomationTestBase* Test, FRun& Run)
+	{
+		UWorld* World = FindPIEWorld(NM_Client);
+		APlayerController* Controller = World ? World->GetFirstPlayerController() : nullptr;
+		ACharacter* Character = Controller ? Cast<AParkourMovementCharacter>(Controller->GetPawn()) : nullptr;
+		if (!Character) {
+			return TimedOut(Test, Run, StartTimeout, TEXT("the client's parkour character"));
+		}
+
+		UParkourBenchmarkSubsystem::SpawnLaneBlocks(World, LaneStart, true, Run.Blocks);
+
+		Run.Agent.Character = Character;
+		Run.Agent.Parkour = AddParkour(Character, Run.bPredict);
+		Run.Agent.LaneStart = LaneStart;
+		Run.Agent.bRepeat = false;
+		Run.WaitStart = FPlatformTime::Seconds();
+		return true;
+	}
+
+	// Client side, every frame until the runner finishes or stops. The corrections of the spawn and the first landing
+	// aren't counted.
+	static bool DriveClient(FAutomationTestBase* Test, FRun& Run)
+	{
+		const UParkourCharacterMovementComponent* Movement = Run.Agent.Character ? Cast<UParkourCharacterMovementComponent>(Run.Agent.Character->GetCharacterMovement()) : nullptr;
+		if (!Movement || !Run.ServerParkour.IsValid()) {
+			Test->AddError(TEXT("Lost a character during the run."));
+			Run.bFailed = true;
+			return true;
+		}
+
+		const double Elapsed = FPlatformTime::Seconds() - Run.WaitStart;
+		if (Elapsed < SettleSeconds) {
+			Run.StartCorrections = Movement->GetNumCorrections();
+			Run.StartCorrectionBits = Movement->GetParkourCorrectionBits();
+			return false;
+		}
+
+		UParkourBenchmarkSubsystem::DriveAgent(Run.Agent, FApp::GetDeltaTime());
+		Run.ClientModes |= 1u << (uint8)Run.Agent.Parkour->GetCurrentParkourMode();
+		Run.ServerModes |= 1u << (uint8)Run.ServerParkour->GetCurrentParkourMode();
+
+		if (!Run.Agent.bFinished && (Elapsed < (SettleSeconds + RunTimeout))) {
+			return false;
+		}
+
+		Run.Corrections = Movement->GetNumCorrections() - Run.StartCorrections;
+		Run.CorrectionBits = Movement->GetParkourCorrectionBits() - Run.StartCorrectionBits;
+		Test->AddInfo(FString::Printf(TEXT("bPredictParkour %d: %d corrections, %lld bits of parkour correction data, finished the lane %d."),
+			Run.bPredict ? 1 : 0, Run.Corrections, Run.CorrectionBits, (Run.Agent.Stage == EParkourBenchmarkStage::Finish) ? 1 : 0));
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourNetPredictionTest, "ParkourMovement.Network.Prediction",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FParkourNetPredictionTest::RunTest(const FString& Parameters)
+{
+	using namespace ParkourNetPredictionTest;
+
+	if (!AutomationOpenMap(MapName)) {
+		AddError(FString::Printf(TEXT("Couldn't open %s."), MapName));
+		return false;
+	}
+
+	TSharedRef<FRun> Unpredicted = MakeShared<FRun>();
+	TSharedRef<FRun> Predicted = MakeShared<FRun>();
+	Predicted->bPredict = true;
+
+	for (const TSharedRef<FRun>& Run : { Unpredicted, Predicted }) {
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Run]() { StartPlaySession(*Run); return true; }));
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]() { return Run->bFailed || SetUpServer(this, *Run); }));
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]() { return Run->bFailed || SetUpClient(this, *Run); }));
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]() { return Run->bFailed || DriveClient(this, *Run); }));
+		ADD_LATENT_AUTOMATION_COMMAND(FEndPlayMapCommand());
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]() { return !GEditor->IsPlaySessionInProgress(); }));
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Unpredicted, Predicted]()
+	{
+		if (Unpredicted->bFailed || Predicted->bFailed) {
+			return true;
+		}
+
+		TestTrue(TEXT("The predicted runner finishes the lane"), Predicted->Agent.Stage == EParkourBenchmarkStage::Finish);
+		TestTrue(TEXT("The server sprints and slides from the client's presses"),
+			(Predicted->ServerModes & (1u << (uint8)EParkourMovement::Sprint)) && (Predicted->ServerModes & (1u << (uint8)EParkourMovement::Slide)));
+		TestEqual(TEXT("The server goes through the client's parkour modes"), (int32)Predicted->ServerModes, (int32)Predicted->ClientModes);
+		TestTrue(FString::Printf(TEXT("Predicted corrections (%d) are no more than unpredicted (%d)"), Predicted->Corrections, Unpredicted->Corrections),
+			Predicted->Corrections <= Unpredicted->Corrections);
+		return true;
+	}));
+
+	return true;
+}
+
+#endif
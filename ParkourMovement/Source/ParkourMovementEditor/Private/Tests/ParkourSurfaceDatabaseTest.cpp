@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParkourSurfaceDatabase.h"
+#include "ParkourSurfaceScanner.h"
+#include "ParkourRules.h"
+#include "Editor.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Bakes the sample level, then makes the parkour probes from random places and facings near its geometry, including
+// right against walls, and checks the database accepts what the live traces and the component's rules accept.
+namespace ParkourSurfaceDatabaseTest
+{
+	const TCHAR* MapName = TEXT("/Game/ThirdPerson/Maps/ThirdPersonMap");
+
+	constexpr int32 NumSamples = 4000;
+	constexpr int32 Seed = 0x5EED;
+
+	// Hit or miss has to agree this often, and agreeing hits have to land this close
+	constexpr double MinAgreement = 0.95;
+	constexpr double MaxImpactDistance = 10.0;
+
+	struct FProbeStats
+	{
+		const TCHAR* Name = nullptr;
+		int32 NumProbes = 0;
+		int32 NumAgreed = 0;
+		int32 NumBothHit = 0;
+		int32 NumClose = 0;
+		int32 NumLiveHits = 0;
+	};
+
+	// What the live trace answers once the probe's rule is applied, the way the component reads it
+	struct FLiveProbe
+	{
+		bool bAccepted = false;
+		FVector ImpactPoint = FVector::ZeroVector;
+	};
+
+	static void Compare(const FParkourSurfaceDatabase& Database, const FVector& Start, const FVector& End, float Radius, EParkourSurfaceFlags Flags, const FLiveProbe& Live, FProbeStats& Stats)
+	{
+		if (!Database.Contains(Start, End)) {
+			return;
+		}
+
+		FHitResult DatabaseHit;
+		const bool bDatabaseHit = Database.Sweep(Start, End, Radius, Flags, DatabaseHit);
+
+		++Stats.NumProbes;
+		Stats.NumLiveHits += Live.bAccepted ? 1 : 0;
+		if (bDatabaseHit == Live.bAccepted) {
+			++Stats.NumAgreed;
+		}
+		if (bDatabaseHit && Live.bAccepted) {
+			++Stats.NumBothHit;
+			Stats.NumClose += (FVector::Dist(DatabaseHit.ImpactPoint, Live.ImpactPoint) <= MaxImpactDistance) ? 1 : 0;
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParkourSurfaceDatabaseTest, "ParkourMovement.SurfaceDatabase.MatchesTraces",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FParkourSurfaceDatabaseTest::RunTest(const FString& Parameters)
+{
+	using namespace ParkourSurfaceDatabaseTest;
+
+	if (!AutomationOpenMap(MapName)) {
+		AddError(FString::Printf(TEXT("Couldn't open %s."), MapName));
+		return false;
+	}
+
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+	const FParkourSurfaceScanSettings Settings;
+	FParkourSurfaceScanner Scanner(World, Settings);
+	const FBox Bounds = Scanner.ComputeStaticBounds();
+
+	TArray<FParkourSurfaceScanHit> Hits;
+	if (!TestTrue(TEXT("The sample level scans"), Bounds.IsValid && Scanner.Scan(Bounds, Hits)) || !TestTrue(TEXT("The scan finds surfaces"), Hits.Num() > 0)) {
+		return false;
+	}
+
+	TArray<FParkourSurfaceCell> Cells;
+	TArray<FParkourSurfacePatch> Patches;
+	FParkourSurfaceScanner::BuildPatches(Hits, Cells, Patches);
+
+	const FString Path = FPaths::AutomationTransientDir() / TEXT("ParkourSurfaceDatabaseTest.pksurf");
+	FParkourSurfaceDatabase Database;
+	if (!TestTrue(TEXT("The bake writes"), FParkourSurfaceScanner::WriteDatabase(Path, Settings.CellSize, Bounds, Cells, Patches) > 0) || !TestTrue(TEXT("The bake loads"), Database.Load(Path))) {
+		return false;
+	}
+
+	FCollisionQueryParams QueryParams(NAME_None, false);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+	const ECollisionChannel LedgeWallChannel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery3);
+	const ECollisionChannel LedgeFloorChannel = UEngineTypes::ConvertToCollisionChannel(TraceTypeQuery4);
+
+	FProbeStats WallRunStats{ TEXT("Wall run") };
+	FProbeStats LedgeWallStats{ TEXT("Ledge wall") };
+	FProbeStats LedgeFloorStats{ TEXT("Ledge floor") };
+
+	// Off the bake's sample points and facings, near geometry the bake found something on
+	FRandomStream Random(Seed);
+	for (int32 Sample = 0; Sample < NumSamples; ++Sample) {
+		const FParkourSurfaceScanHit& Near = Hits[Random.RandHelper(Hits.Num())];
+		const FVector Location = Near.SampleLocation + (Random.GetUnitVector() * Random.FRandRange(0.0f, Settings.CellSize * 0.5f));
+		if (World->OverlapAnyTestByChannel(Location, FQuat::Identity, ECC_Pawn, FCollisionShape::MakeSphere(1.0f), QueryParams)) {
+			continue;
+		}
+
+		const FRotator Facing(0.0f, Random.FRandRange(0.0f, 360.0f), 0.0f);
+		const FVector Forward = Facing.Vector();
+		const FVector Right = FRotationMatrix(Facing).GetUnitAxis(EAxis::Y);
+		FHitResult Hit;
+
+		const FVector WallRunEnds[] = { ParkourRules::WallRunEndRight(Location, Right, Forward), ParkourRules::WallRunEndLeft(Location, Right, Forward) };
+		for (const FVector& End : WallRunEnds) {
+			FLiveProbe Live;
+			Live.bAccepted = World->LineTraceSingleByChannel(Hit, Location, End, ECC_Visibility, QueryParams) && !Hit.bStartPenetrating && ParkourRules::IsValidWallRunNormal(Hit.Normal);
+			Live.ImpactPoint = Hit.ImpactPoint;
+			Compare(Database, Location, End, 0.0f, EParkourSurfaceFlags::WallRunnable, Live, WallRunStats);
+		}
+
+		const FVector Feet = ParkourRules::MantleVectorFeet(Location, Settings.CapsuleHalfHeight, Settings.MantleHeight, Forward);
+		FLiveProbe LiveWall;
+		LiveWall.bAccepted = World->SweepSingleByChannel(Hit, Feet, Feet + (Forward * 50.f), FQuat::Identity, LedgeWallChannel, FCollisionShape::MakeCapsule(10.f, 5.f), QueryParams)
+			&& !Hit.bStartPenetrating && (Hit.Normal.Z >= -0.1);
+		LiveWall.ImpactPoint = Hit.ImpactPoint;
+		Compare(Database, Feet, Feet + (Forward * 50.f), 10.0f, EParkourSurfaceFlags::Climbable, LiveWall, LedgeWallStats);
+
+		const FVector Eyes = ParkourRules::MantleVectorEyes(Location + FVector(0.f, 0.f, Settings.EyeHeight), Forward);
+		FLiveProbe LiveFloor;
+		LiveFloor.bAccepted = LiveWall.bAccepted && World->SweepSingleByChannel(Hit, Eyes, Feet, FQuat::Identity, LedgeFloorChannel, FCollisionShape::MakeCapsule(20.f, 10.f), QueryParams)
+			&& !Hit.bStartPenetrating && (Hit.ImpactNormal.Z >= Settings.WalkableFloorZ);
+		LiveFloor.ImpactPoint = Hit.ImpactPoint;
+		Compare(Database, Eyes, Feet, 20.0f, EParkourSurfaceFlags::Ledge, LiveFloor, LedgeFloorStats);
+	}
+
+	Database.Unload();
+	IFileManager::Get().Delete(*Path);
+
+	for (const FProbeStats* Stats : { &WallRunStats, &LedgeWallStats, &LedgeFloorStats }) {
+		AddInfo(FString::Printf(TEXT("%s: %d probes, %d live hits, %d agreed, %d of %d shared hits within %.0f units."),
+			Stats->Name, Stats->NumProbes, Stats->NumLiveHits, Stats->NumAgreed, Stats->NumClose, Stats->NumBothHit, MaxImpactDistance));
+
+		TestTrue(FString::Printf(TEXT("%s probes run inside the bake"), Stats->Name), Stats->NumProbes > 0);
+		TestTrue(FString::Printf(TEXT("%s hits and misses agree with live traces"), Stats->Name), Stats->NumAgreed >= Stats->NumProbes * MinAgreement);
+		TestTrue(FString::Printf(TEXT("%s hits land where live traces do"), Stats->Name), Stats->NumClose >= Stats->NumBothHit * MinAgreement);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourNavLinkBakeCommandlet.generated.h"
+
+/**
+ * Generates every wall run, climb and mantle link in a level into its AParkourNavLinkProxy, adding one if the
+ * level has none, and saves the level. The editor keeps the links current from then on as the level is edited.
+ *
+ * UnrealEditor-Cmd ParkourMovement.uproject -run=ParkourNavLinkBake -Map=/Game/ThirdPerson/Maps/ThirdPersonMap
+ *     [-Settings=/Game/Path/To/ParkourMovementSettings] [-CellSize=50] [-HalfHeight=96] [-Directions=16]
+ */
+UCLASS()
+class UParkourNavLinkBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UParkourNavLinkBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
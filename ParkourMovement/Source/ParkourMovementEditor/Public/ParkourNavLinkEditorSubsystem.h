@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorSubsystem.h"
+#include "Containers/Ticker.h"
+#include "ParkourNavLinkEditorSubsystem.generated.h"
+
+class AParkourNavLinkProxy;
+
+/**
+ * Keeps a level's parkour nav links current while it's edited. Adding, moving or deleting static geometry
+ * regenerates only the links within reach of where it was and where it is now, a moment after the edit settles.
+ *
+ * Only levels that already have an AParkourNavLinkProxy are kept up, run the ParkourNavLinkBake commandlet or
+ * place one by hand to opt a level in.
+ */
+UCLASS()
+class PARKOURMOVEMENTEDITOR_API UParkourNavLinkEditorSubsystem : public UEditorSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	void OnActorChanged(AActor* Actor);
+	void OnBeginObjectMovement(UObject& Object);
+
+	// Queues the area Actor's static collision affects
+	void MarkDirty(AActor* Actor);
+
+	bool Regenerate(float DeltaTime);
+
+	struct FDirtyArea
+	{
+		TWeakObjectPtr<AParkourNavLinkProxy> Proxy;
+		FBox Bounds;
+	};
+
+	TArray<FDirtyArea> DirtyAreas;
+
+	FTSTicker::FDelegateHandle RegenerateHandle;
+	FDelegateHandle ActorMovedHandle;
+	FDelegateHandle ActorAddedHandle;
+	FDelegateHandle ActorDeletedHandle;
+	FDelegateHandle BeginMovementHandle;
+};
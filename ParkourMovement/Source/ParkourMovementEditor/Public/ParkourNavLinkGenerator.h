@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParkourNavLinks.h"
+#include "ParkourSurfaceScanner.h"
+
+class UParkourMovementSettings;
+
+/* Generator Settings */
+// How far each traversal can take the character. FromMovementSettings derives these from the tuning the
+// component runs with, so links are only generated where the component can actually make the move.
+struct PARKOURMOVEMENTEDITOR_API FParkourNavLinkSettings
+{
+	// Character dimensions and facings, CellSize is also the spacing of the ground columns
+	FParkourSurfaceScanSettings Scan;
+
+	// Highest a vertical wall run gets before it has to grab a ledge
+	float MaxClimbHeight = 300.0f;
+
+	// Longest and shortest wall run worth a link, shorter ones are left to the walking path
+	float MaxWallRunLength = 850.0f;
+	float MinWallRunLength = 200.0f;
+
+	// Jump before a wall run, and the furthest drop onto the landing after it
+	float JumpHeight = 100.0f;
+	float MaxDropHeight = 400.0f;
+
+	// Links with both ends this close to another link's are merged into one
+	float LinkSpacing = 200.0f;
+
+	// Highest the character walks up without a move, a wall run that gains less isn't worth a link
+	float MaxStepHeight = 45.0f;
+
+	static FParkourNavLinkSettings FromMovementSettings(const UParkourMovementSettings& MovementSettings);
+
+	// How far from a piece of geometry it can change links, for expanding edited bounds
+	float GetReach() const;
+};
+
+/**
+ * Finds the wall runs, climbs and mantles a level's static collision allows, as one way links for the navigation.
+ *
+ * Every ground point in the level is tried facing every direction with the component's own rules, the
+ * ForwardTracer wall and ledge sweeps for climbs and mantles, and the WallRunMovement side traces and
+ * ParkourRules::IsValidWallRunNormal for wall runs, which are then followed along the wall to find where they
+ * land. Ground columns are spread across all cores.
+ */
+class PARKOURMOVEMENTEDITOR_API FParkourNavLinkGenerator
+{
+public:
+	FParkourNavLinkGenerator(UWorld* InWorld, const FParkourNavLinkSettings& InSettings);
+
+	// Generates the links starting inside Bounds, returns false if there were too many columns to try
+	bool Generate(const FBox& Bounds, TArray<FParkourNavLink>& OutLinks) const;
+
+	const FParkourNavLinkSettings& GetSettings() const { return Settings; }
+
+private:
+	// Every walkable point a character fits on, top down, in the column at XY between MaxZ and MinZ
+	void FindGround(const FVector2D& XY, float MaxZ, float MinZ, TArray<FVector, TInlineAllocator<8>>& OutGround) const;
+
+	// Highest walkable point a character fits on under Location, within Depth
+	bool FindLanding(const FVector& Location, float Depth, FVector& OutLanding) const;
+
+	bool CharacterFits(const FVector& Ground) const;
+
+	void FindClimb(const FVector& Ground, const FVector& Forward, TArray<FParkourNavLink>& OutLinks) const;
+	void FindWallRuns(const FVector& Ground, const FVector& Forward, const FVector& Right, TArray<FParkourNavLink>& OutLinks) const;
+
+	UWorld* World;
+	FParkourNavLinkSettings Settings;
+	FCollisionQueryParams QueryParams;
+};
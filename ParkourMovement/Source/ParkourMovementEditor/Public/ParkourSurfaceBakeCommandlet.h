@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourSurfaceBakeCommandlet.generated.h"
+
+/**
+ * Bakes a level's wall runnable faces, climbable walls and ledges into the file FParkourSurfaceDatabase maps at runtime.
+ *
+ * UnrealEditor-Cmd ParkourMovement.uproject -run=ParkourSurfaceBake -Map=/Game/ThirdPerson/Maps/ThirdPersonMap
+ *     [-CellSize=50] [-HalfHeight=96] [-EyeHeight=64] [-MantleHeight=44] [-Directions=16]
+ */
+UCLASS()
+class UParkourSurfaceBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UParkourSurfaceBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ParkourSurfaceDatabase.h"
+
+/* Scanner Settings */
+// Dimensions of the character the level is scanned for. These feed the same probe shapes
+// UParkourMovementComponent uses, so they should match the parkour character.
+struct FParkourSurfaceScanSettings
+{
+	float CellSize = 50.0f;
+	float CapsuleRadius = 42.0f;
+	float CapsuleHalfHeight = 96.0f;
+	float EyeHeight = 64.0f;
+	float MantleHeight = 44.0f;
+	float WalkableFloorZ = 0.71f;
+
+	// Facings tried from every sample, spread evenly around the up axis
+	int32 NumDirections = 16;
+
+	// Refuse to scan more samples than this, a sign the cell size is too small for the level
+	int64 MaxSamples = 200000000;
+};
+
+/* Scanner Hits */
+// One thing a probe found from one sample location and facing. Cell is the cell Point is in, the one it's stored in.
+struct FParkourSurfaceScanHit
+{
+	FIntVector Cell = FIntVector::ZeroValue;
+	FVector SampleLocation = FVector::ZeroVector;
+	FVector Direction = FVector::ZeroVector;
+	EParkourSurfaceFlags Kind = EParkourSurfaceFlags::None;
+	FVector Point = FVector::ZeroVector;
+	FVector Normal = FVector::ZeroVector;
+};
+
+/**
+ * Runs the parkour component's geometric rules against a level's static collision.
+ *
+ * Samples every cell near static geometry that isn't inside it, right up against walls where the capsule wouldn't fit
+ * but the probes of a character touching the wall start. Facing every direction, it keeps what the wall run traces
+ * (ParkourRules::IsValidWallRunNormal), ForwardTracer and the mantle capsule trace would have accepted there.
+ * Samples are spread across all cores.
+ */
+class PARKOURMOVEMENTEDITOR_API FParkourSurfaceScanner
+{
+public:
+	FParkourSurfaceScanner(UWorld* InWorld, const FParkourSurfaceScanSettings& InSettings);
+
+	// Loads a level for scanning from a commandlet, with collision registered but nothing ticking
+	static UWorld* LoadWorld(const FString& MapPath);
+	static void ReleaseWorld(UWorld* World);
+
+	// Bounds of every static, colliding primitive in the world
+	FBox ComputeStaticBounds() const;
+
+	// Scans the cells overlapping Bounds, returns false if there were too many to scan
+	bool Scan(const FBox& Bounds, TArray<FParkourSurfaceScanHit>& OutHits) const;
+
+	// Merges hits into per cell patches, in the layout the runtime database reads
+	static void BuildPatches(const TArray<FParkourSurfaceScanHit>& Hits, TArray<FParkourSurfaceCell>& OutCells, TArray<FParkourSurfacePatch>& OutPatches);
+
+	// Writes a database file for FParkourSurfaceDatabase::Load. Returns the file's size, or -1 if it couldn't be written.
+	static int64 WriteDatabase(const FString& Path, float CellSize, const FBox& Bounds, const TArray<FParkourSurfaceCell>& Cells, const TArray<FParkourSurfacePatch>& Patches);
+
+	const FParkourSurfaceScanSettings& GetSettings() const { return Settings; }
+
+private:
+	void ScanSample(const FIntVector& Cell, TArray<FParkourSurfaceScanHit>& OutHits) const;
+
+	UWorld* World;
+	FParkourSurfaceScanSettings Settings;
+};